@@ -64,5 +64,8 @@ int main() {
     int answer = root["answer"].coerce<int>();
     std::cout << "answer (coerced from string) = " << answer << '\n';
 
+    // Dump the whole tree as JSON
+    std::cout << nfrr::config::to_json(root, {.pretty = true}) << '\n';
+
     return 0;
 }
@@ -1,9 +1,11 @@
 #ifndef NFRRCONFIG_IMPL_BASIC_CONFIG_VALUE_HPP
 #define NFRRCONFIG_IMPL_BASIC_CONFIG_VALUE_HPP
 
-#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <expected>
+#include <memory>
+#include <memory_resource>
 #include <string_view>
 #include <type_traits>
 #include <variant>
@@ -12,24 +14,26 @@
 #include "traits.hpp"
 
 namespace nfrr::config {
-// Primary configuration value type parametrized on allocator.
-template <typename Alloc>
+// Primary configuration value type parametrized on allocator and object storage policy.
+template <typename Alloc, typename ObjectPolicy>
 class BasicConfigValue {
   public:
     using allocator_type = Alloc;
-    using storage_traits = ConfigStorageTraits<allocator_type>;
+    using object_policy = ObjectPolicy;
+    using storage_traits = ConfigStorageTraits<allocator_type, object_policy>;
 
     using String = typename storage_traits::string_type;
     using Array = typename storage_traits::array_type;
     using Object = typename storage_traits::object_type;
     using KeyValue = typename storage_traits::key_value_type;
-    using Storage = typename storage_traits::variant_type;
+    using Storage = typename storage_traits::storage_type;
 
     using expected_error = std::expected<void, ConfigError>;
 
   private:
-    Storage storage_;
-    allocator_type allocator_{}; // stored allocator instance if needed
+    using alloc_traits = std::allocator_traits<allocator_type>;
+
+    Storage storage_; // active alternative plus the allocator for nested storage
 
   public:
     // --------- ctors / assignment ---------
@@ -44,12 +48,51 @@ class BasicConfigValue {
      *
      * @param alloc Allocator instance to be stored and propagated to nested containers.
      */
-    explicit BasicConfigValue(const allocator_type& alloc) : storage_{std::monostate{}}, allocator_{alloc} {}
+    explicit BasicConfigValue(const allocator_type& alloc) : storage_{alloc} {}
+
+    /**
+     * @brief Copy constructor.
+     *
+     * The allocator is obtained through select_on_container_copy_construction, exactly
+     * like the standard containers, and all nested storage is deep-copied with it.
+     *
+     * With SharedNodePolicy the copy keeps @p other's allocator instead and shares its payload,
+     * so copying a tree of any size is O(1) (a pmr copy therefore lives on @p other's resource);
+     * writes to either side later copy just the nodes on the written path.
+     */
+    BasicConfigValue(const BasicConfigValue& other) : BasicConfigValue(other, copy_allocator(other)) {}
 
-    BasicConfigValue(const BasicConfigValue&) = default;
     BasicConfigValue(BasicConfigValue&&) noexcept = default;
-    BasicConfigValue& operator=(const BasicConfigValue&) = default;
-    BasicConfigValue& operator=(BasicConfigValue&&) noexcept = default;
+
+    /**
+     * @brief Allocator-extended copy: deep-copies @p other using @p alloc for all nested storage.
+     *
+     * Together with the allocator-extended move this makes BasicConfigValue usable with
+     * uses-allocator construction, so pmr containers of values stay on one memory resource.
+     */
+    BasicConfigValue(const BasicConfigValue& other, const allocator_type& alloc)
+        : storage_{rebuild_storage(other.storage_, alloc)} {}
+
+    /**
+     * @brief Allocator-extended move: moves @p other, re-homing nested storage into @p alloc if needed.
+     */
+    BasicConfigValue(BasicConfigValue&& other, const allocator_type& alloc)
+        : storage_{rebuild_storage(std::move(other.storage_), alloc)} {}
+
+    /**
+     * @brief Copy assignment. Keeps this value's allocator unless the allocator
+     *        propagates on copy assignment, and deep-copies into it.
+     */
+    BasicConfigValue& operator=(const BasicConfigValue& other);
+
+    /**
+     * @brief Move assignment. Steals the storage when allocators compare equal (or
+     *        propagate), otherwise moves element-wise into this value's allocator.
+     *
+     * Safe when @p other is a descendant of *this.
+     */
+    BasicConfigValue& operator=(BasicConfigValue&& other) noexcept(alloc_traits::is_always_equal::value ||
+                                                                   alloc_traits::propagate_on_container_move_assignment::value);
 
     ~BasicConfigValue() = default;
 
@@ -57,7 +100,40 @@ class BasicConfigValue {
      * @brief Get a copy of the stored allocator.
      */
     allocator_type get_allocator() const noexcept {
-        return allocator_;
+        return storage_.get_allocator();
+    }
+
+    // --------- structural sharing (SharedNodePolicy) ---------
+
+    /**
+     * @brief Make this value refer to @p other's string, array or object in O(1), copy-on-write.
+     *
+     * Scalars are copied. If the allocators differ the payload cannot be shared and this is a
+     * plain copy assignment. Safe when @p other is a descendant of *this.
+     */
+    void share(const BasicConfigValue& other)
+        requires config_detail::SharedNodes<ObjectPolicy>
+    {
+        if (get_allocator() == other.get_allocator()) {
+            storage_ = other.storage_.share();
+        }
+        else {
+            *this = other;
+        }
+    }
+
+    /// Address of the shared payload, nullptr for scalars: equal identities imply equal values.
+    [[nodiscard]] const void* shared_identity() const noexcept
+        requires config_detail::SharedNodes<ObjectPolicy>
+    {
+        return storage_.identity();
+    }
+
+    /// Number of values sharing the payload (0 for scalars).
+    [[nodiscard]] std::size_t use_count() const noexcept
+        requires config_detail::SharedNodes<ObjectPolicy>
+    {
+        return storage_.use_count();
     }
 
     // --------- basic kind inspection ---------
@@ -181,6 +257,22 @@ class BasicConfigValue {
         storage_.template emplace<String>(std::move(tmp));
     }
 
+    /**
+     * @brief Set the value to a string referencing @p s without copying, if the string type can.
+     *
+     * With ZeroCopyStringPolicy the value stores a view, so the bytes of @p s must outlive this
+     * value and anything it is moved into (copies own their characters). With std::basic_string
+     * this is set_string().
+     */
+    void set_string_view(std::string_view s) {
+        if constexpr (requires { String::view(s, allocator_rebind_char()); }) {
+            storage_.template emplace<String>(String::view(s, allocator_rebind_char()));
+        }
+        else {
+            set_string(s);
+        }
+    }
+
     /// Set the value to an empty array using the proper allocator.
     void set_array() {
         storage_.template emplace<Array>(allocator_rebind_value());
@@ -237,8 +329,7 @@ class BasicConfigValue {
      * @brief Assign from another BasicConfigValue (copy semantics).
      */
     void assign(const BasicConfigValue& other) {
-        storage_ = other.storage_;
-        allocator_ = other.allocator_;
+        *this = other;
     }
 
     /**
@@ -391,35 +482,77 @@ class BasicConfigValue {
     const BasicConfigValue& at(Key&& key) const;
 
   private:
+    // Allocator of a copy-constructed value: shared payloads need the source's.
+    static allocator_type copy_allocator(const BasicConfigValue& other) {
+        if constexpr (config_detail::SharedNodes<ObjectPolicy>) {
+            return other.get_allocator();
+        }
+        else {
+            return alloc_traits::select_on_container_copy_construction(other.get_allocator());
+        }
+    }
+
     // Helper to obtain the rebinded allocators for the internal containers.
     typename storage_traits::char_allocator allocator_rebind_char() const {
-        return typename storage_traits::char_allocator{allocator_};
+        return typename storage_traits::char_allocator{get_allocator()};
     }
 
     typename storage_traits::value_allocator allocator_rebind_value() const {
-        return typename storage_traits::value_allocator{allocator_};
+        return typename storage_traits::value_allocator{get_allocator()};
     }
 
     typename storage_traits::kv_allocator allocator_rebind_kv() const {
-        return typename storage_traits::kv_allocator{allocator_};
+        return typename storage_traits::kv_allocator{get_allocator()};
     }
 
     // Helper: find key in object (non-const).
-    // Performs O(n) linear search. Efficient for typical config objects with few keys.
+    // Linear search for small objects, hashed side index above the object's threshold.
     static typename Object::iterator find_in_object(Object& obj, std::string_view key) {
-        return std::find_if(obj.begin(), obj.end(), [key](const KeyValue& kv) { return kv.first == key; });
+        return obj.find(key);
     }
 
     // Helper: find key in object (const).
-    // Performs O(n) linear search. Efficient for typical config objects with few keys.
+    // Linear search for small objects, hashed side index above the object's threshold.
     static typename Object::const_iterator find_in_object(const Object& obj, std::string_view key) {
-        return std::find_if(obj.begin(), obj.end(), [key](const KeyValue& kv) { return kv.first == key; });
+        return obj.find(key);
+    }
+
+    // Helper: find a key given as the object's own key type, which may compare faster than its
+    // characters (interned keys of the object's pool compare handles).
+    static typename Object::iterator find_in_object(Object& obj, const typename Object::key_type& key) {
+        return obj.find(key);
     }
 
+    static typename Object::const_iterator find_in_object(const Object& obj, const typename Object::key_type& key) {
+        return obj.find(key);
+    }
+
+    // Helper: copy or move a storage variant, re-creating nested containers with alloc.
+    template <typename StorageRef>
+    static Storage rebuild_storage(StorageRef&& src, const allocator_type& alloc);
+
     // Internal implementation for get/try_get, factorized on const/non-const.
     template <typename T, typename Self>
     static std::expected<T, ConfigError> get_impl(Self& self) noexcept;
 };
+
+namespace config_detail {
+// Append a null element carrying the array's allocator. When default or uses-allocator
+// construction already yields that allocator the element is built in place: moving a null
+// temporary in instead makes GCC 12 report the variant's inactive alternatives as
+// maybe-uninitialized once the decoders are inlined.
+template <typename Array>
+typename Array::reference append_null(Array& elements) {
+    using element_allocator = typename Array::allocator_type;
+    if constexpr (std::allocator_traits<element_allocator>::is_always_equal::value ||
+                  std::is_same_v<element_allocator, std::pmr::polymorphic_allocator<typename Array::value_type>>) {
+        return elements.emplace_back();
+    }
+    else {
+        return elements.emplace_back(typename Array::value_type{elements.get_allocator()});
+    }
+}
+} // namespace config_detail
 } // namespace nfrr::config
 
 #endif
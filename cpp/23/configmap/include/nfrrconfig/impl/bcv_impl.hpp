@@ -6,6 +6,8 @@
 #include <stdexcept>
 #include <string_view>
 #include <type_traits>
+#include <utility>
+#include <variant>
 
 #include "basic_config_value.hpp"
 #include "nfrrconfig/impl/config_details.hpp"
@@ -14,70 +16,170 @@
 namespace nfrr::config {
 // --------- inline definitions for raw as_* accessors ---------
 
-template <typename Alloc>
-inline bool& BasicConfigValue<Alloc>::as_bool() {
-    return std::get<bool>(storage_);
+template <typename Alloc, typename ObjectPolicy>
+inline bool& BasicConfigValue<Alloc, ObjectPolicy>::as_bool() {
+    return storage_.template get<bool>();
 }
 
-template <typename Alloc>
-inline const bool& BasicConfigValue<Alloc>::as_bool() const {
-    return std::get<bool>(storage_);
+template <typename Alloc, typename ObjectPolicy>
+inline const bool& BasicConfigValue<Alloc, ObjectPolicy>::as_bool() const {
+    return storage_.template get<bool>();
 }
 
-template <typename Alloc>
-inline std::int64_t& BasicConfigValue<Alloc>::as_integer() {
-    return std::get<std::int64_t>(storage_);
+template <typename Alloc, typename ObjectPolicy>
+inline std::int64_t& BasicConfigValue<Alloc, ObjectPolicy>::as_integer() {
+    return storage_.template get<std::int64_t>();
 }
 
-template <typename Alloc>
-inline const std::int64_t& BasicConfigValue<Alloc>::as_integer() const {
-    return std::get<std::int64_t>(storage_);
+template <typename Alloc, typename ObjectPolicy>
+inline const std::int64_t& BasicConfigValue<Alloc, ObjectPolicy>::as_integer() const {
+    return storage_.template get<std::int64_t>();
 }
 
-template <typename Alloc>
-inline double& BasicConfigValue<Alloc>::as_floating() {
-    return std::get<double>(storage_);
+template <typename Alloc, typename ObjectPolicy>
+inline double& BasicConfigValue<Alloc, ObjectPolicy>::as_floating() {
+    return storage_.template get<double>();
 }
 
-template <typename Alloc>
-inline const double& BasicConfigValue<Alloc>::as_floating() const {
-    return std::get<double>(storage_);
+template <typename Alloc, typename ObjectPolicy>
+inline const double& BasicConfigValue<Alloc, ObjectPolicy>::as_floating() const {
+    return storage_.template get<double>();
 }
 
-template <typename Alloc>
-inline typename BasicConfigValue<Alloc>::String& BasicConfigValue<Alloc>::as_string() {
-    return std::get<String>(storage_);
+template <typename Alloc, typename ObjectPolicy>
+inline typename BasicConfigValue<Alloc, ObjectPolicy>::String& BasicConfigValue<Alloc, ObjectPolicy>::as_string() {
+    return storage_.template get<String>();
 }
 
-template <typename Alloc>
-inline const typename BasicConfigValue<Alloc>::String& BasicConfigValue<Alloc>::as_string() const {
-    return std::get<String>(storage_);
+template <typename Alloc, typename ObjectPolicy>
+inline const typename BasicConfigValue<Alloc, ObjectPolicy>::String& BasicConfigValue<Alloc, ObjectPolicy>::as_string() const {
+    return storage_.template get<String>();
 }
 
-template <typename Alloc>
-inline typename BasicConfigValue<Alloc>::Array& BasicConfigValue<Alloc>::as_array() {
-    return std::get<Array>(storage_);
+template <typename Alloc, typename ObjectPolicy>
+inline typename BasicConfigValue<Alloc, ObjectPolicy>::Array& BasicConfigValue<Alloc, ObjectPolicy>::as_array() {
+    return storage_.template get<Array>();
 }
 
-template <typename Alloc>
-inline const typename BasicConfigValue<Alloc>::Array& BasicConfigValue<Alloc>::as_array() const {
-    return std::get<Array>(storage_);
+template <typename Alloc, typename ObjectPolicy>
+inline const typename BasicConfigValue<Alloc, ObjectPolicy>::Array& BasicConfigValue<Alloc, ObjectPolicy>::as_array() const {
+    return storage_.template get<Array>();
 }
 
-template <typename Alloc>
-inline typename BasicConfigValue<Alloc>::Object& BasicConfigValue<Alloc>::as_object() {
-    return std::get<Object>(storage_);
+template <typename Alloc, typename ObjectPolicy>
+inline typename BasicConfigValue<Alloc, ObjectPolicy>::Object& BasicConfigValue<Alloc, ObjectPolicy>::as_object() {
+    return storage_.template get<Object>();
 }
 
-template <typename Alloc>
-inline const typename BasicConfigValue<Alloc>::Object& BasicConfigValue<Alloc>::as_object() const {
-    return std::get<Object>(storage_);
+template <typename Alloc, typename ObjectPolicy>
+inline const typename BasicConfigValue<Alloc, ObjectPolicy>::Object& BasicConfigValue<Alloc, ObjectPolicy>::as_object() const {
+    return storage_.template get<Object>();
+}
+
+// --------- allocator-extended construction ---------
+
+template <typename Alloc, typename ObjectPolicy>
+template <typename StorageRef>
+inline typename BasicConfigValue<Alloc, ObjectPolicy>::Storage BasicConfigValue<Alloc, ObjectPolicy>::rebuild_storage(StorageRef&& src,
+                                                                                         const allocator_type& alloc) {
+    // Forward the alternative with the same value category as src (copy for lvalues, move for rvalues).
+    auto fwd = [](auto& alt) -> decltype(auto) {
+        if constexpr (std::is_lvalue_reference_v<StorageRef>) {
+            return static_cast<const std::remove_cvref_t<decltype(alt)>&>(alt);
+        }
+        else {
+            return std::move(alt);
+        }
+    };
+
+    if constexpr (!std::is_lvalue_reference_v<StorageRef>) {
+        if (src.get_allocator() == alloc) {
+            return Storage{std::move(src)}; // nothing to re-home (vector growth relies on this)
+        }
+        if constexpr (config_detail::SharedNodes<ObjectPolicy>) {
+            if (src.use_count() > 1) {
+                // Still shared: moving out would first unshare it, copy the shared payload instead.
+                return rebuild_storage(std::as_const(src), alloc);
+            }
+        }
+    }
+    else if constexpr (config_detail::SharedNodes<ObjectPolicy>) {
+        if (src.get_allocator() == alloc) {
+            return src.share(); // O(1) copy-on-write copy
+        }
+    }
+
+    Storage out{alloc};
+    switch (src.index()) {
+        case 1:
+            out.template emplace<bool>(*src.template get_if<bool>());
+            break;
+        case 2:
+            out.template emplace<std::int64_t>(*src.template get_if<std::int64_t>());
+            break;
+        case 3:
+            out.template emplace<double>(*src.template get_if<double>());
+            break;
+        case 4:
+            out.template emplace<String>(fwd(*src.template get_if<String>()),
+                                         typename storage_traits::char_allocator{alloc});
+            break;
+        case 5:
+            out.template emplace<Array>(fwd(*src.template get_if<Array>()),
+                                        typename storage_traits::value_allocator{alloc});
+            break;
+        case 6:
+            out.template emplace<Object>(fwd(*src.template get_if<Object>()),
+                                         typename storage_traits::kv_allocator{alloc});
+            break;
+        default:
+            break;
+    }
+    return out;
+}
+
+// --------- assignment ---------
+
+template <typename Alloc, typename ObjectPolicy>
+inline BasicConfigValue<Alloc, ObjectPolicy>&
+BasicConfigValue<Alloc, ObjectPolicy>::operator=(const BasicConfigValue& other) {
+    if (this != &other) {
+        // Build the copy first: other may live inside *this. The result carries the allocator.
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+            storage_ = rebuild_storage(other.storage_, other.get_allocator());
+        }
+        else {
+            storage_ = rebuild_storage(other.storage_, get_allocator());
+        }
+    }
+    return *this;
+}
+
+template <typename Alloc, typename ObjectPolicy>
+inline BasicConfigValue<Alloc, ObjectPolicy>&
+BasicConfigValue<Alloc, ObjectPolicy>::operator=(BasicConfigValue&& other) noexcept(
+    alloc_traits::is_always_equal::value || alloc_traits::propagate_on_container_move_assignment::value) {
+    if (this != &other) {
+        if constexpr (alloc_traits::is_always_equal::value ||
+                      alloc_traits::propagate_on_container_move_assignment::value) {
+            // Detach first: other may live inside *this. The allocator (equal, or propagating) moves along.
+            Storage tmp{std::move(other.storage_)};
+            storage_ = std::move(tmp);
+        }
+        else {
+            Storage tmp = (get_allocator() == other.get_allocator())
+                              ? Storage{std::move(other.storage_)}
+                              : rebuild_storage(std::move(other.storage_), get_allocator());
+            storage_ = std::move(tmp);
+        }
+    }
+    return *this;
 }
 
 // --------- object find() implementations ---------
 
-template <typename Alloc>
-inline typename BasicConfigValue<Alloc>::Object::iterator BasicConfigValue<Alloc>::find(std::string_view key) {
+template <typename Alloc, typename ObjectPolicy>
+inline typename BasicConfigValue<Alloc, ObjectPolicy>::Object::iterator BasicConfigValue<Alloc, ObjectPolicy>::find(std::string_view key) {
     if (!is_object()) {
         static Object empty{};
         return empty.end(); // not great, but consistent: "not found"
@@ -85,9 +187,9 @@ inline typename BasicConfigValue<Alloc>::Object::iterator BasicConfigValue<Alloc
     return find_in_object(as_object(), key);
 }
 
-template <typename Alloc>
-inline typename BasicConfigValue<Alloc>::Object::const_iterator
-BasicConfigValue<Alloc>::find(std::string_view key) const {
+template <typename Alloc, typename ObjectPolicy>
+inline typename BasicConfigValue<Alloc, ObjectPolicy>::Object::const_iterator
+BasicConfigValue<Alloc, ObjectPolicy>::find(std::string_view key) const {
     // Error handling: Returns end() iterator from static empty object when not an object.
     // This is a sentinel pattern - calling code should check (it != obj.end()) before use.
     // Alternatives considered:
@@ -103,50 +205,60 @@ BasicConfigValue<Alloc>::find(std::string_view key) const {
 
 // --------- operator[] and at() for object access ---------
 
-template <typename Alloc>
+template <typename Alloc, typename ObjectPolicy>
 template <typename Key>
-inline BasicConfigValue<Alloc>& BasicConfigValue<Alloc>::operator[](Key&& key) {
+inline BasicConfigValue<Alloc, ObjectPolicy>& BasicConfigValue<Alloc, ObjectPolicy>::operator[](Key&& key) {
+    Object& obj = ensure_object();
+    if constexpr (std::is_same_v<std::remove_cvref_t<Key>, typename Object::key_type>) {
+        // A key object (e.g. a pre-interned key) may have a faster lookup than its characters.
+        if (auto it = obj.find(key); it != obj.end()) {
+            return it->second;
+        }
+    }
+
     // Convert key to std::string_view
     std::string_view key_view{std::forward<Key>(key)};
 
-    Object& obj = ensure_object();
-
-    auto it = find_in_object(obj, key_view);
-    if (it == obj.end()) {
-        // Insert new key with null value.
-        String key_str{key_view.begin(), key_view.end(), allocator_rebind_char()};
-        BasicConfigValue<Alloc> val{allocator_};
-        val.set_null();
-        obj.emplace_back(std::move(key_str), std::move(val));
-        return obj.back().second;
-    }
-    return it->second;
+    // Inserts the key with a null value (using the object's allocator) if absent.
+    return obj.try_emplace(key_view).first->second;
 }
 
-template <typename Alloc>
+template <typename Alloc, typename ObjectPolicy>
 template <typename Key>
-inline BasicConfigValue<Alloc>& BasicConfigValue<Alloc>::at(Key&& key) {
+inline BasicConfigValue<Alloc, ObjectPolicy>& BasicConfigValue<Alloc, ObjectPolicy>::at(Key&& key) {
     if (!is_object()) {
         throw std::out_of_range{"Config value is not an object"};
     }
-    std::string_view key_view{std::forward<Key>(key)};
     Object& obj = as_object();
-    auto it = find_in_object(obj, key_view);
+    auto it = [&] {
+        if constexpr (std::is_same_v<std::remove_cvref_t<Key>, typename Object::key_type>) {
+            return find_in_object(obj, static_cast<const typename Object::key_type&>(key));
+        }
+        else {
+            return find_in_object(obj, std::string_view{std::forward<Key>(key)});
+        }
+    }();
     if (it == obj.end()) {
         throw std::out_of_range{"Key not found in object"};
     }
     return it->second;
 }
 
-template <typename Alloc>
+template <typename Alloc, typename ObjectPolicy>
 template <typename Key>
-inline const BasicConfigValue<Alloc>& BasicConfigValue<Alloc>::at(Key&& key) const {
+inline const BasicConfigValue<Alloc, ObjectPolicy>& BasicConfigValue<Alloc, ObjectPolicy>::at(Key&& key) const {
     if (!is_object()) {
         throw std::out_of_range{"Config value is not an object"};
     }
-    std::string_view key_view{std::forward<Key>(key)};
     const Object& obj = as_object();
-    auto it = find_in_object(obj, key_view);
+    auto it = [&] {
+        if constexpr (std::is_same_v<std::remove_cvref_t<Key>, typename Object::key_type>) {
+            return find_in_object(obj, static_cast<const typename Object::key_type&>(key));
+        }
+        else {
+            return find_in_object(obj, std::string_view{std::forward<Key>(key)});
+        }
+    }();
     if (it == obj.end()) {
         throw std::out_of_range{"Key not found in object"};
     }
@@ -155,9 +267,9 @@ inline const BasicConfigValue<Alloc>& BasicConfigValue<Alloc>::at(Key&& key) con
 
 // --------- get_impl: core logic for get/try_get ---------
 
-template <typename Alloc>
+template <typename Alloc, typename ObjectPolicy>
 template <typename T, typename Self>
-inline std::expected<T, ConfigError> BasicConfigValue<Alloc>::get_impl(Self& self) noexcept {
+inline std::expected<T, ConfigError> BasicConfigValue<Alloc, ObjectPolicy>::get_impl(Self& self) noexcept {
     using RawT = std::remove_cvref_t<T>;
     constexpr bool wants_ref = std::is_reference_v<T>;
 
@@ -229,6 +341,12 @@ inline std::expected<T, ConfigError> BasicConfigValue<Alloc>::get_impl(Self& sel
             }
             return self.as_string(); // copy
         }
+        else if constexpr (std::is_same_v<RawT, std::string_view>) {
+            if (!self.is_string()) {
+                return std::unexpected(ConfigError::TypeMismatch);
+            }
+            return std::string_view{self.as_string().data(), self.as_string().size()};
+        }
         else if constexpr (std::is_same_v<RawT, Array>) {
             if (!self.is_array()) {
                 return std::unexpected(ConfigError::TypeMismatch);
@@ -250,9 +368,9 @@ inline std::expected<T, ConfigError> BasicConfigValue<Alloc>::get_impl(Self& sel
 
 // --------- public get / try_get / coerce implementations ---------
 
-template <typename Alloc>
+template <typename Alloc, typename ObjectPolicy>
 template <typename T>
-inline T BasicConfigValue<Alloc>::get() {
+inline T BasicConfigValue<Alloc, ObjectPolicy>::get() {
     static_assert(!std::is_reference_v<T>, "BasicConfigValue::get<T>() does not support reference types; "
                                            "use get_ref<T&>() for reference access.");
 
@@ -263,9 +381,9 @@ inline T BasicConfigValue<Alloc>::get() {
     return *std::move(res);
 }
 
-template <typename Alloc>
+template <typename Alloc, typename ObjectPolicy>
 template <typename T>
-inline T BasicConfigValue<Alloc>::get() const {
+inline T BasicConfigValue<Alloc, ObjectPolicy>::get() const {
     static_assert(!std::is_reference_v<T>, "BasicConfigValue::get<T>() const does not support reference types; "
                                            "use get_ref<const T&>() for reference access.");
 
@@ -276,18 +394,18 @@ inline T BasicConfigValue<Alloc>::get() const {
     return *std::move(res);
 }
 
-template <typename Alloc>
+template <typename Alloc, typename ObjectPolicy>
 template <typename T>
-inline std::expected<T, ConfigError> BasicConfigValue<Alloc>::try_get() const noexcept {
+inline std::expected<T, ConfigError> BasicConfigValue<Alloc, ObjectPolicy>::try_get() const noexcept {
     static_assert(!std::is_reference_v<T>, "BasicConfigValue::try_get<T>() does not support reference types; "
                                            "use get_ref<T&>() or as_*( ) for reference access.");
 
     return get_impl<T>(*this);
 }
 
-template <typename Alloc>
+template <typename Alloc, typename ObjectPolicy>
 template <typename ValueType>
-inline void BasicConfigValue<Alloc>::get_to(ValueType& out) const {
+inline void BasicConfigValue<Alloc, ObjectPolicy>::get_to(ValueType& out) const {
     static_assert(!std::is_reference_v<ValueType>,
                   "BasicConfigValue::get_to<ValueType>() does not support reference types; "
                   "store into a non-reference ValueType.");
@@ -301,9 +419,9 @@ inline void BasicConfigValue<Alloc>::get_to(ValueType& out) const {
 
 // --------- get_ref implementation ---------
 
-template <typename Alloc>
+template <typename Alloc, typename ObjectPolicy>
 template <typename ReferenceType>
-inline ReferenceType BasicConfigValue<Alloc>::get_ref() {
+inline ReferenceType BasicConfigValue<Alloc, ObjectPolicy>::get_ref() {
     static_assert(std::is_reference_v<ReferenceType>,
                   "BasicConfigValue::get_ref requires a reference type, e.g. String&.");
 
@@ -355,9 +473,9 @@ inline ReferenceType BasicConfigValue<Alloc>::get_ref() {
     }
 }
 
-template <typename Alloc>
+template <typename Alloc, typename ObjectPolicy>
 template <typename ReferenceType>
-inline ReferenceType BasicConfigValue<Alloc>::get_ref() const {
+inline ReferenceType BasicConfigValue<Alloc, ObjectPolicy>::get_ref() const {
     static_assert(std::is_reference_v<ReferenceType>,
                   "BasicConfigValue::get_ref requires a reference type, e.g. const String&.");
 
@@ -409,9 +527,9 @@ inline ReferenceType BasicConfigValue<Alloc>::get_ref() const {
     }
 }
 
-template <typename Alloc>
+template <typename Alloc, typename ObjectPolicy>
 template <typename T>
-inline T BasicConfigValue<Alloc>::coerce() const {
+inline T BasicConfigValue<Alloc, ObjectPolicy>::coerce() const {
     using RawT = std::remove_cvref_t<T>;
     // First try normal get<T>().
     if (auto res = get_impl<RawT>(*this)) {
@@ -0,0 +1,632 @@
+#ifndef NFRRCONFIG_IMPL_CBOR_HPP
+#define NFRRCONFIG_IMPL_CBOR_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "basic_config_value.hpp"
+#include "bcv_impl.hpp"
+#include "enums.hpp"
+#include "json_index.hpp"
+#include "json_parse.hpp"
+#include "json_write.hpp"
+#include "mapped_document.hpp"
+
+namespace nfrr::config {
+
+namespace config_detail {
+
+// CBOR major types (RFC 8949, section 3.1) and the simple values / float heads of major type 7.
+enum CborMajor : std::uint8_t {
+    CborUnsigned = 0,
+    CborNegative = 1,
+    CborBytes = 2,
+    CborText = 3,
+    CborArray = 4,
+    CborMap = 5,
+    CborTag = 6,
+    CborSimple = 7
+};
+
+inline constexpr std::uint8_t CBOR_FALSE = 0xF4;
+inline constexpr std::uint8_t CBOR_TRUE = 0xF5;
+inline constexpr std::uint8_t CBOR_NULL = 0xF6;
+inline constexpr std::uint8_t CBOR_FLOAT32 = 0xFA;
+inline constexpr std::uint8_t CBOR_FLOAT64 = 0xFB;
+inline constexpr std::uint8_t CBOR_BREAK = 0xFF;
+inline constexpr std::uint8_t CBOR_INDEFINITE = 31;
+
+/**
+ * @brief Emits one BasicConfigValue as a CBOR data item (preferred serialization: shortest
+ *        argument encodings, definite lengths, floats as binary32 when that is exact).
+ */
+template <JsonSink Sink>
+class CborWriter {
+  public:
+    explicit CborWriter(Sink& sink) noexcept : sink_{&sink} {}
+
+    template <typename Value>
+    void write(const Value& value) {
+        switch (value.kind()) {
+            case ConfigValueKind::Null:
+                put_byte(CBOR_NULL);
+                break;
+            case ConfigValueKind::Boolean:
+                put_byte(value.as_bool() ? CBOR_TRUE : CBOR_FALSE);
+                break;
+            case ConfigValueKind::Integer: {
+                const std::int64_t i = value.as_integer();
+                // Negative n is encoded as -1 - n; ~n computes that without overflow.
+                if (i >= 0) {
+                    put_head(CborUnsigned, static_cast<std::uint64_t>(i));
+                }
+                else {
+                    put_head(CborNegative, ~static_cast<std::uint64_t>(i));
+                }
+                break;
+            }
+            case ConfigValueKind::Floating:
+                put_floating(value.as_floating());
+                break;
+            case ConfigValueKind::String:
+                put_text(std::string_view{value.as_string().data(), value.as_string().size()});
+                break;
+            case ConfigValueKind::Array:
+                put_head(CborArray, value.as_array().size());
+                for (const auto& element : value.as_array()) {
+                    write(element);
+                }
+                break;
+            case ConfigValueKind::Object:
+                put_head(CborMap, value.as_object().size());
+                for (const auto& member : value.as_object()) {
+                    put_text(std::string_view{member.first.data(), member.first.size()});
+                    write(member.second);
+                }
+                break;
+        }
+    }
+
+  private:
+    Sink* sink_;
+
+    void put_byte(std::uint8_t b) {
+        const auto c = static_cast<char>(b);
+        sink_->append(&c, 1);
+    }
+
+    // Initial byte plus big-endian argument, in the shortest form that holds @p arg.
+    void put_head(std::uint8_t major, std::uint64_t arg) {
+        char head[9];
+        std::size_t n = 1;
+        const auto type = static_cast<std::uint8_t>(major << 5);
+        if (arg < 24) {
+            head[0] = static_cast<char>(type | arg);
+        }
+        else {
+            const int bytes = arg <= 0xFF ? 1 : arg <= 0xFFFF ? 2 : arg <= 0xFFFF'FFFF ? 4 : 8;
+            head[0] = static_cast<char>(type | (24 + std::countr_zero(static_cast<unsigned>(bytes))));
+            for (int i = bytes - 1; i >= 0; --i) {
+                head[n++] = static_cast<char>(arg >> (8 * i));
+            }
+        }
+        sink_->append(head, n);
+    }
+
+    void put_text(std::string_view s) {
+        put_head(CborText, s.size());
+        sink_->append(s.data(), s.size());
+    }
+
+    void put_floating(double d) {
+        char buf[9];
+        const auto single = static_cast<float>(d);
+        if (static_cast<double>(single) == d || std::isnan(d)) {
+            buf[0] = static_cast<char>(CBOR_FLOAT32);
+            const auto bits = std::bit_cast<std::uint32_t>(single);
+            for (int i = 0; i < 4; ++i) {
+                buf[1 + i] = static_cast<char>(bits >> (8 * (3 - i)));
+            }
+            sink_->append(buf, 5);
+            return;
+        }
+        buf[0] = static_cast<char>(CBOR_FLOAT64);
+        const auto bits = std::bit_cast<std::uint64_t>(d);
+        for (int i = 0; i < 8; ++i) {
+            buf[1 + i] = static_cast<char>(bits >> (8 * (7 - i)));
+        }
+        sink_->append(buf, 9);
+    }
+};
+
+// Byte source over a complete in-memory buffer.
+class CborBufferSource {
+  public:
+    explicit CborBufferSource(std::string_view bytes) noexcept
+        : begin_{reinterpret_cast<const unsigned char*>(bytes.data())}, cur_{begin_}, end_{begin_ + bytes.size()} {}
+
+    bool ensure(std::size_t n) noexcept {
+        return static_cast<std::size_t>(end_ - cur_) >= n;
+    }
+    [[nodiscard]] const unsigned char* data() const noexcept {
+        return cur_;
+    }
+    void consume(std::size_t n) noexcept {
+        cur_ += n;
+    }
+    [[nodiscard]] std::size_t offset() const noexcept {
+        return static_cast<std::size_t>(cur_ - begin_);
+    }
+    // Upper bound for the number of items still to come (each takes at least a byte).
+    [[nodiscard]] std::size_t remaining_bound() const noexcept {
+        return static_cast<std::size_t>(end_ - cur_);
+    }
+    [[nodiscard]] bool io_failed() const noexcept {
+        return false;
+    }
+
+  private:
+    const unsigned char* begin_;
+    const unsigned char* cur_;
+    const unsigned char* end_;
+};
+
+#if NFRRCONFIG_HAS_MMAP
+// Byte source reading a file descriptor in chunks. Bytes read past the current item stay
+// buffered for the next one, so consecutive items on a socket or pipe decode in sequence.
+class CborFdSource {
+  public:
+    static constexpr std::size_t CHUNK_SIZE = std::size_t{64} << 10;
+
+    explicit CborFdSource(int fd) : fd_{fd} {}
+
+    bool ensure(std::size_t n) {
+        if (len_ - pos_ >= n) {
+            return true;
+        }
+        if (pos_ != 0) {
+            std::memmove(buffer_.data(), buffer_.data() + pos_, len_ - pos_);
+            len_ -= pos_;
+            consumed_ += pos_;
+            pos_ = 0;
+        }
+        while (len_ < n) {
+            // Grow geometrically as bytes actually arrive, not to a length prefix up front.
+            if (len_ == buffer_.size()) {
+                buffer_.resize(std::max(CHUNK_SIZE, std::min(n, buffer_.size() * 2)));
+            }
+            const ssize_t got = ::read(fd_, buffer_.data() + len_, buffer_.size() - len_);
+            if (got > 0) {
+                len_ += static_cast<std::size_t>(got);
+            }
+            else if (got == 0) {
+                return false;
+            }
+            else if (errno != EINTR) {
+                error_ = errno;
+                return false;
+            }
+        }
+        return true;
+    }
+    [[nodiscard]] const unsigned char* data() const noexcept {
+        return buffer_.data() + pos_;
+    }
+    void consume(std::size_t n) noexcept {
+        pos_ += n;
+    }
+    [[nodiscard]] std::size_t offset() const noexcept {
+        return consumed_ + pos_;
+    }
+    // Length prefixes from a stream cannot be checked against the input size up front, so
+    // pre-sizing is capped to keep a bogus prefix from allocating gigabytes.
+    [[nodiscard]] std::size_t remaining_bound() const noexcept {
+        return CHUNK_SIZE;
+    }
+    [[nodiscard]] bool io_failed() const noexcept {
+        return error_ != 0;
+    }
+    [[nodiscard]] int error() const noexcept {
+        return error_;
+    }
+
+  private:
+    int fd_;
+    std::vector<unsigned char> buffer_;
+    std::size_t pos_ = 0;      // next unread byte in buffer_
+    std::size_t len_ = 0;      // bytes of buffer_ filled
+    std::size_t consumed_ = 0; // bytes dropped from the front of buffer_ so far
+    int error_ = 0;
+};
+#endif // NFRRCONFIG_HAS_MMAP
+
+/**
+ * @brief Decodes one CBOR data item from a byte source into a BasicConfigValue.
+ *
+ * Definite-length arrays and maps are reserve()d from their length prefix (capped by what the
+ * input can still hold), indefinite-length items and text chunks are accepted, tags are skipped
+ * (the tagged item is decoded as is), undefined reads as null, half floats are widened.
+ * Byte strings and non-text map keys have no ConfigValueKind and fail with TypeMismatch.
+ * Unsigned / negative integers outside int64 are stored as Floating, as in parse_json().
+ */
+template <typename Value, typename Source>
+class CborDecoder {
+  public:
+    explicit CborDecoder(Source& source) noexcept : src_{&source} {}
+
+    std::expected<void, DocumentError> decode(Value& out) {
+        if (!item(out, 0)) {
+            return std::unexpected(error_);
+        }
+        return {};
+    }
+
+  private:
+    struct Head {
+        std::uint8_t major;
+        std::uint8_t info;
+        std::uint64_t arg; // argument, or 0 for indefinite lengths
+    };
+
+    Source* src_;
+    DocumentError error_{};
+    std::string scratch_; // indefinite-length text assembly
+
+    bool fail(ConfigError code, std::size_t offset) noexcept {
+        error_ = DocumentError{code, offset};
+        return false;
+    }
+
+    bool fail_input() noexcept {
+        return fail(src_->io_failed() ? ConfigError::IoError : ConfigError::UnexpectedEnd, src_->offset());
+    }
+
+    bool read_head(Head& head) {
+        if (!src_->ensure(1)) {
+            return fail_input();
+        }
+        const std::uint8_t initial = src_->data()[0];
+        head.major = initial >> 5;
+        head.info = initial & 0x1F;
+        head.arg = head.info;
+        if (head.info < 24) {
+            src_->consume(1);
+            return true;
+        }
+        if (head.info == CBOR_INDEFINITE) {
+            if (head.major == CborUnsigned || head.major == CborNegative || head.major == CborTag) {
+                return fail(ConfigError::SyntaxError, src_->offset());
+            }
+            head.arg = 0;
+            src_->consume(1);
+            return true;
+        }
+        if (head.info > 27) {
+            return fail(ConfigError::SyntaxError, src_->offset());
+        }
+        const std::size_t bytes = std::size_t{1} << (head.info - 24);
+        if (!src_->ensure(1 + bytes)) {
+            return fail_input();
+        }
+        std::uint64_t arg = 0;
+        for (std::size_t i = 0; i < bytes; ++i) {
+            arg = (arg << 8) | src_->data()[1 + i];
+        }
+        head.arg = arg;
+        src_->consume(1 + bytes);
+        return true;
+    }
+
+    bool at_break() {
+        if (!src_->ensure(1)) {
+            return fail_input();
+        }
+        return src_->data()[0] == CBOR_BREAK;
+    }
+
+    // Text string (definite or chunked) as a view valid until the next source call.
+    bool text(const Head& head, std::string_view& out) {
+        if (head.info != CBOR_INDEFINITE) {
+            if (head.arg > std::numeric_limits<std::size_t>::max() / 2 || !src_->ensure(head.arg)) {
+                return fail_input();
+            }
+            out = {reinterpret_cast<const char*>(src_->data()), static_cast<std::size_t>(head.arg)};
+            src_->consume(static_cast<std::size_t>(head.arg));
+            return true;
+        }
+        scratch_.clear();
+        while (true) {
+            if (!src_->ensure(1)) {
+                return fail_input();
+            }
+            if (src_->data()[0] == CBOR_BREAK) {
+                src_->consume(1);
+                break;
+            }
+            const std::size_t chunk_at = src_->offset();
+            Head chunk{};
+            if (!read_head(chunk)) {
+                return false;
+            }
+            if (chunk.major != CborText || chunk.info == CBOR_INDEFINITE) {
+                return fail(ConfigError::SyntaxError, chunk_at);
+            }
+            std::string_view part;
+            if (!text(chunk, part)) {
+                return false;
+            }
+            scratch_.append(part);
+        }
+        out = scratch_;
+        return true;
+    }
+
+    bool item(Value& out, std::size_t depth) {
+        std::size_t start = src_->offset();
+        Head head{};
+        if (!read_head(head)) {
+            return false;
+        }
+        // Tags are skipped iteratively: a run of them must not cost one stack frame each.
+        while (head.major == CborTag) {
+            start = src_->offset();
+            if (!read_head(head)) {
+                return false;
+            }
+        }
+        switch (head.major) {
+            case CborUnsigned:
+                if (head.arg <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) {
+                    out.set_integer(static_cast<std::int64_t>(head.arg));
+                }
+                else {
+                    out.set_floating(static_cast<double>(head.arg));
+                }
+                return true;
+            case CborNegative:
+                if (head.arg <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) {
+                    out.set_integer(-1 - static_cast<std::int64_t>(head.arg));
+                }
+                else {
+                    out.set_floating(-1.0 - static_cast<double>(head.arg));
+                }
+                return true;
+            case CborBytes:
+                return fail(ConfigError::TypeMismatch, start);
+            case CborText: {
+                std::string_view s;
+                if (!text(head, s)) {
+                    return false;
+                }
+                out.set_string(s);
+                return true;
+            }
+            case CborArray:
+                return array(head, out, depth);
+            case CborMap:
+                return map(head, out, depth);
+            default:
+                return simple(head, out, start);
+        }
+    }
+
+    bool array(const Head& head, Value& out, std::size_t depth) {
+        if (depth >= NFRRCONFIG_JSON_MAX_DEPTH) {
+            return fail(ConfigError::DepthExceeded, src_->offset());
+        }
+        out.set_array();
+        auto& elements = out.as_array();
+        if (head.info != CBOR_INDEFINITE) {
+            elements.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(head.arg, src_->remaining_bound())));
+            for (std::uint64_t i = 0; i < head.arg; ++i) {
+                if (!item(append_null(elements), depth + 1)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        while (true) {
+            if (!src_->ensure(1)) {
+                return fail_input();
+            }
+            if (src_->data()[0] == CBOR_BREAK) {
+                src_->consume(1);
+                return true;
+            }
+            if (!item(append_null(elements), depth + 1)) {
+                return false;
+            }
+        }
+    }
+
+    bool map(const Head& head, Value& out, std::size_t depth) {
+        if (depth >= NFRRCONFIG_JSON_MAX_DEPTH) {
+            return fail(ConfigError::DepthExceeded, src_->offset());
+        }
+        out.set_object();
+        auto& members = out.as_object();
+        const bool indefinite = head.info == CBOR_INDEFINITE;
+        if (!indefinite) {
+            members.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(head.arg, src_->remaining_bound() / 2)));
+        }
+        for (std::uint64_t i = 0; indefinite || i < head.arg; ++i) {
+            if (!src_->ensure(1)) {
+                return fail_input();
+            }
+            if (indefinite && src_->data()[0] == CBOR_BREAK) {
+                src_->consume(1);
+                return true;
+            }
+            const std::size_t key_at = src_->offset();
+            Head key_head{};
+            if (!read_head(key_head)) {
+                return false;
+            }
+            if (key_head.major != CborText) {
+                return fail(ConfigError::TypeMismatch, key_at);
+            }
+            std::string_view key;
+            if (!text(key_head, key)) {
+                return false;
+            }
+            // Duplicate keys keep their first position and take the last value.
+            Value& member = members.try_emplace(key).first->second;
+            if (!item(member, depth + 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool simple(const Head& head, Value& out, std::size_t start) {
+        switch (head.info) {
+            case 20:
+                out.set_bool(false);
+                return true;
+            case 21:
+                out.set_bool(true);
+                return true;
+            case 22: // null
+            case 23: // undefined
+                out.set_null();
+                return true;
+            case 25:
+                out.set_floating(half_to_double(static_cast<std::uint16_t>(head.arg)));
+                return true;
+            case 26:
+                out.set_floating(static_cast<double>(std::bit_cast<float>(static_cast<std::uint32_t>(head.arg))));
+                return true;
+            case 27:
+                out.set_floating(std::bit_cast<double>(head.arg));
+                return true;
+            default:
+                return fail(ConfigError::SyntaxError, start);
+        }
+    }
+
+    static double half_to_double(std::uint16_t half) noexcept {
+        const int exponent = (half >> 10) & 0x1F;
+        const int mantissa = half & 0x3FF;
+        double value = 0;
+        if (exponent == 0) {
+            value = std::ldexp(mantissa, -24);
+        }
+        else if (exponent != 31) {
+            value = std::ldexp(mantissa + 1024, exponent - 25);
+        }
+        else {
+            value = mantissa == 0 ? std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+        }
+        return (half & 0x8000) != 0 ? -value : value;
+    }
+};
+
+} // namespace config_detail
+
+/**
+ * @brief Encode @p value as one CBOR data item (RFC 8949), appending it to @p sink.
+ *
+ * Each ConfigValueKind maps onto one major type: Null / Boolean to simple values, Integer to
+ * major types 0 / 1, Floating to binary32 when that is exact and binary64 otherwise, String
+ * to text strings, Array and Object to definite-length arrays and maps with text keys.
+ */
+template <typename Alloc, typename ObjectPolicy, JsonSink Sink>
+void write_cbor(const BasicConfigValue<Alloc, ObjectPolicy>& value, Sink& sink) {
+    config_detail::CborWriter<Sink> writer{sink};
+    writer.write(value);
+}
+
+/// Encode @p value as CBOR into a new buffer.
+template <typename Alloc, typename ObjectPolicy>
+[[nodiscard]] std::string to_cbor(const BasicConfigValue<Alloc, ObjectPolicy>& value) {
+    std::string out;
+    write_cbor(value, out);
+    return out;
+}
+
+/**
+ * @brief Decode the single CBOR data item in @p bytes.
+ *
+ * Arrays and maps are pre-sized from their length prefixes. Malformed input never throws:
+ * the result carries UnexpectedEnd (truncated), SyntaxError (reserved encodings, trailing
+ * bytes), TypeMismatch (byte strings, non-text keys) or DepthExceeded, with the byte offset.
+ */
+template <typename Alloc = std::allocator<std::byte>, typename ObjectPolicy = DefaultObjectPolicy>
+[[nodiscard]] std::expected<BasicConfigValue<Alloc, ObjectPolicy>, DocumentError>
+parse_cbor(std::string_view bytes, const Alloc& alloc = Alloc{}) {
+    using Value = BasicConfigValue<Alloc, ObjectPolicy>;
+    Value root{alloc};
+    config_detail::CborBufferSource source{bytes};
+    config_detail::CborDecoder<Value, config_detail::CborBufferSource> decoder{source};
+    if (auto ok = decoder.decode(root); !ok) {
+        return std::unexpected(ok.error());
+    }
+    if (source.offset() != bytes.size()) {
+        return std::unexpected(DocumentError{ConfigError::SyntaxError, source.offset()});
+    }
+    return root;
+}
+
+#if NFRRCONFIG_HAS_MMAP
+/**
+ * @brief Reads consecutive CBOR data items from a file descriptor (socket, pipe, file).
+ *
+ * The descriptor is read in 64 KiB chunks; bytes past the current item stay buffered for the
+ * next read(), so a peer can send a sequence of items (RFC 8742 CBOR sequence) on one
+ * connection. The descriptor is not owned.
+ */
+template <typename Alloc = std::allocator<std::byte>, typename ObjectPolicy = DefaultObjectPolicy>
+class CborFdReader {
+  public:
+    using value_type = BasicConfigValue<Alloc, ObjectPolicy>;
+
+    explicit CborFdReader(int fd, const Alloc& alloc = Alloc{}) : source_{fd}, allocator_{alloc} {}
+
+    /**
+     * @brief Decode the next item.
+     *
+     * @return The value, or the decoding error (offsets count from the first byte read).
+     *         End of stream gives UnexpectedEnd, which at_end() tells apart from a truncated
+     *         item; a failed read() gives IoError with errno set.
+     */
+    [[nodiscard]] std::expected<value_type, DocumentError> read() {
+        value_type root{allocator_};
+        config_detail::CborDecoder<value_type, config_detail::CborFdSource> decoder{source_};
+        if (auto ok = decoder.decode(root); !ok) {
+            errno = source_.error();
+            return std::unexpected(ok.error());
+        }
+        return root;
+    }
+
+    /// True if the stream ended cleanly: no buffered bytes and end of file. Blocks until a
+    /// byte arrives or the peer closes.
+    [[nodiscard]] bool at_end() {
+        return !source_.ensure(1) && !source_.io_failed();
+    }
+
+    /// Bytes consumed from the descriptor so far.
+    [[nodiscard]] std::size_t offset() const noexcept {
+        return source_.offset();
+    }
+
+  private:
+    config_detail::CborFdSource source_;
+    Alloc allocator_;
+};
+#endif // NFRRCONFIG_HAS_MMAP
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_CBOR_HPP
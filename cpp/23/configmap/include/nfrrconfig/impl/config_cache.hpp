@@ -0,0 +1,172 @@
+#ifndef NFRRCONFIG_IMPL_CONFIG_CACHE_HPP
+#define NFRRCONFIG_IMPL_CONFIG_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "basic_config_value.hpp"
+#include "bcv_impl.hpp"
+#include "config_path.hpp"
+#include "config_store.hpp"
+#include "enums.hpp"
+
+namespace nfrr::config {
+
+namespace config_detail {
+inline std::size_t next_setting_id() noexcept {
+    static std::atomic<std::size_t> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace config_detail
+
+/**
+ * @brief A typed setting read through ConfigReadCache: compiled path, target type and a
+ *        process-wide number that keys the cached value.
+ *
+ * Create settings once (e.g. as statics) and share them between threads; they are immutable.
+ * Numbers are never reused, and every ConfigReadCache keeps a slot up to the highest number it
+ * has been asked for.
+ *
+ * @tparam T Target type of BasicConfigValue::try_get(). It must own its data: cached values
+ *         outlive the version they were read from, so std::string_view is rejected.
+ */
+template <typename T>
+class CachedSetting {
+    static_assert(!std::is_reference_v<T> && !std::is_same_v<T, std::string_view>,
+                  "CachedSetting<T>: T must be an owning value type");
+
+  public:
+    /// @throws std::invalid_argument if @p path is malformed (see ConfigPath).
+    explicit CachedSetting(std::string_view path) : path_{path}, id_{config_detail::next_setting_id()} {}
+
+    [[nodiscard]] const ConfigPath& path() const noexcept {
+        return path_;
+    }
+
+    [[nodiscard]] std::size_t id() const noexcept {
+        return id_;
+    }
+
+  private:
+    ConfigPath path_;
+    std::size_t id_;
+};
+
+/**
+ * @brief Per-thread memo of typed values read from a ConfigStore.
+ *
+ * Each value is cached under (setting, version of the snapshot it came from). A hit costs one
+ * atomic load of the store's version, an index and a compare: no pin, no tree walk, no
+ * conversion, and no writes to memory shared with other threads. When the store publishes a new
+ * version, every entry becomes stale and is refreshed on its next read, by pinning the new
+ * snapshot and resolving the setting's path again (each entry keeps its own copy of the path,
+ * so the position caches of ConfigPath apply).
+ *
+ * Errors are cached like values. Use one cache per thread, for instance
+ * `thread_local ConfigReadCache cache{store};`; it holds one of the store's reader slots.
+ */
+template <typename Alloc, typename ObjectPolicy = DefaultObjectPolicy>
+class ConfigReadCache {
+  public:
+    using store_type = ConfigStore<Alloc, ObjectPolicy>;
+
+    explicit ConfigReadCache(store_type& store) : store_{&store}, reader_{store.reader()} {}
+
+    ConfigReadCache(const ConfigReadCache&) = delete;
+    ConfigReadCache& operator=(const ConfigReadCache&) = delete;
+
+    /// The value of @p setting in the latest version, or the error reading it gave.
+    template <typename T>
+    [[nodiscard]] std::expected<T, ConfigError> try_get(const CachedSetting<T>& setting) {
+        const std::uint64_t version = store_->version();
+        if (setting.id() < entries_.size() && entries_[setting.id()] != nullptr &&
+            entries_[setting.id()]->version == version) {
+            return static_cast<const Entry<T>&>(*entries_[setting.id()]).value;
+        }
+        return refresh(setting);
+    }
+
+    /**
+     * @brief As try_get(), throwing on errors.
+     *
+     * @throws std::runtime_error if the path is missing or the value does not convert to T.
+     */
+    template <typename T>
+    [[nodiscard]] T get(const CachedSetting<T>& setting) {
+        auto res = try_get(setting);
+        if (!res) {
+            throw std::runtime_error{"ConfigReadCache::get(): path not found, type mismatch or conversion error"};
+        }
+        return *std::move(res);
+    }
+
+    /// The reader slot of this cache, for pinning whole snapshots from the same thread.
+    [[nodiscard]] typename store_type::Reader& reader() noexcept {
+        return reader_;
+    }
+
+    /// Number of reads that had to resolve their setting against a snapshot.
+    [[nodiscard]] std::size_t misses() const noexcept {
+        return misses_;
+    }
+
+    /// Drop every cached value.
+    void clear() noexcept {
+        entries_.clear();
+    }
+
+  private:
+    struct EntryBase {
+        virtual ~EntryBase() = default;
+        std::uint64_t version = 0; // versions start at 1
+    };
+
+    template <typename T>
+    struct Entry : EntryBase {
+        explicit Entry(const ConfigPath& p) : path{p} {}
+
+        ConfigPath path;
+        std::expected<T, ConfigError> value{std::unexpected(ConfigError::None)};
+    };
+
+    store_type* store_;
+    typename store_type::Reader reader_;
+    std::vector<std::unique_ptr<EntryBase>> entries_; // indexed by CachedSetting::id()
+    std::size_t misses_ = 0;
+
+    template <typename T>
+    std::expected<T, ConfigError> refresh(const CachedSetting<T>& setting) {
+        if (setting.id() >= entries_.size()) {
+            entries_.resize(setting.id() + 1);
+        }
+        if (entries_[setting.id()] == nullptr) {
+            entries_[setting.id()] = std::make_unique<Entry<T>>(setting.path());
+        }
+        auto& entry = static_cast<Entry<T>&>(*entries_[setting.id()]);
+        ++misses_;
+
+        const auto pinned = reader_.pin();
+        const auto& root = *pinned;
+        auto target = entry.path.resolve(root);
+        if (target) {
+            entry.value = (*target)->template try_get<T>();
+        }
+        else {
+            entry.value = std::unexpected(target.error());
+        }
+        entry.version = pinned.version();
+        return entry.value;
+    }
+};
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_CONFIG_CACHE_HPP
@@ -0,0 +1,213 @@
+#ifndef NFRRCONFIG_IMPL_CONFIG_DOCUMENT_HPP
+#define NFRRCONFIG_IMPL_CONFIG_DOCUMENT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "basic_config_value.hpp"
+#include "bcv_impl.hpp"
+#include "cbor.hpp"
+#include "config_path.hpp"
+#include "interned_key.hpp"
+#include "json_index.hpp"
+#include "json_parse.hpp"
+#include "msgpack.hpp"
+
+namespace nfrr::config {
+
+/**
+ * @brief A pmr configuration tree together with the monotonic arena it lives in.
+ *
+ * Every node reachable from root() is allocated from the document's arena: the root carries the
+ * arena's allocator, pmr allocators never propagate, so children created through operator[],
+ * set_*() and emplace, and values copied or moved in from elsewhere, are all (re)built on it.
+ * The parse_*() members decode straight into the arena as well. Use make_value() for detached
+ * values that will be moved into the tree later; a default-constructed value would live on the
+ * default resource instead.
+ *
+ * Teardown is O(1) in the number of nodes: since the tree owns nothing but arena memory, neither
+ * the destructor nor reset() runs the node destructors, they just release the arena. An initial
+ * block is requested from the upstream resource once and kept across reset(), so a document
+ * reused for per-request overlays stops touching the upstream resource once it has warmed up.
+ *
+ * With InternedKeyPolicy the arena is fronted by a KeyPool, so each distinct object key is stored
+ * once per document; intern() returns handles for lookups that compare handles. The pool's table
+ * lives in the arena as well and is dropped with it.
+ *
+ * The document is neither copyable nor movable (the tree points at the arena). References into
+ * the tree are invalidated by reset() and by the parse_*() members.
+ *
+ * @note ObjectPolicy containers must allocate only through their allocator, as the built-in
+ *       policies do; anything else would leak when node destructors are skipped. With
+ *       SharedNodePolicy, copies of the tree share its arena and must not outlive reset().
+ */
+template <typename ObjectPolicy = DefaultObjectPolicy>
+class BasicConfigDocument {
+  public:
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+    using value_type = BasicConfigValue<allocator_type, ObjectPolicy>;
+
+    static constexpr std::size_t DEFAULT_INITIAL_SIZE = std::size_t{4} << 10;
+
+    /// True if object keys are interned in a per-document KeyPool.
+    static constexpr bool INTERNED_KEYS = std::is_same_v<typename value_type::Object::key_type, InternedKey>;
+
+    /// Arena whose first block holds @p initial_size bytes, all blocks taken from @p upstream.
+    explicit BasicConfigDocument(std::size_t initial_size = DEFAULT_INITIAL_SIZE,
+                                 std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream_{upstream}, initial_size_{std::max<std::size_t>(initial_size, 1)},
+          initial_{upstream_->allocate(initial_size_, alignof(std::max_align_t))},
+          arena_{initial_, initial_size_, upstream_}, root_{get_allocator()} {}
+
+    /// Arena starting in the caller's @p buffer (not owned); overflow blocks come from @p upstream.
+    BasicConfigDocument(void* buffer, std::size_t size,
+                        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream_{upstream}, arena_{buffer, size, upstream_}, root_{get_allocator()} {}
+
+    BasicConfigDocument(const BasicConfigDocument&) = delete;
+    BasicConfigDocument& operator=(const BasicConfigDocument&) = delete;
+
+    /// Releases the arena without running node destructors, then returns the initial block.
+    ~BasicConfigDocument() {
+        pool_.discard();
+        arena_.release();
+        if (initial_ != nullptr) {
+            upstream_->deallocate(initial_, initial_size_, alignof(std::max_align_t));
+        }
+    }
+
+    /// Drop the whole tree in O(1) and start over with a null root on the rewound arena.
+    void reset() noexcept {
+        pool_.discard();
+        arena_.release();
+        std::construct_at(&root_, get_allocator());
+    }
+
+    [[nodiscard]] value_type& root() noexcept {
+        return root_;
+    }
+
+    [[nodiscard]] const value_type& root() const noexcept {
+        return root_;
+    }
+
+    /// Member @p key of the root, auto-vivified like value_type::operator[].
+    value_type& operator[](std::string_view key) {
+        return root_[key];
+    }
+
+    /// Resolve @p path (ConfigPath syntax), returning nullptr if it is missing or malformed.
+    [[nodiscard]] value_type* find(std::string_view path) {
+        auto compiled = ConfigPath::parse(path);
+        return compiled ? compiled->find(root_) : nullptr;
+    }
+
+    [[nodiscard]] const value_type* find(std::string_view path) const {
+        auto compiled = ConfigPath::parse(path);
+        return compiled ? compiled->find(root_) : nullptr;
+    }
+
+    /**
+     * @brief Resolve @p path (ConfigPath syntax).
+     *
+     * @throws std::out_of_range if the path is malformed or does not exist.
+     */
+    [[nodiscard]] value_type& at(std::string_view path) {
+        if (value_type* found = find(path)) {
+            return *found;
+        }
+        throw std::out_of_range{"BasicConfigDocument::at(): path not found"};
+    }
+
+    [[nodiscard]] const value_type& at(std::string_view path) const {
+        if (const value_type* found = find(path)) {
+            return *found;
+        }
+        throw std::out_of_range{"BasicConfigDocument::at(): path not found"};
+    }
+
+    /// A null value allocated from the arena, for building subtrees outside the root.
+    [[nodiscard]] value_type make_value() const noexcept {
+        return value_type{get_allocator()};
+    }
+
+    /**
+     * @brief reset() and parse @p text (JSON, see parse_json()) into the arena as the new root.
+     *
+     * On failure the document is left reset, with a null root.
+     */
+    std::expected<void, DocumentError> parse_json(std::string_view text) {
+        return load([&] { return nfrr::config::parse_json<allocator_type, ObjectPolicy>(text, get_allocator()); });
+    }
+
+    /// As parse_json(), for one CBOR data item (see parse_cbor()).
+    std::expected<void, DocumentError> parse_cbor(std::string_view bytes) {
+        return load([&] { return nfrr::config::parse_cbor<allocator_type, ObjectPolicy>(bytes, get_allocator()); });
+    }
+
+    /// As parse_json(), for one MessagePack object (see parse_msgpack()).
+    std::expected<void, DocumentError> parse_msgpack(std::string_view bytes) {
+        return load([&] { return nfrr::config::parse_msgpack<allocator_type, ObjectPolicy>(bytes, get_allocator()); });
+    }
+
+    /// A handle for object key @p key in the document's pool; valid until reset() or destruction.
+    [[nodiscard]] InternedKey intern(std::string_view key)
+        requires INTERNED_KEYS
+    {
+        return pool_.intern(key);
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type{resource()};
+    }
+
+    /// The arena (or the KeyPool in front of it); its allocations are freed only by reset() or destruction.
+    [[nodiscard]] std::pmr::memory_resource* resource() const noexcept {
+        if constexpr (INTERNED_KEYS) {
+            return &pool_;
+        }
+        else {
+            return &arena_;
+        }
+    }
+
+  private:
+    std::pmr::memory_resource* upstream_;
+    std::size_t initial_size_ = 0;
+    void* initial_ = nullptr; // owned initial block, null when the caller supplied the buffer
+    mutable std::pmr::monotonic_buffer_resource arena_; // make_value() hands it out from const documents
+
+    // Stand-in for the KeyPool when keys are not interned.
+    struct NoKeyPool {
+        explicit NoKeyPool(std::pmr::memory_resource* /*upstream*/) noexcept {}
+        void discard() noexcept {}
+    };
+    [[no_unique_address]] mutable std::conditional_t<INTERNED_KEYS, KeyPool, NoKeyPool> pool_{&arena_};
+    // Never destroyed: its memory is reclaimed wholesale by arena_.release().
+    union {
+        value_type root_;
+    };
+
+    template <typename Parse>
+    std::expected<void, DocumentError> load(Parse parse) {
+        reset();
+        auto parsed = parse();
+        if (!parsed) {
+            reset(); // reclaim whatever the failed parse allocated
+            return std::unexpected(parsed.error());
+        }
+        root_ = std::move(*parsed); // same arena: steals the tree
+        return {};
+    }
+};
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_CONFIG_DOCUMENT_HPP
@@ -0,0 +1,674 @@
+#ifndef NFRRCONFIG_IMPL_CONFIG_OBJECT_HPP
+#define NFRRCONFIG_IMPL_CONFIG_OBJECT_HPP
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "simd.hpp"
+
+// Number of keys at which an object starts maintaining its hashed side index.
+// Override before including nfrrconfig to tune the switch-over point globally.
+#ifndef NFRRCONFIG_OBJECT_INDEX_THRESHOLD
+#define NFRRCONFIG_OBJECT_INDEX_THRESHOLD 64
+#endif
+
+// Number of keys at which an object starts keeping packed key prefixes for SIMD scans.
+#ifndef NFRRCONFIG_OBJECT_PREFIX_THRESHOLD
+#define NFRRCONFIG_OBJECT_PREFIX_THRESHOLD 8
+#endif
+
+namespace nfrr::config {
+
+/// Lookup strategy currently used by a BasicConfigObject.
+enum class ObjectLookup : std::uint8_t {
+    Linear, ///< Plain scan comparing full keys (small objects).
+    Prefix, ///< SIMD scan over packed key prefixes, full compare on prefix hits.
+    Hashed  ///< Open-addressing hash index from key hashes to positions.
+};
+
+/**
+ * @brief Insertion-ordered object storage with adaptive lookup side structures.
+ *
+ * Entries live in a contiguous std::vector of (key, value) pairs, exactly like a
+ * plain vector-backed object, so iteration is cache friendly and preserves
+ * insertion order. Lookup strategy depends on the key count:
+ *  - below PrefixThreshold: linear scan over the keys;
+ *  - from PrefixThreshold: a packed array with one 64-bit word per key (first
+ *    7 bytes plus length) is scanned several keys at a time with SIMD compares,
+ *    and only prefix hits are compared in full;
+ *  - from IndexThreshold: an open-addressing table mapping key hashes to vector
+ *    positions makes lookups O(1) on average.
+ *
+ * The side structure is a single out-of-line block built with the object's
+ * allocator, so the smallest objects pay one null pointer and no allocation.
+ *
+ * @note Keys must not be modified in place through iterators once the object has
+ *       a side block; call reindex() afterwards if you do.
+ *
+ * @tparam Key             Key string type.
+ * @tparam Mapped          Mapped value type (BasicConfigValue).
+ * @tparam Alloc           Allocator for std::pair<Key, Mapped>.
+ * @tparam IndexThreshold  Key count at which the hashed index is enabled.
+ * @tparam PrefixThreshold Key count at which the packed prefix array is enabled.
+ */
+template <typename Key, typename Mapped, typename Alloc,
+          std::size_t IndexThreshold = NFRRCONFIG_OBJECT_INDEX_THRESHOLD,
+          std::size_t PrefixThreshold = NFRRCONFIG_OBJECT_PREFIX_THRESHOLD>
+class BasicConfigObject {
+  public:
+    using key_type = Key;
+    using mapped_type = Mapped;
+    using value_type = std::pair<Key, Mapped>;
+    using allocator_type = Alloc;
+    using container_type = std::vector<value_type, allocator_type>;
+    using size_type = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+
+    static constexpr std::size_t INDEX_THRESHOLD = IndexThreshold;
+    static constexpr std::size_t PREFIX_THRESHOLD = PrefixThreshold;
+
+  private:
+    // The side block is an array of 64-bit words. Word 0 is a header holding the
+    // capacity (low 32 bits) and the ObjectLookup kind (high 32 bits); words
+    // [1, capacity] hold the payload:
+    //  - Prefix: one packed prefix per entry, at the entry's position;
+    //  - Hashed: open-addressing slots, each (hash << 32) | (position + 1), with
+    //    zero marking an empty slot. Caching the hash means probing rarely
+    //    touches the key strings and growth never rehashes them.
+    using word_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<std::uint64_t>;
+    using word_traits = std::allocator_traits<word_allocator>;
+
+    // Maximum number of entries addressable through 32-bit slot positions.
+    static constexpr std::size_t MAX_INDEXED = std::numeric_limits<std::uint32_t>::max() - 1;
+    // Key bytes stored in a packed prefix; the remaining byte holds the length.
+    static constexpr std::size_t PREFIX_BYTES = 7;
+
+    container_type items_;
+    std::uint64_t* side_ = nullptr;
+
+  public:
+    // --------- ctors / assignment ---------
+
+    BasicConfigObject() = default;
+
+    explicit BasicConfigObject(const allocator_type& alloc) : items_(alloc) {}
+
+    BasicConfigObject(const BasicConfigObject& other) : items_(other.items_) {
+        copy_side_from(other);
+    }
+
+    /// Allocator-extended copy: entries and side block are rebuilt in @p alloc.
+    BasicConfigObject(const BasicConfigObject& other, const allocator_type& alloc) : items_(other.items_, alloc) {
+        copy_side_from(other);
+    }
+
+    BasicConfigObject(BasicConfigObject&& other) noexcept
+        : items_(std::move(other.items_)), side_(std::exchange(other.side_, nullptr)) {}
+
+    /// Allocator-extended move: steals the side block only when allocators compare equal.
+    BasicConfigObject(BasicConfigObject&& other, const allocator_type& alloc) : items_(std::move(other.items_), alloc) {
+        if (items_.get_allocator() == other.items_.get_allocator()) {
+            side_ = std::exchange(other.side_, nullptr);
+        }
+        else {
+            other.release_side();
+            rebuild_side();
+        }
+    }
+
+    BasicConfigObject& operator=(const BasicConfigObject& other) {
+        if (this != &other) {
+            items_ = other.items_;
+            release_side();
+            copy_side_from(other);
+        }
+        return *this;
+    }
+
+    BasicConfigObject& operator=(BasicConfigObject&& other) noexcept(
+        std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value ||
+        std::allocator_traits<allocator_type>::is_always_equal::value) {
+        if (this != &other) {
+            release_side();
+            const bool same_alloc = items_.get_allocator() == other.items_.get_allocator();
+            items_ = std::move(other.items_);
+            if (same_alloc || std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value) {
+                side_ = std::exchange(other.side_, nullptr);
+            }
+            else {
+                other.release_side();
+                rebuild_side();
+            }
+        }
+        return *this;
+    }
+
+    ~BasicConfigObject() {
+        release_side();
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return items_.get_allocator();
+    }
+
+    // --------- iteration (insertion order) ---------
+
+    iterator begin() noexcept {
+        return items_.begin();
+    }
+    const_iterator begin() const noexcept {
+        return items_.begin();
+    }
+    iterator end() noexcept {
+        return items_.end();
+    }
+    const_iterator end() const noexcept {
+        return items_.end();
+    }
+    const_iterator cbegin() const noexcept {
+        return items_.cbegin();
+    }
+    const_iterator cend() const noexcept {
+        return items_.cend();
+    }
+
+    // --------- capacity ---------
+
+    [[nodiscard]] size_type size() const noexcept {
+        return items_.size();
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return items_.empty();
+    }
+    [[nodiscard]] size_type capacity() const noexcept {
+        return items_.capacity();
+    }
+    void reserve(size_type n) {
+        items_.reserve(n);
+    }
+
+    /// Lookup strategy currently in use.
+    [[nodiscard]] ObjectLookup lookup_mode() const noexcept {
+        return side_ == nullptr ? ObjectLookup::Linear : side_kind();
+    }
+
+    /// True when lookups go through the hashed side index.
+    [[nodiscard]] bool indexed() const noexcept {
+        return lookup_mode() == ObjectLookup::Hashed;
+    }
+
+    // --------- positional access ---------
+
+    reference operator[](size_type pos) noexcept {
+        return items_[pos];
+    }
+    const_reference operator[](size_type pos) const noexcept {
+        return items_[pos];
+    }
+    reference front() noexcept {
+        return items_.front();
+    }
+    const_reference front() const noexcept {
+        return items_.front();
+    }
+    reference back() noexcept {
+        return items_.back();
+    }
+    const_reference back() const noexcept {
+        return items_.back();
+    }
+
+    // --------- lookup ---------
+
+    /**
+     * @brief Find the first entry with the given key, or end() if absent.
+     */
+    iterator find(std::string_view key) noexcept {
+        return items_.begin() + static_cast<difference_type>(locate(key));
+    }
+
+    const_iterator find(std::string_view key) const noexcept {
+        return items_.begin() + static_cast<difference_type>(locate(key));
+    }
+
+    /**
+     * @brief Find an entry by a key object.
+     *
+     * A BasicInternedKey interned in the pool this object allocates from is matched by handle
+     * (using its cached hash for the index) without comparing characters; any other key is looked
+     * up by its characters.
+     */
+    template <typename K>
+        requires std::same_as<K, Key>
+    iterator find(const K& key) noexcept {
+        return items_.begin() + static_cast<difference_type>(locate_key(key));
+    }
+
+    template <typename K>
+        requires std::same_as<K, Key>
+    const_iterator find(const K& key) const noexcept {
+        return items_.begin() + static_cast<difference_type>(locate_key(key));
+    }
+
+    [[nodiscard]] bool contains(std::string_view key) const noexcept {
+        return locate(key) != items_.size();
+    }
+
+    // --------- modifiers ---------
+
+    /**
+     * @brief Append @p key with a null value if absent.
+     *
+     * @return Iterator to the entry and whether it was inserted.
+     */
+    std::pair<iterator, bool> try_emplace(std::string_view key) {
+        const size_type pos = locate(key);
+        if (pos != items_.size()) {
+            return {items_.begin() + static_cast<difference_type>(pos), false};
+        }
+        emplace_back(make_key(key), Mapped{typename Mapped::allocator_type{get_allocator()}});
+        return {std::prev(items_.end()), true};
+    }
+
+    /**
+     * @brief Append an already constructed @p key with a null value if absent.
+     *
+     * Lets callers supply a key with a non-default representation (e.g. a BasicConfigString view);
+     * @p key is left untouched if it is already present.
+     */
+    template <typename K>
+        requires std::same_as<K, Key>
+    std::pair<iterator, bool> try_emplace(K&& key) {
+        const size_type pos = locate(std::string_view{key});
+        if (pos != items_.size()) {
+            return {items_.begin() + static_cast<difference_type>(pos), false};
+        }
+        emplace_back(std::move(key), Mapped{typename Mapped::allocator_type{get_allocator()}});
+        return {std::prev(items_.end()), true};
+    }
+
+    /**
+     * @brief Append @p key with @p value if absent; @p value is left untouched otherwise.
+     */
+    template <typename M>
+        requires std::is_constructible_v<Mapped, M&&>
+    std::pair<iterator, bool> try_emplace(std::string_view key, M&& value) {
+        const size_type pos = locate(key);
+        if (pos != items_.size()) {
+            return {items_.begin() + static_cast<difference_type>(pos), false};
+        }
+        emplace_back(make_key(key), std::forward<M>(value));
+        return {std::prev(items_.end()), true};
+    }
+
+    /**
+     * @brief Append @p key with @p value, or assign @p value if the key exists.
+     */
+    template <typename M>
+        requires std::is_constructible_v<Mapped, M&&>
+    std::pair<iterator, bool> insert_or_assign(std::string_view key, M&& value) {
+        const size_type pos = locate(key);
+        if (pos != items_.size()) {
+            items_[pos].second = std::forward<M>(value);
+            return {items_.begin() + static_cast<difference_type>(pos), false};
+        }
+        emplace_back(make_key(key), std::forward<M>(value));
+        return {std::prev(items_.end()), true};
+    }
+
+    /**
+     * @brief Append an entry constructed from @p args. Does not check for duplicates.
+     *
+     * If the side block cannot be grown the entry is removed again and the exception
+     * propagates, so lookups never run past a block sized for fewer entries.
+     */
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        items_.emplace_back(std::forward<Args>(args)...);
+        try {
+            side_appended();
+        }
+        catch (...) {
+            items_.pop_back();
+            throw;
+        }
+        return items_.back();
+    }
+
+    void push_back(const value_type& kv) {
+        emplace_back(kv);
+    }
+
+    void push_back(value_type&& kv) {
+        emplace_back(std::move(kv));
+    }
+
+    iterator insert(const_iterator pos, value_type&& kv) {
+        auto it = items_.insert(pos, std::move(kv));
+        rebuild_side();
+        return it;
+    }
+
+    iterator erase(const_iterator pos) {
+        auto it = items_.erase(pos);
+        rebuild_side();
+        return it;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        auto it = items_.erase(first, last);
+        rebuild_side();
+        return it;
+    }
+
+    /// Remove the entry with the given key; returns the number of entries removed (0 or 1).
+    size_type erase(std::string_view key) {
+        const size_type pos = locate(key);
+        if (pos == items_.size()) {
+            return 0;
+        }
+        erase(items_.begin() + static_cast<difference_type>(pos));
+        return 1;
+    }
+
+    void pop_back() {
+        items_.pop_back();
+        rebuild_side();
+    }
+
+    void clear() noexcept {
+        items_.clear();
+        release_side();
+    }
+
+    void swap(BasicConfigObject& other) noexcept {
+        items_.swap(other.items_);
+        std::swap(side_, other.side_);
+    }
+
+    /**
+     * @brief Rebuild the lookup side block from scratch.
+     *
+     * Only needed after keys were modified in place through iterators.
+     */
+    void reindex() {
+        rebuild_side();
+    }
+
+  private:
+    Key make_key(std::string_view key) const {
+        return Key{key.begin(), key.end(), typename Key::allocator_type{items_.get_allocator()}};
+    }
+
+    static std::uint32_t hash_key(std::string_view key) noexcept {
+        return static_cast<std::uint32_t>(std::hash<std::string_view>{}(key));
+    }
+
+    // Hash of a stored key; interned keys carry it (same function), others are hashed.
+    static std::uint32_t hash_key(const Key& key) noexcept {
+        if constexpr (requires { key.hash(); }) {
+            return key.hash();
+        }
+        else {
+            return hash_key(std::string_view{key});
+        }
+    }
+
+    // Packed prefix: first PREFIX_BYTES key bytes, length (saturated) in the top byte.
+    // Equal words imply equal keys when the key fits entirely in the prefix.
+    static std::uint64_t pack_prefix(std::string_view key) noexcept {
+        std::uint64_t word = 0;
+        if (!key.empty()) {
+            std::memcpy(&word, key.data(), std::min(key.size(), PREFIX_BYTES));
+        }
+        if constexpr (std::endian::native == std::endian::big) {
+            word >>= 8U;
+        }
+        const std::uint64_t len = std::min<std::size_t>(key.size(), 0xFF);
+        return (word & 0x00FF'FFFF'FFFF'FFFFULL) | (len << 56U);
+    }
+
+    static std::uint64_t make_slot(std::uint32_t pos, std::uint32_t hash) noexcept {
+        return (static_cast<std::uint64_t>(hash) << 32U) | (static_cast<std::uint64_t>(pos) + 1);
+    }
+    static std::uint32_t slot_pos(std::uint64_t slot) noexcept {
+        return static_cast<std::uint32_t>(slot) - 1;
+    }
+    static std::uint32_t slot_hash(std::uint64_t slot) noexcept {
+        return static_cast<std::uint32_t>(slot >> 32U);
+    }
+
+    [[nodiscard]] std::size_t side_capacity() const noexcept {
+        return static_cast<std::uint32_t>(side_[0]);
+    }
+    [[nodiscard]] ObjectLookup side_kind() const noexcept {
+        return static_cast<ObjectLookup>(side_[0] >> 32U);
+    }
+
+    // Position of the first entry matching key, or size() if absent.
+    [[nodiscard]] size_type locate(std::string_view key) const noexcept {
+        const size_type n = items_.size();
+        switch (lookup_mode()) {
+            case ObjectLookup::Linear:
+                // Small object: plain linear scan, as cheap as it gets below the thresholds.
+                for (size_type i = 0; i < n; ++i) {
+                    if (std::string_view{items_[i].first} == key) {
+                        return i;
+                    }
+                }
+                return n;
+
+            case ObjectLookup::Prefix: {
+                const std::uint64_t wanted = pack_prefix(key);
+                const bool prefix_is_key = key.size() <= PREFIX_BYTES;
+                const std::uint64_t* prefixes = side_ + 1;
+                for (size_type i = config_detail::find_u64(prefixes, n, wanted); i < n;
+                     i = config_detail::find_u64(prefixes, n, wanted, i + 1)) {
+                    if (prefix_is_key || std::string_view{items_[i].first} == key) {
+                        return i;
+                    }
+                }
+                return n;
+            }
+
+            case ObjectLookup::Hashed: {
+                const std::uint32_t hash = hash_key(key);
+                const std::size_t mask = side_capacity() - 1;
+                for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+                    const std::uint64_t slot = side_[i + 1];
+                    if (slot == 0) {
+                        return n;
+                    }
+                    if (slot_hash(slot) == hash && std::string_view{items_[slot_pos(slot)].first} == key) {
+                        return slot_pos(slot);
+                    }
+                }
+            }
+        }
+        return n;
+    }
+
+    // As locate(), for a key object. Every key stored in an object on a KeyPool is interned in that
+    // pool (BasicInternedKey re-interns on allocator-extended copies and moves), so a key of the
+    // same pool matches exactly the entry with the same handle.
+    template <typename K>
+    [[nodiscard]] size_type locate_key(const K& key) const noexcept {
+        if constexpr (requires { key.handle(); key.interned_with(items_.get_allocator()); }) {
+            if (key.interned_with(items_.get_allocator())) {
+                const size_type n = items_.size();
+                if (lookup_mode() != ObjectLookup::Hashed) {
+                    for (size_type i = 0; i < n; ++i) {
+                        if (items_[i].first.handle() == key.handle()) {
+                            return i;
+                        }
+                    }
+                    return n;
+                }
+                const std::uint32_t hash = key.hash();
+                const std::size_t mask = side_capacity() - 1;
+                for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+                    const std::uint64_t slot = side_[i + 1];
+                    if (slot == 0) {
+                        return n;
+                    }
+                    if (slot_hash(slot) == hash && items_[slot_pos(slot)].first.handle() == key.handle()) {
+                        return slot_pos(slot);
+                    }
+                }
+            }
+        }
+        return locate(std::string_view{key});
+    }
+
+    static void insert_slot(std::uint64_t* table, std::size_t capacity, std::uint64_t slot) noexcept {
+        const std::size_t mask = capacity - 1;
+        std::size_t i = slot_hash(slot) & mask;
+        while (table[i + 1] != 0) {
+            i = (i + 1) & mask;
+        }
+        table[i + 1] = slot;
+    }
+
+    std::uint64_t* allocate_side(ObjectLookup kind, std::size_t capacity) const {
+        word_allocator alloc{items_.get_allocator()};
+        std::uint64_t* block = word_traits::allocate(alloc, capacity + 1);
+        std::uninitialized_fill_n(block, capacity + 1, std::uint64_t{0});
+        block[0] = (static_cast<std::uint64_t>(kind) << 32U) | static_cast<std::uint64_t>(capacity);
+        return block;
+    }
+
+    void release_side() noexcept {
+        if (side_ != nullptr) {
+            word_allocator alloc{items_.get_allocator()};
+            word_traits::deallocate(alloc, side_, side_capacity() + 1);
+            side_ = nullptr;
+        }
+    }
+
+    // Hash table capacity for n entries: power of two with load factor <= 1/2.
+    static std::size_t table_capacity_for(std::size_t n) noexcept {
+        return std::bit_ceil(n * 2);
+    }
+
+    [[nodiscard]] ObjectLookup wanted_mode() const noexcept {
+        const size_type n = items_.size();
+        if (n >= IndexThreshold && n <= MAX_INDEXED) {
+            return ObjectLookup::Hashed;
+        }
+        if (n >= PrefixThreshold && n < IndexThreshold) {
+            return ObjectLookup::Prefix;
+        }
+        return ObjectLookup::Linear;
+    }
+
+    void rebuild_side() {
+        release_side();
+        side_ = build_side();
+    }
+
+    // Fresh side block for the current entries (nullptr when Linear); side_ is left untouched.
+    [[nodiscard]] std::uint64_t* build_side() const {
+        const size_type n = items_.size();
+        switch (wanted_mode()) {
+            case ObjectLookup::Linear:
+                return nullptr;
+            case ObjectLookup::Prefix: {
+                std::uint64_t* block = allocate_side(ObjectLookup::Prefix, std::max<std::size_t>(n, PrefixThreshold));
+                for (size_type i = 0; i < n; ++i) {
+                    block[i + 1] = pack_prefix(std::string_view{items_[i].first});
+                }
+                return block;
+            }
+            case ObjectLookup::Hashed: {
+                const std::size_t capacity = table_capacity_for(n);
+                std::uint64_t* table = allocate_side(ObjectLookup::Hashed, capacity);
+                for (size_type i = 0; i < n; ++i) {
+                    insert_slot(table, capacity,
+                                make_slot(static_cast<std::uint32_t>(i), hash_key(items_[i].first)));
+                }
+                return table;
+            }
+        }
+        return nullptr;
+    }
+
+    void copy_side_from(const BasicConfigObject& other) {
+        if (other.side_ == nullptr) {
+            return;
+        }
+        const std::size_t capacity = other.side_capacity();
+        std::uint64_t* block = allocate_side(other.side_kind(), capacity);
+        std::copy_n(other.side_ + 1, capacity, block + 1);
+        side_ = block;
+    }
+
+    // Keep the side block in sync after a single push to the back of items_. Every new block is
+    // allocated before the current one is touched, so if this throws, the side block still
+    // matches the entries without the last one and emplace_back() can pop it.
+    void side_appended() {
+        const ObjectLookup mode = lookup_mode();
+        if (mode != wanted_mode()) {
+            // Crossed a threshold: switch strategy.
+            std::uint64_t* block = build_side();
+            release_side();
+            side_ = block;
+            return;
+        }
+
+        const size_type n = items_.size();
+        const std::string_view key{items_.back().first};
+        if (mode == ObjectLookup::Prefix) {
+            if (n > side_capacity()) {
+                // Grow geometrically, like the entry vector itself.
+                std::uint64_t* block = allocate_side(ObjectLookup::Prefix, side_capacity() * 2);
+                std::copy_n(side_ + 1, n - 1, block + 1);
+                release_side();
+                side_ = block;
+            }
+            side_[n] = pack_prefix(key);
+        }
+        else if (mode == ObjectLookup::Hashed) {
+            if (n * 2 > side_capacity()) {
+                // Grow by re-inserting the cached hashes; keys are not rehashed. Slots go in in entry
+                // order, not table order, so the first of several duplicate keys stays first on its
+                // probe chain: the old slots are first permuted in place so that word i + 1 holds
+                // the slot of entry i (the old table has room for twice the entries).
+                const std::size_t capacity = table_capacity_for(n);
+                std::uint64_t* table = allocate_side(ObjectLookup::Hashed, capacity);
+                std::uint64_t* slots = side_ + 1;
+                for (std::size_t i = 0; i < side_capacity(); ++i) {
+                    while (slots[i] != 0 && slot_pos(slots[i]) != i) {
+                        std::swap(slots[i], slots[slot_pos(slots[i])]);
+                    }
+                }
+                for (size_type i = 0; i + 1 < n; ++i) {
+                    insert_slot(table, capacity, slots[i]);
+                }
+                release_side();
+                side_ = table;
+            }
+            const std::uint64_t slot = make_slot(static_cast<std::uint32_t>(n - 1), hash_key(items_.back().first));
+            insert_slot(side_, side_capacity(), slot);
+        }
+    }
+};
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_CONFIG_OBJECT_HPP
@@ -0,0 +1,675 @@
+#ifndef NFRRCONFIG_IMPL_CONFIG_PATCH_HPP
+#define NFRRCONFIG_IMPL_CONFIG_PATCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <expected>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "basic_config_value.hpp"
+#include "bcv_impl.hpp"
+#include "config_path.hpp"
+#include "enums.hpp"
+#include "subtree_pool.hpp"
+
+namespace nfrr::config {
+
+/**
+ * @brief One operation of a BasicPatch, with the fields of an RFC 6902 operation object.
+ *
+ * Paths are RFC 6901 JSON Pointers ("" is the root, "/a/0" the first element of member a).
+ */
+template <typename Value>
+struct BasicPatchOperation {
+    PatchOp op = PatchOp::Add;
+    std::string path; ///< Target location.
+    std::string from; ///< Source location of Move and Copy.
+    Value value;      ///< Operand of Add, Replace and Test.
+};
+
+/// A sequence of operations, applied in order (see diff(), apply_patch()).
+template <typename Value>
+using BasicPatch = std::vector<BasicPatchOperation<Value>>;
+
+/// Why a patch was rejected, and which operation (0-based) rejected it.
+struct PatchError {
+    ConfigError code{ConfigError::None};
+    std::size_t operation{0};
+
+    friend bool operator==(const PatchError&, const PatchError&) = default;
+};
+
+namespace config_detail {
+// Append @p token to a JSON Pointer, escaping '~' and '/' (RFC 6901).
+inline void append_pointer_token(std::string& pointer, std::string_view token) {
+    pointer.push_back('/');
+    for (char c : token) {
+        if (c == '~') {
+            pointer += "~0";
+        }
+        else if (c == '/') {
+            pointer += "~1";
+        }
+        else {
+            pointer.push_back(c);
+        }
+    }
+}
+
+template <typename Value>
+class TreeDiff {
+  public:
+    explicit TreeDiff(BasicPatch<Value>& patch) : patch_{patch} {}
+
+    void node(const Value& a, const Value& b) {
+        if (&a == &b) {
+            return;
+        }
+        if (a.kind() != b.kind()) {
+            emit(PatchOp::Replace, b);
+            return;
+        }
+        if constexpr (requires { a.shared_identity(); }) {
+            if (a.shared_identity() != nullptr && a.shared_identity() == b.shared_identity()) {
+                return; // one payload: identical without looking inside
+            }
+        }
+        if (a.is_object()) {
+            object(a, b);
+        }
+        else if (a.is_array()) {
+            array(a, b);
+        }
+        else if (!same_subtree(a, b)) {
+            emit(PatchOp::Replace, b);
+        }
+    }
+
+  private:
+    BasicPatch<Value>& patch_;
+    std::string path_; // pointer to the nodes being compared
+
+    void emit(PatchOp op, const Value& value) {
+        patch_.push_back({op, path_, {}, Value{value, value.get_allocator()}});
+    }
+
+    void emit_remove() {
+        patch_.push_back({PatchOp::Remove, path_, {}, Value{}});
+    }
+
+    // Members are matched by position while both objects list the same keys in the same order
+    // (the common case for two versions of one document); the rest is matched through the
+    // objects' own lookups (hash index, sorted search), never by pairwise key comparison.
+    void object(const Value& a, const Value& b) {
+        const auto& x = a.as_object();
+        const auto& y = b.as_object();
+        const std::size_t mark = path_.size();
+        auto i = x.begin();
+        auto j = y.begin();
+        for (; i != x.end() && j != y.end(); ++i, ++j) {
+            const auto& m = *i;
+            const auto& n = *j;
+            if (key_chars(m.first) != key_chars(n.first)) {
+                break;
+            }
+            append_pointer_token(path_, key_chars(m.first));
+            node(m.second, n.second);
+            path_.resize(mark);
+        }
+        const auto rest_of_b = j;
+        for (; i != x.end(); ++i) {
+            const auto& m = *i;
+            append_pointer_token(path_, key_chars(m.first));
+            if (auto found = b.find(key_chars(m.first)); found != y.end()) {
+                node(m.second, found->second);
+            }
+            else {
+                emit_remove();
+            }
+            path_.resize(mark);
+        }
+        for (j = rest_of_b; j != y.end(); ++j) {
+            const auto& n = *j;
+            if (a.find(key_chars(n.first)) == x.end()) {
+                append_pointer_token(path_, key_chars(n.first));
+                emit(PatchOp::Add, n.second);
+                path_.resize(mark);
+            }
+        }
+    }
+
+    // Equal leading and trailing elements are skipped, so one insertion or removal anywhere is
+    // one operation; the remaining elements are compared pairwise, then the longer side's surplus
+    // is removed (from the back, keeping indices valid) or added.
+    void array(const Value& a, const Value& b) {
+        const auto& x = a.as_array();
+        const auto& y = b.as_array();
+        std::size_t lo = 0;
+        while (lo < x.size() && lo < y.size() && same_subtree(x[lo], y[lo])) {
+            ++lo;
+        }
+        std::size_t end_x = x.size();
+        std::size_t end_y = y.size();
+        while (end_x > lo && end_y > lo && same_subtree(x[end_x - 1], y[end_y - 1])) {
+            --end_x;
+            --end_y;
+        }
+        const std::size_t paired = std::min(end_x, end_y);
+        const std::size_t mark = path_.size();
+        for (std::size_t k = lo; k < paired; ++k) {
+            append_pointer_token(path_, std::to_string(k));
+            node(x[k], y[k]);
+            path_.resize(mark);
+        }
+        for (std::size_t k = end_x; k > paired; --k) {
+            append_pointer_token(path_, std::to_string(k - 1));
+            emit_remove();
+            path_.resize(mark);
+        }
+        for (std::size_t k = paired; k < end_y; ++k) {
+            append_pointer_token(path_, std::to_string(k));
+            emit(PatchOp::Add, y[k]);
+            path_.resize(mark);
+        }
+    }
+};
+// Equality as defined for the test operation: numbers by value (1 == 1.0, integers compared as
+// double), object members regardless of order.
+template <typename Value>
+bool json_equal(const Value& a, const Value& b) {
+    if (a.kind() != b.kind()) {
+        if (a.is_integer() && b.is_floating()) {
+            return static_cast<double>(a.as_integer()) == b.as_floating();
+        }
+        if (a.is_floating() && b.is_integer()) {
+            return a.as_floating() == static_cast<double>(b.as_integer());
+        }
+        return false;
+    }
+    switch (a.kind()) {
+        case ConfigValueKind::Array: {
+            const auto& x = a.as_array();
+            const auto& y = b.as_array();
+            if (x.size() != y.size()) {
+                return false;
+            }
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                if (!json_equal(x[i], y[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case ConfigValueKind::Object: {
+            const auto& y = b.as_object();
+            if (a.as_object().size() != y.size()) {
+                return false;
+            }
+            for (const auto& m : a.as_object()) {
+                auto found = b.find(key_chars(m.first));
+                if (found == y.end() || !json_equal(m.second, found->second)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case ConfigValueKind::Floating:
+            return a.as_floating() == b.as_floating();
+        default:
+            return same_subtree(a, b);
+    }
+}
+
+// Objects that keep insertion order and can insert at a position (BasicConfigObject).
+template <typename Object>
+concept PositionalObject = requires(Object& obj, typename Object::value_type&& kv) {
+    obj.insert(obj.cbegin(), std::move(kv));
+};
+
+/**
+ * Applies patch operations in place and logs how to undo each step. Values leave and enter the
+ * tree by move; whatever a step detaches (removed members, replaced values) is kept in the log,
+ * so rollback() moves it back rather than rebuilding anything.
+ */
+template <typename Value>
+class PatchApplier {
+  public:
+    explicit PatchApplier(Value& root) : root_{root} {}
+
+    template <typename Operand>
+    ConfigError apply(PatchOp op, std::string_view path_text, std::string_view from_text, Operand&& operand) {
+        auto path = pointer(path_text);
+        if (!path) {
+            return path.error();
+        }
+        switch (op) {
+            case PatchOp::Add:
+                return add(std::move(*path), std::forward<Operand>(operand));
+            case PatchOp::Remove: {
+                auto removed = remove(std::move(*path), false);
+                return removed ? ConfigError::None : removed.error();
+            }
+            case PatchOp::Replace: {
+                auto target = walk(root_, *path, path->size());
+                if (!target) {
+                    return target.error();
+                }
+                overwrite(**target, std::move(*path), std::forward<Operand>(operand));
+                return ConfigError::None;
+            }
+            case PatchOp::Test: {
+                auto target = walk(std::as_const(root_), *path, path->size());
+                if (!target) {
+                    return target.error();
+                }
+                return json_equal(**target, std::as_const(operand)) ? ConfigError::None : ConfigError::TestFailed;
+            }
+            default:
+                break;
+        }
+        auto from = pointer(from_text);
+        if (!from) {
+            return from.error();
+        }
+        if (op == PatchOp::Copy) {
+            auto source = walk(std::as_const(root_), *from, from->size());
+            if (!source) {
+                return source.error();
+            }
+            // Copied before the target path is walked: with shared nodes the copy shares the source's
+            // payload, and walking for write then detaches an ancestor source instead of inserting
+            // that payload under itself.
+            Value copy{**source, root_.get_allocator()};
+            return add(std::move(*path), std::move(copy));
+        }
+        // Move: a value cannot move into its own subtree; moving onto itself changes nothing.
+        if (path_text.size() > from_text.size() && path_text.starts_with(from_text) &&
+            path_text[from_text.size()] == '/') {
+            return ConfigError::InvalidPath;
+        }
+        if (path_text == from_text) {
+            auto source = walk(std::as_const(root_), *from, from->size());
+            return source ? ConfigError::None : source.error();
+        }
+        auto moved = remove(std::move(*from), true);
+        if (!moved) {
+            return moved.error();
+        }
+        // Staged in carry_: if add() fails (or throws) before taking it, the remove's undo puts it back.
+        carry_.emplace(std::move(*moved));
+        return add(std::move(*path), std::move(*carry_));
+    }
+
+    /// Undo every step applied so far, newest first.
+    void rollback() {
+        for (auto step = undo_.rbegin(); step != undo_.rend(); ++step) {
+            // The tree is as the step left it, so its path resolves.
+            if (step->kind == UndoKind::Restore) {
+                Value& target = **walk(root_, step->path, step->path.size());
+                carry_.emplace(std::move(target));
+                target = std::move(step->value);
+                continue;
+            }
+            Value& parent = **walk(root_, step->path, step->path.size() - 1);
+            const std::string& key = step->path.segments().back().key;
+            switch (step->kind) {
+                case UndoKind::Erase:
+                    if (parent.is_object()) {
+                        auto& obj = parent.as_object();
+                        auto it = parent.find(std::string_view{key});
+                        carry_.emplace(std::move(it->second));
+                        obj.erase(it);
+                    }
+                    else {
+                        auto& arr = parent.as_array();
+                        carry_.emplace(std::move(arr[step->index]));
+                        arr.erase(arr.begin() + static_cast<std::ptrdiff_t>(step->index));
+                    }
+                    break;
+                case UndoKind::Insert: {
+                    Value value = step->carried ? std::move(*carry_) : std::move(step->value);
+                    if (parent.is_object()) {
+                        insert_member(parent.as_object(), key, std::move(value), step->index);
+                    }
+                    else {
+                        auto& arr = parent.as_array();
+                        arr.insert(arr.begin() + static_cast<std::ptrdiff_t>(step->index), std::move(value));
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        undo_.clear();
+        carry_.reset();
+    }
+
+  private:
+    // Restore: put `value` back at `path`. Erase: remove the member or element at `path` (element
+    // `index`). Insert: reinsert `value`, or with `carried` the value detached by the step undone
+    // just before (a move's add), at `path` (element `index`, or member position `index`).
+    enum class UndoKind : std::uint8_t { Restore, Erase, Insert };
+
+    struct Undo {
+        UndoKind kind;
+        ConfigPath path;
+        std::size_t index;
+        Value value;
+        bool carried;
+    };
+
+    Value& root_;
+    std::vector<Undo> undo_;
+    std::optional<Value> carry_; // move-constructed, so it never copies across allocators
+
+    static std::expected<ConfigPath, ConfigError> pointer(std::string_view text) {
+        if (!text.empty() && text.front() != '/') {
+            return std::unexpected(ConfigError::InvalidPath);
+        }
+        return ConfigPath::parse(text);
+    }
+
+    // The node reached by the first @p count segments of @p path. Never inserts.
+    template <typename V>
+    static std::expected<V*, ConfigError> walk(V& root, const ConfigPath& path, std::size_t count) {
+        V* current = &root;
+        for (std::size_t k = 0; k < count; ++k) {
+            const auto& seg = path.segments()[k];
+            if (current->is_object()) {
+                auto it = current->find(std::string_view{seg.key});
+                if (it == current->as_object().end()) {
+                    return std::unexpected(ConfigError::KeyNotFound);
+                }
+                current = &it->second;
+            }
+            else if (current->is_array()) {
+                auto& arr = current->as_array();
+                if (seg.index == ConfigPath::NO_INDEX) {
+                    return std::unexpected(ConfigError::InvalidPath);
+                }
+                if (seg.index >= arr.size()) {
+                    return std::unexpected(ConfigError::IndexNotFound);
+                }
+                current = &arr[seg.index];
+            }
+            else {
+                return std::unexpected(ConfigError::TypeMismatch);
+            }
+        }
+        return current;
+    }
+
+    static void insert_member(auto& obj, std::string_view key, Value&& value, std::size_t position) {
+        obj.try_emplace(key, std::move(value));
+        if constexpr (PositionalObject<std::remove_cvref_t<decltype(obj)>>) {
+            if (position + 1 < obj.size()) {
+                auto last = std::prev(obj.end());
+                auto kv = std::move(*last);
+                obj.erase(last);
+                obj.insert(obj.begin() + static_cast<std::ptrdiff_t>(position), std::move(kv));
+            }
+        }
+    }
+
+    void log(UndoKind kind, ConfigPath&& path, std::size_t index, Value&& value, bool carried) noexcept {
+        undo_.push_back(Undo{kind, std::move(path), index, std::move(value), carried}); // capacity reserved
+    }
+
+    template <typename Operand>
+    void overwrite(Value& target, ConfigPath&& path, Operand&& operand) {
+        Value incoming{std::forward<Operand>(operand), target.get_allocator()};
+        undo_.reserve(undo_.size() + 1);
+        Value old{std::move(target)};
+        target = std::move(incoming);
+        log(UndoKind::Restore, std::move(path), 0, std::move(old), false);
+    }
+
+    template <typename Operand>
+    ConfigError add(ConfigPath&& path, Operand&& operand) {
+        if (path.empty()) {
+            overwrite(root_, std::move(path), std::forward<Operand>(operand));
+            return ConfigError::None;
+        }
+        auto found = walk(root_, path, path.size() - 1);
+        if (!found) {
+            return found.error();
+        }
+        Value& parent = **found;
+        const auto& last = path.segments().back();
+        if (parent.is_object()) {
+            if (auto it = parent.find(std::string_view{last.key}); it != parent.as_object().end()) {
+                overwrite(it->second, std::move(path), std::forward<Operand>(operand));
+                return ConfigError::None;
+            }
+            Value incoming{std::forward<Operand>(operand), parent.get_allocator()};
+            undo_.reserve(undo_.size() + 1);
+            parent.as_object().try_emplace(std::string_view{last.key}, std::move(incoming));
+            log(UndoKind::Erase, std::move(path), 0, Value{}, false);
+            return ConfigError::None;
+        }
+        if (!parent.is_array()) {
+            return ConfigError::TypeMismatch;
+        }
+        auto& arr = parent.as_array();
+        const std::size_t index = last.key == "-" ? arr.size() : last.index;
+        if (index == ConfigPath::NO_INDEX) {
+            return ConfigError::InvalidPath;
+        }
+        if (index > arr.size()) {
+            return ConfigError::IndexNotFound;
+        }
+        Value incoming{std::forward<Operand>(operand), parent.get_allocator()};
+        undo_.reserve(undo_.size() + 1);
+        arr.insert(arr.begin() + static_cast<std::ptrdiff_t>(index), std::move(incoming));
+        log(UndoKind::Erase, std::move(path), index, Value{}, false);
+        return ConfigError::None;
+    }
+
+    // Detach the value at @p path. The undo log keeps it, or with @p carried it is returned and
+    // the undo step reinserts what the step before it detached (move = remove + add).
+    std::expected<Value, ConfigError> remove(ConfigPath&& path, bool carried) {
+        if (path.empty()) {
+            return std::unexpected(ConfigError::InvalidPath);
+        }
+        auto found = walk(root_, path, path.size() - 1);
+        if (!found) {
+            return std::unexpected(found.error());
+        }
+        Value& parent = **found;
+        const auto& last = path.segments().back();
+        std::size_t index = 0;
+        std::optional<Value> removed;
+        undo_.reserve(undo_.size() + 1);
+        if (parent.is_object()) {
+            auto& obj = parent.as_object();
+            auto it = parent.find(std::string_view{last.key});
+            if (it == obj.end()) {
+                return std::unexpected(ConfigError::KeyNotFound);
+            }
+            index = static_cast<std::size_t>(std::distance(obj.begin(), it));
+            removed.emplace(std::move(it->second));
+            obj.erase(it);
+        }
+        else if (parent.is_array()) {
+            auto& arr = parent.as_array();
+            index = last.index;
+            if (index == ConfigPath::NO_INDEX) {
+                return std::unexpected(ConfigError::InvalidPath);
+            }
+            if (index >= arr.size()) {
+                return std::unexpected(ConfigError::IndexNotFound);
+            }
+            removed.emplace(std::move(arr[index]));
+            arr.erase(arr.begin() + static_cast<std::ptrdiff_t>(index));
+        }
+        else {
+            return std::unexpected(ConfigError::TypeMismatch);
+        }
+        if (carried) {
+            log(UndoKind::Insert, std::move(path), index, Value{}, true);
+            return std::move(*removed);
+        }
+        log(UndoKind::Insert, std::move(path), index, std::move(*removed), false);
+        return Value{};
+    }
+};
+
+template <bool MOVE_OPERANDS, typename Value, typename Patch>
+std::expected<void, PatchError> apply_patch(Value& target, Patch& patch) {
+    PatchApplier<Value> applier{target};
+    try {
+        for (std::size_t k = 0; k < patch.size(); ++k) {
+            auto& op = patch[k];
+            ConfigError error = ConfigError::None;
+            if constexpr (MOVE_OPERANDS) {
+                error = applier.apply(op.op, op.path, op.from, std::move(op.value));
+            }
+            else {
+                error = applier.apply(op.op, op.path, op.from, std::as_const(op.value));
+            }
+            if (error != ConfigError::None) {
+                applier.rollback();
+                return std::unexpected(PatchError{error, k});
+            }
+        }
+    }
+    catch (...) {
+        applier.rollback();
+        throw;
+    }
+    return {};
+}
+} // namespace config_detail
+
+/**
+ * @brief Operations that turn @p a into @p b: Add, Remove and Replace with JSON Pointer paths.
+ *
+ * Applying the result to a copy of @p a in order yields a tree equal to @p b (in the sense of
+ * SubtreePool: floating values by bit pattern). The patch is compact rather than minimal:
+ *  - a changed scalar or string, or a node whose kind changed, is one Replace of that node;
+ *  - object members are matched by key, so reordering members alone yields no operation;
+ *  - arrays are aligned by skipping their equal head and tail, so a single insertion or
+ *    removal is one operation; elements in between are diffed pairwise.
+ *
+ * Identical subtrees end the descent: with SharedNodePolicy, nodes sharing a payload (e.g. the
+ * unchanged parts of two ConfigStore versions) are recognized in O(1) without looking inside;
+ * otherwise equality costs a walk that stops at the first difference. Object keys are matched
+ * through the objects' own indexes, so wide objects cost O(n), not O(n^2), key comparisons.
+ *
+ * Operation values are copies of subtrees of @p b with its allocator (O(1) with SharedNodePolicy).
+ */
+template <typename Alloc, typename ObjectPolicy>
+[[nodiscard]] BasicPatch<BasicConfigValue<Alloc, ObjectPolicy>> diff(const BasicConfigValue<Alloc, ObjectPolicy>& a,
+                                                                     const BasicConfigValue<Alloc, ObjectPolicy>& b) {
+    BasicPatch<BasicConfigValue<Alloc, ObjectPolicy>> patch;
+    config_detail::TreeDiff<BasicConfigValue<Alloc, ObjectPolicy>>{patch}.node(a, b);
+    return patch;
+}
+
+/**
+ * @brief Apply an RFC 6902 patch to @p target in place, all operations or none.
+ *
+ * Supports add, remove, replace, move, copy and test with RFC 6901 paths ("-" appends to an
+ * array). Only the nodes on the operations' paths are touched: moved and removed subtrees are
+ * detached by move, never copied, and operands are copied in once (see the rvalue overload to
+ * move them instead). With SharedNodePolicy, a tree shared with other values (e.g. a copy of a
+ * ConfigStore root) is unshared only along those paths.
+ *
+ * If an operation fails, including a test that finds a different value (numbers compare by
+ * value, objects regardless of member order), the operations already applied are undone from
+ * an undo log that holds every detached value, so @p target is left as it was, member order
+ * included (sorted objects that track insertion order may record restored members as new).
+ * Undoing moves values back; nothing is reparsed or rebuilt. The same happens, before the
+ * exception propagates, if an allocation throws.
+ *
+ * @return Nothing, or the error and the index of the operation that failed: InvalidPath for a
+ *         malformed path or a move into the moved value's own subtree, KeyNotFound,
+ *         IndexNotFound or TypeMismatch when a path does not resolve, TestFailed for a failed test.
+ */
+template <typename Alloc, typename ObjectPolicy>
+std::expected<void, PatchError> apply_patch(BasicConfigValue<Alloc, ObjectPolicy>& target,
+                                            const BasicPatch<BasicConfigValue<Alloc, ObjectPolicy>>& patch) {
+    return config_detail::apply_patch<false>(target, patch);
+}
+
+/// As above, moving the operands of add and replace into @p target; @p patch is consumed.
+template <typename Alloc, typename ObjectPolicy>
+std::expected<void, PatchError> apply_patch(BasicConfigValue<Alloc, ObjectPolicy>& target,
+                                            BasicPatch<BasicConfigValue<Alloc, ObjectPolicy>>&& patch) {
+    return config_detail::apply_patch<true>(target, patch);
+}
+
+/**
+ * @brief Read an RFC 6902 patch document (an array of operation objects) into a BasicPatch.
+ *
+ * Operands are moved out of @p document. Members other than "op", "path", "from" and "value"
+ * are ignored.
+ *
+ * @return The patch, or SyntaxError and the index of the first operation that is not an object,
+ *         has an unknown "op", lacks a string "path" (or "from" for move and copy) or lacks the
+ *         "value" of add, replace and test. A document that is not an array fails at index 0.
+ */
+template <typename Alloc, typename ObjectPolicy>
+std::expected<BasicPatch<BasicConfigValue<Alloc, ObjectPolicy>>, PatchError>
+parse_patch(BasicConfigValue<Alloc, ObjectPolicy> document) {
+    using Value = BasicConfigValue<Alloc, ObjectPolicy>;
+    static constexpr std::array<std::string_view, 6> NAMES{"add", "remove", "replace", "move", "copy", "test"};
+    const auto text = [](const Value* v) {
+        return std::string_view{v->as_string().data(), v->as_string().size()};
+    };
+    const auto member = [](Value& v, std::string_view key) -> Value* {
+        auto it = v.find(key);
+        return it == v.as_object().end() ? nullptr : &it->second;
+    };
+
+    BasicPatch<Value> patch;
+    if (!document.is_array()) {
+        return std::unexpected(PatchError{ConfigError::SyntaxError, 0});
+    }
+    auto& ops = document.as_array();
+    patch.reserve(ops.size());
+    for (std::size_t k = 0; k < ops.size(); ++k) {
+        const PatchError error{ConfigError::SyntaxError, k};
+        if (!ops[k].is_object()) {
+            return std::unexpected(error);
+        }
+        Value* op = member(ops[k], "op");
+        Value* path = member(ops[k], "path");
+        if (op == nullptr || !op->is_string() || path == nullptr || !path->is_string()) {
+            return std::unexpected(error);
+        }
+        const auto name = std::find(NAMES.begin(), NAMES.end(), text(op));
+        if (name == NAMES.end()) {
+            return std::unexpected(error);
+        }
+        auto& entry = patch.emplace_back();
+        entry.op = static_cast<PatchOp>(name - NAMES.begin());
+        entry.path.assign(text(path));
+        if (entry.op == PatchOp::Move || entry.op == PatchOp::Copy) {
+            Value* from = member(ops[k], "from");
+            if (from == nullptr || !from->is_string()) {
+                return std::unexpected(error);
+            }
+            entry.from.assign(text(from));
+        }
+        else if (entry.op != PatchOp::Remove) {
+            Value* value = member(ops[k], "value");
+            if (value == nullptr) {
+                return std::unexpected(error);
+            }
+            entry.value = std::move(*value);
+        }
+    }
+    return patch;
+}
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_CONFIG_PATCH_HPP
@@ -0,0 +1,380 @@
+#ifndef NFRRCONFIG_IMPL_CONFIG_PATH_HPP
+#define NFRRCONFIG_IMPL_CONFIG_PATH_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "basic_config_value.hpp"
+#include "enums.hpp"
+
+namespace nfrr::config {
+
+namespace config_detail {
+template <typename T>
+struct IsConfigValue : std::false_type {};
+
+template <typename Alloc, typename ObjectPolicy>
+struct IsConfigValue<BasicConfigValue<Alloc, ObjectPolicy>> : std::true_type {};
+
+/**
+ * @brief Satisfied by (possibly const) BasicConfigValue specializations.
+ */
+template <typename T>
+concept ConfigValueType = IsConfigValue<std::remove_const_t<T>>::value;
+} // namespace config_detail
+
+/**
+ * @brief Precompiled path into a BasicConfigValue tree, with cached resolution.
+ *
+ * A path is compiled once from either syntax:
+ *  - dotted:       "a.b[3].c"   (keys separated by '.', array indices in brackets)
+ *  - JSON Pointer: "/a/b/3/c"   (RFC 6901, with ~0 / ~1 escapes)
+ * An empty string is the root in both syntaxes.
+ *
+ * Resolution never inserts keys. Each object hop remembers the position where its
+ * key was found last time; on the next resolution that position is verified with a
+ * single key compare, so re-resolving against an unchanged tree costs a few pointer
+ * hops instead of key searches, and a changed tree transparently falls back to a
+ * search and refreshes the cache.
+ *
+ * When the caller can vouch that a tree is unchanged (e.g. immutable snapshots that
+ * carry a version number), the versioned overloads skip even the per-hop checks and
+ * return the cached target directly while (root address, version) match.
+ *
+ * @note Resolution updates the cache, so a ConfigPath must not be resolved from
+ *       several threads at once; give each thread its own copy.
+ */
+class ConfigPath {
+    static constexpr std::size_t NO_POS = std::numeric_limits<std::size_t>::max();
+
+  public:
+    static constexpr std::size_t NO_INDEX = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * @brief One path step: an object key, or an array index (or either, resolved
+     *        by the kind of the container met at run time).
+     */
+    struct Segment {
+        std::string key;                 ///< Object key (decimal text for indices).
+        std::size_t index = NO_INDEX;    ///< Array index, or NO_INDEX.
+        bool index_only = false;         ///< Bracket syntax: arrays only.
+        std::size_t cached_pos = NO_POS; ///< Position where the key was last found.
+    };
+
+  private:
+    std::vector<Segment> segments_;
+
+    // Versioned fast path cache.
+    const void* cached_root_ = nullptr;
+    void* cached_target_ = nullptr;
+    std::uint64_t cached_version_ = 0;
+    bool cached_mutable_ = false; ///< Target came from a non-const walk (shared nodes already unshared).
+
+  public:
+    /// Path to the root value.
+    ConfigPath() = default;
+
+    /**
+     * @brief Compile a path, throwing on syntax errors.
+     *
+     * @throws std::invalid_argument if @p path is malformed.
+     */
+    explicit ConfigPath(std::string_view path) {
+        auto parsed = parse(path);
+        if (!parsed) {
+            throw std::invalid_argument{"ConfigPath: malformed path expression"};
+        }
+        *this = std::move(*parsed);
+    }
+
+    /**
+     * @brief Compile a path without throwing on syntax errors.
+     *
+     * A leading '/' selects JSON Pointer syntax, anything else the dotted syntax.
+     */
+    [[nodiscard]] static std::expected<ConfigPath, ConfigError> parse(std::string_view path) {
+        ConfigPath result;
+        const bool ok = (!path.empty() && path.front() == '/') ? result.parse_pointer(path) : result.parse_dotted(path);
+        if (!ok) {
+            return std::unexpected(ConfigError::InvalidPath);
+        }
+        return result;
+    }
+
+    /// Build a path from already-split segments (keys; numeric keys also match array indices).
+    template <typename Range>
+    [[nodiscard]] static ConfigPath from_segments(const Range& keys) {
+        ConfigPath result;
+        for (const auto& key : keys) {
+            result.push_key(std::string_view{key});
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return segments_.size();
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return segments_.empty();
+    }
+    [[nodiscard]] const std::vector<Segment>& segments() const noexcept {
+        return segments_;
+    }
+
+    /// Render as an RFC 6901 JSON Pointer.
+    [[nodiscard]] std::string to_pointer() const {
+        std::string out;
+        for (const Segment& seg : segments_) {
+            out.push_back('/');
+            for (char c : seg.key) {
+                if (c == '~') {
+                    out += "~0";
+                }
+                else if (c == '/') {
+                    out += "~1";
+                }
+                else {
+                    out.push_back(c);
+                }
+            }
+        }
+        return out;
+    }
+
+    // --------- resolution ---------
+
+    /**
+     * @brief Resolve against @p root without throwing.
+     *
+     * @return Pointer to the target value, or KeyNotFound / IndexNotFound when a step
+     *         is missing, TypeMismatch when a step meets a non-container.
+     */
+    template <config_detail::ConfigValueType Value>
+    std::expected<Value*, ConfigError> resolve(Value& root) {
+        Value* current = &root;
+        for (Segment& seg : segments_) {
+            auto next = step(*current, seg);
+            if (!next) {
+                return std::unexpected(next.error());
+            }
+            current = *next;
+        }
+        return current;
+    }
+
+    /**
+     * @brief Resolve with a caller-supplied structural version.
+     *
+     * If the previous versioned resolution used the same root object and version,
+     * the cached target is returned without walking the tree. The caller guarantees
+     * that the tree does not change while its version stays the same.
+     *
+     * A target cached by a const resolution is not handed to a non-const one: with
+     * shared nodes only the non-const walk unshares, so such a call walks again and
+     * replaces the cached target.
+     */
+    template <config_detail::ConfigValueType Value>
+    std::expected<Value*, ConfigError> resolve(Value& root, std::uint64_t version) {
+        constexpr bool mutable_walk = !std::is_const_v<Value>;
+        if (cached_target_ != nullptr && cached_root_ == &root && cached_version_ == version &&
+            (cached_mutable_ || !mutable_walk)) {
+            return static_cast<Value*>(cached_target_);
+        }
+        auto res = resolve(root);
+        if (res) {
+            cached_root_ = &root;
+            cached_version_ = version;
+            cached_target_ = const_cast<std::remove_const_t<Value>*>(*res); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+            cached_mutable_ = mutable_walk;
+        }
+        return res;
+    }
+
+    /// Resolve, returning nullptr when the path does not exist.
+    template <config_detail::ConfigValueType Value>
+    Value* find(Value& root) {
+        auto res = resolve(root);
+        return res ? *res : nullptr;
+    }
+
+    template <config_detail::ConfigValueType Value>
+    Value* find(Value& root, std::uint64_t version) {
+        auto res = resolve(root, version);
+        return res ? *res : nullptr;
+    }
+
+    /**
+     * @brief Resolve, throwing if the path does not exist.
+     *
+     * @throws std::out_of_range if a step is missing or meets a non-container.
+     */
+    template <config_detail::ConfigValueType Value>
+    Value& at(Value& root) {
+        auto res = resolve(root);
+        if (!res) {
+            throw std::out_of_range{"ConfigPath::at(): path not found"};
+        }
+        return **res;
+    }
+
+    /// Forget all cached positions and the versioned target.
+    void invalidate() noexcept {
+        for (Segment& seg : segments_) {
+            seg.cached_pos = NO_POS;
+        }
+        cached_target_ = nullptr;
+        cached_root_ = nullptr;
+        cached_mutable_ = false;
+    }
+
+  private:
+    static std::size_t parse_index(std::string_view digits) noexcept {
+        // Decimal without sign or leading zeros (RFC 6901 array index rules).
+        if (digits.empty() || (digits.size() > 1 && digits.front() == '0')) {
+            return NO_INDEX;
+        }
+        std::size_t value = 0;
+        const char* last = digits.data() + digits.size();
+        auto [ptr, ec] = std::from_chars(digits.data(), last, value);
+        if (ec != std::errc{} || ptr != last || value == NO_INDEX) {
+            return NO_INDEX;
+        }
+        return value;
+    }
+
+    void push_key(std::string_view key) {
+        Segment seg;
+        seg.key.assign(key);
+        seg.index = parse_index(key);
+        segments_.push_back(std::move(seg));
+    }
+
+    bool parse_pointer(std::string_view path) {
+        // path[0] == '/'
+        std::size_t pos = 1;
+        while (true) {
+            const std::size_t slash = path.find('/', pos);
+            const std::string_view raw = path.substr(pos, slash == std::string_view::npos ? path.size() - pos : slash - pos);
+            std::string key;
+            key.reserve(raw.size());
+            for (std::size_t i = 0; i < raw.size(); ++i) {
+                if (raw[i] != '~') {
+                    key.push_back(raw[i]);
+                    continue;
+                }
+                if (i + 1 == raw.size() || (raw[i + 1] != '0' && raw[i + 1] != '1')) {
+                    return false;
+                }
+                key.push_back(raw[i + 1] == '0' ? '~' : '/');
+                ++i;
+            }
+            push_key(key);
+            if (slash == std::string_view::npos) {
+                return true;
+            }
+            pos = slash + 1;
+        }
+    }
+
+    bool parse_dotted(std::string_view path) {
+        std::size_t pos = 0;
+        bool expect_key = true; // at start or right after '.'
+        while (pos < path.size()) {
+            const char c = path[pos];
+            if (c == '[') {
+                const std::size_t close = path.find(']', pos);
+                if (close == std::string_view::npos) {
+                    return false;
+                }
+                const std::size_t index = parse_index(path.substr(pos + 1, close - pos - 1));
+                if (index == NO_INDEX) {
+                    return false;
+                }
+                Segment seg;
+                seg.key.assign(path.substr(pos + 1, close - pos - 1));
+                seg.index = index;
+                seg.index_only = true;
+                segments_.push_back(std::move(seg));
+                pos = close + 1;
+                expect_key = false;
+            }
+            else if (c == '.') {
+                if (expect_key) {
+                    return false; // empty key
+                }
+                ++pos;
+                expect_key = true;
+                if (pos == path.size()) {
+                    return false; // trailing '.'
+                }
+            }
+            else {
+                if (!expect_key) {
+                    return false; // "a[0]b"
+                }
+                const std::size_t end = path.find_first_of(".[", pos);
+                const std::size_t stop = end == std::string_view::npos ? path.size() : end;
+                if (path.find(']', pos) < stop) {
+                    return false;
+                }
+                push_key(path.substr(pos, stop - pos));
+                pos = stop;
+                expect_key = false;
+            }
+        }
+        return true;
+    }
+
+    // Object hop: verify the cached position with one key compare, search otherwise.
+    template <typename Obj>
+    static auto lookup(Obj& obj, Segment& seg) -> decltype(&obj[0].second) {
+        if (seg.cached_pos < obj.size()) {
+            auto&& entry = obj[seg.cached_pos];
+            if (std::string_view{entry.first} == seg.key) {
+                return &entry.second;
+            }
+        }
+        auto it = obj.find(seg.key);
+        if (it == obj.end()) {
+            return nullptr;
+        }
+        seg.cached_pos = static_cast<std::size_t>(it - obj.begin());
+        return &it->second;
+    }
+
+    template <typename Value>
+    static std::expected<Value*, ConfigError> step(Value& current, Segment& seg) {
+        if (current.is_array()) {
+            if (seg.index == NO_INDEX) {
+                return std::unexpected(ConfigError::TypeMismatch);
+            }
+            auto& arr = current.as_array();
+            if (seg.index >= arr.size()) {
+                return std::unexpected(ConfigError::IndexNotFound);
+            }
+            return &arr[seg.index];
+        }
+        if (current.is_object() && !seg.index_only) {
+            Value* found = lookup(current.as_object(), seg);
+            if (found == nullptr) {
+                return std::unexpected(ConfigError::KeyNotFound);
+            }
+            return found;
+        }
+        return std::unexpected(ConfigError::TypeMismatch);
+    }
+};
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_CONFIG_PATH_HPP
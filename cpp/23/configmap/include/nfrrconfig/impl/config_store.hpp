@@ -0,0 +1,266 @@
+#ifndef NFRRCONFIG_IMPL_CONFIG_STORE_HPP
+#define NFRRCONFIG_IMPL_CONFIG_STORE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "basic_config_value.hpp"
+#include "bcv_impl.hpp"
+
+// Default number of reader slots of a ConfigStore, i.e. of Readers that may exist at once.
+#ifndef NFRRCONFIG_STORE_MAX_READERS
+#define NFRRCONFIG_STORE_MAX_READERS 256
+#endif
+
+namespace nfrr::config {
+
+/**
+ * @brief Publishes immutable configuration roots to concurrent readers (RCU style).
+ *
+ * Writers build a new tree and publish() it with one atomic pointer swap; they are serialized
+ * among themselves by a mutex that readers never touch. Readers register once per thread with
+ * reader() and then pin() the current root: announcing the global epoch in the reader's own
+ * cache-line-sized slot and loading the root pointer, which is wait-free and involves no shared
+ * writes. While pinned, the root and everything reachable from it stays valid and unchanged.
+ *
+ * Replaced roots are retired with the epoch of their replacement and freed later, by publish()
+ * or reclaim(), once every pinned reader announced a newer epoch. A reader that stays pinned
+ * therefore delays reclamation of the roots published since, but never blocks writers.
+ *
+ * With SharedNodePolicy, update() copies the current root in O(1) and the edit copies only the
+ * paths it writes, so consecutive versions share their unchanged subtrees. Shared payloads are
+ * reference counted atomically, so old versions can be dropped while readers use new ones.
+ *
+ * Readers and pins must not outlive the store.
+ */
+template <typename Alloc, typename ObjectPolicy = DefaultObjectPolicy>
+class ConfigStore {
+  public:
+    using value_type = BasicConfigValue<Alloc, ObjectPolicy>;
+    using allocator_type = Alloc;
+
+    static constexpr std::size_t DEFAULT_MAX_READERS = NFRRCONFIG_STORE_MAX_READERS;
+
+  private:
+    static constexpr std::size_t CACHE_LINE = 64;
+    static constexpr std::uint64_t UNPINNED = 0;
+
+    struct Version {
+        value_type root;
+        std::uint64_t number;
+        std::uint64_t retired_at = 0; // epoch of the replacement
+    };
+
+    // One per Reader, padded so that pinning only writes a line no other reader uses.
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<std::uint64_t> epoch{UNPINNED}; // announced epoch while pinned
+        std::atomic<bool> taken{false};
+    };
+
+  public:
+    class Reader;
+
+    /// A pinned version: its root stays valid until the Pin is destroyed.
+    class Pin {
+      public:
+        Pin(Pin&& other) noexcept
+            : reader_{std::exchange(other.reader_, nullptr)}, version_{std::exchange(other.version_, nullptr)} {}
+        Pin& operator=(Pin&&) = delete;
+        Pin(const Pin&) = delete;
+        Pin& operator=(const Pin&) = delete;
+
+        ~Pin() {
+            if (reader_ != nullptr) {
+                reader_->unpin();
+            }
+        }
+
+        [[nodiscard]] const value_type& operator*() const noexcept {
+            return version_->root;
+        }
+        [[nodiscard]] const value_type* operator->() const noexcept {
+            return &version_->root;
+        }
+        [[nodiscard]] const value_type& root() const noexcept {
+            return version_->root;
+        }
+
+        /// Number of the pinned version (1 for the initial root, +1 per publish()).
+        [[nodiscard]] std::uint64_t version() const noexcept {
+            return version_->number;
+        }
+
+      private:
+        friend class Reader;
+
+        Pin(Reader* reader, const Version* version) noexcept : reader_{reader}, version_{version} {}
+
+        Reader* reader_;
+        const Version* version_;
+    };
+
+    /**
+     * @brief A registered reader, owning one slot of the store. Use one per thread.
+     *
+     * Pins may nest; the epoch is announced by the outermost one. A Reader itself is not
+     * thread-safe, and must not be moved while it has Pins.
+     */
+    class Reader {
+      public:
+        Reader(Reader&& other) noexcept
+            : store_{std::exchange(other.store_, nullptr)}, slot_{other.slot_}, depth_{std::exchange(other.depth_, 0)},
+              version_{std::exchange(other.version_, nullptr)} {}
+        Reader& operator=(Reader&&) = delete;
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        /// Returns the slot; no Pin of this reader may still exist.
+        ~Reader() {
+            if (store_ != nullptr) {
+                store_->slots_[slot_].epoch.store(UNPINNED, std::memory_order_release);
+                store_->slots_[slot_].taken.store(false, std::memory_order_release);
+            }
+        }
+
+        /// Pin the current version. Wait-free.
+        [[nodiscard]] Pin pin() noexcept {
+            if (depth_++ == 0) {
+                Slot& slot = store_->slots_[slot_];
+                slot.epoch.store(store_->epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+                version_ = store_->current_.load(std::memory_order_seq_cst);
+            }
+            return Pin{this, version_};
+        }
+
+      private:
+        friend class ConfigStore;
+
+        Reader(ConfigStore* store, std::size_t slot) noexcept : store_{store}, slot_{slot} {}
+
+        void unpin() noexcept {
+            if (--depth_ == 0) {
+                store_->slots_[slot_].epoch.store(UNPINNED, std::memory_order_release);
+            }
+        }
+
+        ConfigStore* store_;
+        std::size_t slot_;
+        std::size_t depth_ = 0;
+        const Version* version_ = nullptr; // pinned by the outermost Pin
+    };
+
+    /// Store publishing @p initial as version 1, with room for @p max_readers Readers.
+    explicit ConfigStore(value_type initial = value_type{}, std::size_t max_readers = DEFAULT_MAX_READERS)
+        : slot_count_{std::max<std::size_t>(max_readers, 1)}, slots_{std::make_unique<Slot[]>(slot_count_)},
+          current_{new Version{std::move(initial), 1}} {}
+
+    ConfigStore(const ConfigStore&) = delete;
+    ConfigStore& operator=(const ConfigStore&) = delete;
+
+    /// Frees every version; no Reader may still exist.
+    ~ConfigStore() {
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Register a reader.
+     *
+     * @throws std::length_error if all max_readers slots are taken.
+     */
+    [[nodiscard]] Reader reader() {
+        for (std::size_t i = 0; i < slot_count_; ++i) {
+            bool expected = false;
+            if (!slots_[i].taken.load(std::memory_order_relaxed) &&
+                slots_[i].taken.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                return Reader{this, i};
+            }
+        }
+        throw std::length_error{"ConfigStore::reader(): all reader slots are taken"};
+    }
+
+    /// Publish @p root as the next version, returning its number; then reclaim what is safe.
+    std::uint64_t publish(value_type root) {
+        std::unique_ptr<Version> next{new Version{std::move(root), 0}};
+        const std::lock_guard lock{writer_};
+        return publish_locked(std::move(next));
+    }
+
+    /**
+     * @brief Publish a modified copy of the current root: @p edit(value_type&) changes the copy.
+     *
+     * The edit runs under the writer lock, so concurrent writers never lose each other's changes.
+     * If it throws, nothing is published.
+     */
+    template <typename Edit>
+    std::uint64_t update(Edit&& edit) {
+        const std::lock_guard lock{writer_};
+        // Only writers replace the current version, so it cannot be retired under us.
+        std::unique_ptr<Version> next{new Version{current_.load(std::memory_order_relaxed)->root, 0}};
+        std::forward<Edit>(edit)(next->root);
+        return publish_locked(std::move(next));
+    }
+
+    /// Number of the latest published version.
+    [[nodiscard]] std::uint64_t version() const noexcept {
+        return version_.load(std::memory_order_acquire);
+    }
+
+    /// Free the retired versions no reader can still see; returns how many remain retired.
+    std::size_t reclaim() {
+        const std::lock_guard lock{writer_};
+        collect();
+        return retired_.size();
+    }
+
+    /// Number of replaced versions not freed yet.
+    [[nodiscard]] std::size_t retired() const {
+        const std::lock_guard lock{writer_};
+        return retired_.size();
+    }
+
+  private:
+    std::size_t slot_count_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(CACHE_LINE) std::atomic<Version*> current_;
+    std::atomic<std::uint64_t> epoch_{1}; // 0 is UNPINNED
+    std::atomic<std::uint64_t> version_{1};
+    mutable std::mutex writer_; // serializes writers and reclamation
+    std::vector<std::unique_ptr<Version>> retired_;
+
+    std::uint64_t publish_locked(std::unique_ptr<Version> next) {
+        retired_.reserve(retired_.size() + 1); // nothing may throw once the old root is unlinked
+        next->number = version_.load(std::memory_order_relaxed) + 1;
+        std::unique_ptr<Version> old{current_.exchange(next.get(), std::memory_order_seq_cst)};
+        const std::uint64_t number = next.release()->number;
+        version_.store(number, std::memory_order_release);
+        old->retired_at = epoch_.fetch_add(1, std::memory_order_seq_cst);
+        retired_.push_back(std::move(old));
+        collect();
+        return number;
+    }
+
+    // A version retired at epoch E is unreachable for readers announcing a later epoch (they load
+    // the root after the swap), so it can go once every pinned reader announced more than E.
+    void collect() {
+        std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+        for (std::size_t i = 0; i < slot_count_; ++i) {
+            const std::uint64_t epoch = slots_[i].epoch.load(std::memory_order_seq_cst);
+            if (epoch != UNPINNED) {
+                oldest = std::min(oldest, epoch);
+            }
+        }
+        std::erase_if(retired_, [oldest](const std::unique_ptr<Version>& v) { return v->retired_at < oldest; });
+    }
+};
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_CONFIG_STORE_HPP
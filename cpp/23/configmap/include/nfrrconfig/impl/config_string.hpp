@@ -0,0 +1,263 @@
+#ifndef NFRRCONFIG_IMPL_CONFIG_STRING_HPP
+#define NFRRCONFIG_IMPL_CONFIG_STRING_HPP
+
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+namespace nfrr::config {
+
+/**
+ * @brief Immutable string that either owns its characters or views bytes owned elsewhere.
+ *
+ * Owned strings behave like a std::basic_string with the given allocator (including a 15-byte
+ * inline buffer, so short strings do not allocate). A view, created with view(), only records a
+ * pointer and a length: parsers use it to reference unescaped strings in a pinned input buffer
+ * instead of copying them. The viewed bytes must outlive the string and everything it is moved
+ * into; copies are always owning, so a copied value never depends on the source buffer.
+ *
+ * Views are not NUL-terminated, so there is no c_str(); use data() / size() or the implicit
+ * conversion to std::string_view.
+ *
+ * @tparam CharAlloc Allocator for char, used for owned storage.
+ */
+template <typename CharAlloc>
+class BasicConfigString {
+    using alloc_traits = std::allocator_traits<CharAlloc>;
+
+  public:
+    using allocator_type = CharAlloc;
+    using value_type = char;
+    using traits_type = std::char_traits<char>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_reference = const char&;
+    using reference = const char&;
+    using const_iterator = const char*;
+    using iterator = const_iterator;
+
+    static constexpr size_type LOCAL_CAPACITY = 15;
+
+    BasicConfigString() noexcept(noexcept(CharAlloc())) : BasicConfigString(CharAlloc{}) {}
+
+    explicit BasicConfigString(const CharAlloc& alloc) noexcept : data_{local_}, alloc_{alloc} {
+        local_[0] = '\0';
+    }
+
+    /// Owning copy of @p s.
+    BasicConfigString(std::string_view s, const CharAlloc& alloc) : BasicConfigString(alloc) {
+        copy_from(s);
+    }
+
+    /// Owning copy of a contiguous character range (the std::basic_string constructor shape).
+    template <std::contiguous_iterator It>
+    BasicConfigString(It first, It last, const CharAlloc& alloc)
+        : BasicConfigString(std::string_view{std::to_address(first), static_cast<size_type>(last - first)}, alloc) {}
+
+    /**
+     * @brief Non-owning string referencing @p s. @p alloc is kept for copies made later.
+     */
+    [[nodiscard]] static BasicConfigString view(std::string_view s, const CharAlloc& alloc = CharAlloc{}) noexcept {
+        BasicConfigString result{alloc};
+        if (!s.empty()) {
+            result.data_ = s.data();
+            result.size_ = s.size();
+            result.capacity_ = 0;
+        }
+        return result;
+    }
+
+    BasicConfigString(const BasicConfigString& other)
+        : BasicConfigString(other, alloc_traits::select_on_container_copy_construction(other.alloc_)) {}
+
+    BasicConfigString(const BasicConfigString& other, const CharAlloc& alloc) : BasicConfigString(alloc) {
+        copy_from(other);
+    }
+
+    BasicConfigString(BasicConfigString&& other) noexcept : BasicConfigString(other.alloc_) {
+        steal(other);
+    }
+
+    /// Allocator-extended move: views and equal-allocator buffers are taken over, others copied.
+    BasicConfigString(BasicConfigString&& other, const CharAlloc& alloc) : BasicConfigString(alloc) {
+        if (other.is_view() || alloc_ == other.alloc_) {
+            steal(other);
+        }
+        else {
+            copy_from(other);
+        }
+    }
+
+    BasicConfigString& operator=(const BasicConfigString& other) {
+        if (this != &other) {
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                if (alloc_ != other.alloc_) {
+                    release();
+                }
+                alloc_ = other.alloc_;
+            }
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    BasicConfigString& operator=(BasicConfigString&& other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+            release();
+            alloc_ = other.alloc_;
+            steal(other);
+        }
+        else {
+            if (other.is_view() || alloc_ == other.alloc_) {
+                release();
+                steal(other);
+            }
+            else {
+                copy_from(other);
+            }
+        }
+        return *this;
+    }
+
+    ~BasicConfigString() {
+        release();
+    }
+
+    // --------- observers ---------
+
+    [[nodiscard]] const char* data() const noexcept {
+        return data_;
+    }
+    [[nodiscard]] size_type size() const noexcept {
+        return size_;
+    }
+    [[nodiscard]] size_type length() const noexcept {
+        return size_;
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return size_ == 0;
+    }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return data_;
+    }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return data_ + size_;
+    }
+    [[nodiscard]] const char& operator[](size_type pos) const noexcept {
+        return data_[pos];
+    }
+
+    /// True if the characters live outside this string (created by view() and not copied since).
+    [[nodiscard]] bool is_view() const noexcept {
+        return data_ != local_ && capacity_ == 0;
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return alloc_;
+    }
+
+    operator std::string_view() const noexcept { // NOLINT(google-explicit-constructor)
+        return {data_, size_};
+    }
+
+    // --------- modifiers ---------
+
+    /// Replace the content with an owning copy of @p s (keeps the allocator).
+    BasicConfigString& assign(std::string_view s) {
+        copy_from(s);
+        return *this;
+    }
+
+    void clear() noexcept {
+        release();
+        data_ = local_;
+        size_ = 0;
+        local_[0] = '\0';
+    }
+
+    // --------- comparison ---------
+
+    friend bool operator==(const BasicConfigString& a, const BasicConfigString& b) noexcept {
+        return std::string_view{a} == std::string_view{b};
+    }
+    friend bool operator==(const BasicConfigString& a, std::string_view b) noexcept {
+        return std::string_view{a} == b;
+    }
+    friend std::strong_ordering operator<=>(const BasicConfigString& a, const BasicConfigString& b) noexcept {
+        return std::string_view{a} <=> std::string_view{b};
+    }
+    friend std::strong_ordering operator<=>(const BasicConfigString& a, std::string_view b) noexcept {
+        return std::string_view{a} <=> b;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const BasicConfigString& s) {
+        return os << std::string_view{s};
+    }
+
+  private:
+    // data_ points at local_ (short owned), at an allocated buffer (capacity_ > 0), or at
+    // external bytes (capacity_ == 0). capacity_ is only meaningful when data_ != local_.
+    const char* data_;
+    size_type size_ = 0;
+    union {
+        size_type capacity_;
+        char local_[LOCAL_CAPACITY + 1];
+    };
+    [[no_unique_address]] CharAlloc alloc_;
+
+    [[nodiscard]] bool is_heap() const noexcept {
+        return data_ != local_ && capacity_ != 0;
+    }
+
+    void release() noexcept {
+        if (is_heap()) {
+            alloc_traits::deallocate(alloc_, const_cast<char*>(data_), capacity_ + 1); // NOLINT
+        }
+        data_ = local_;
+        size_ = 0;
+    }
+
+    void copy_from(std::string_view s) {
+        if (s.size() <= LOCAL_CAPACITY) {
+            // s may alias our own buffer (self-assignment through a view): move, then terminate.
+            char tmp[LOCAL_CAPACITY + 1];
+            std::memcpy(tmp, s.data(), s.size());
+            release();
+            std::memcpy(local_, tmp, s.size());
+            local_[s.size()] = '\0';
+            size_ = s.size();
+            return;
+        }
+        char* buffer = alloc_traits::allocate(alloc_, s.size() + 1);
+        std::memcpy(buffer, s.data(), s.size());
+        buffer[s.size()] = '\0';
+        release();
+        data_ = buffer;
+        size_ = s.size();
+        capacity_ = s.size();
+    }
+
+    // Take over other's representation (allocators must be interchangeable for heap buffers).
+    // The union is copied whole, so neither member is read while it may be inactive.
+    void steal(BasicConfigString& other) noexcept {
+        std::memcpy(local_, other.local_, sizeof local_);
+        data_ = other.data_ == other.local_ ? local_ : other.data_;
+        size_ = other.size_;
+        other.data_ = other.local_;
+        other.size_ = 0;
+        other.local_[0] = '\0';
+    }
+};
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_CONFIG_STRING_HPP
@@ -0,0 +1,493 @@
+#ifndef NFRRCONFIG_IMPL_CONFIG_WATCHER_HPP
+#define NFRRCONFIG_IMPL_CONFIG_WATCHER_HPP
+
+#if __has_include(<sys/inotify.h>) && __has_include(<sys/eventfd.h>) && __has_include(<poll.h>) &&                  \
+    __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#define NFRRCONFIG_HAS_INOTIFY 1
+#else
+#define NFRRCONFIG_HAS_INOTIFY 0
+#endif
+
+#if NFRRCONFIG_HAS_INOTIFY
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "basic_config_value.hpp"
+#include "bcv_impl.hpp"
+#include "config_store.hpp"
+#include "enums.hpp"
+#include "json_index.hpp"
+#include "json_parse.hpp"
+#include "subtree_pool.hpp"
+
+// Default quiet period (milliseconds) a ConfigWatcher waits for after the last file event.
+#ifndef NFRRCONFIG_WATCH_DEBOUNCE_MS
+#define NFRRCONFIG_WATCH_DEBOUNCE_MS 50
+#endif
+
+namespace nfrr::config {
+
+namespace config_detail {
+// Owning file descriptor.
+class UniqueFd {
+  public:
+    UniqueFd() noexcept = default;
+    explicit UniqueFd(int fd) noexcept : fd_{fd} {}
+
+    UniqueFd(UniqueFd&& other) noexcept : fd_{std::exchange(other.fd_, -1)} {}
+    UniqueFd& operator=(UniqueFd&& other) noexcept {
+        if (this != &other) {
+            reset();
+            fd_ = std::exchange(other.fd_, -1);
+        }
+        return *this;
+    }
+    UniqueFd(const UniqueFd&) = delete;
+    UniqueFd& operator=(const UniqueFd&) = delete;
+
+    ~UniqueFd() {
+        reset();
+    }
+
+    [[nodiscard]] int get() const noexcept {
+        return fd_;
+    }
+
+    void reset() noexcept {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+  private:
+    int fd_{-1};
+};
+
+// Read the whole file at @p path. On failure returns IoError and leaves errno describing the cause.
+inline std::expected<std::string, DocumentError> read_file(const char* path) {
+    const UniqueFd fd{::open(path, O_RDONLY | O_CLOEXEC)}; // NOLINT(cppcoreguidelines-pro-type-vararg)
+    if (fd.get() < 0) {
+        return std::unexpected(DocumentError{ConfigError::IoError, 0});
+    }
+    std::string text;
+    std::size_t size = 0;
+    for (;;) {
+        if (text.size() - size < 4096) {
+            text.resize(std::max<std::size_t>(text.size() * 2, 8192));
+        }
+        const ::ssize_t n = ::read(fd.get(), text.data() + size, text.size() - size);
+        if (n > 0) {
+            size += static_cast<std::size_t>(n);
+        }
+        else if (n == 0) {
+            break;
+        }
+        else if (errno != EINTR) {
+            return std::unexpected(DocumentError{ConfigError::IoError, 0});
+        }
+    }
+    text.resize(size);
+    return text;
+}
+} // namespace config_detail
+
+/**
+ * @brief Keeps a ConfigStore in sync with JSON files, reloading them on inotify events.
+ *
+ * Each watched file becomes one member of the store's root object: watch_file() names it
+ * explicitly, watch_directory() adds every `*.json` file of a directory under its stem, including
+ * files created later. start() loads them all and publishes the result, then a background thread
+ * waits for events; nothing is polled and unchanged files are never opened again.
+ *
+ * Files are watched through their directory, so atomic replacement (write a temporary file, then
+ * rename() it over the old one) is seen like an in-place write. A file is reloaded once it is
+ * closed after writing, renamed or removed. Events are coalesced: after the first one the watcher
+ * waits until no event arrived for the debounce period (at most MAX_DEBOUNCE_PERIODS of them),
+ * then reads and parses each file that changed, once. Files whose parsed tree equals what the store
+ * already holds are dropped; the rest go into a single update() of the store, so readers see
+ * every file of a burst change together. Removed files are erased from the root. A file that
+ * cannot be read or parsed keeps its previous value and is reported as failed. If a reload on
+ * the watcher thread throws (e.g. std::bad_alloc parsing a large file), nothing of it is
+ * published, its files are reported as failed with ConfigError::Aborted and watching goes on.
+ *
+ * The callback receives every reload that changed or failed something. It runs on the watcher
+ * thread after the publish; exceptions it throws are ignored.
+ *
+ * Configure the watcher (watch_file(), watch_directory()) before start(). It uses one of the
+ * store's reader slots and must not outlive the store. Linux only.
+ */
+template <typename Alloc, typename ObjectPolicy = DefaultObjectPolicy>
+class ConfigWatcher {
+  public:
+    using store_type = ConfigStore<Alloc, ObjectPolicy>;
+    using value_type = typename store_type::value_type;
+    using allocator_type = Alloc;
+
+    /// Bound of the coalescing delay after the first event, in debounce periods.
+    static constexpr int MAX_DEBOUNCE_PERIODS = 10;
+
+    /// Outcome of one reload.
+    struct Change {
+        std::uint64_t version = 0;        ///< Version published, 0 if the root did not change.
+        std::vector<std::string> updated; ///< Members added or replaced.
+        std::vector<std::string> removed; ///< Members whose file disappeared.
+        std::vector<std::pair<std::string, DocumentError>> failed; ///< Unreadable or malformed files.
+    };
+
+    using Callback = std::function<void(const Change&)>;
+
+    explicit ConfigWatcher(store_type& store, Callback on_change = {},
+                           std::chrono::milliseconds debounce = std::chrono::milliseconds{NFRRCONFIG_WATCH_DEBOUNCE_MS},
+                           const allocator_type& alloc = allocator_type{})
+        : store_{&store}, on_change_{std::move(on_change)}, debounce_{debounce}, alloc_{alloc} {}
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    ~ConfigWatcher() {
+        stop();
+    }
+
+    /**
+     * @brief Publish the file at @p path as member @p key.
+     *
+     * @throws std::invalid_argument if @p key is taken or @p path names no file.
+     * @throws std::logic_error if the watcher was started.
+     */
+    void watch_file(std::string key, const std::filesystem::path& path) {
+        require_stopped("ConfigWatcher::watch_file()");
+        const std::filesystem::path absolute = std::filesystem::absolute(path);
+        if (!absolute.has_filename()) {
+            throw std::invalid_argument{"ConfigWatcher::watch_file(): path names no file"};
+        }
+        if (keys_.contains(key)) {
+            throw std::invalid_argument{"ConfigWatcher::watch_file(): key is already watched"};
+        }
+        Directory& dir = directory(absolute.parent_path());
+        keys_.insert(key);
+        dir.names.emplace_back(absolute.filename().string(), std::move(key));
+    }
+
+    /**
+     * @brief Publish every regular file of @p dir ending in @p extension, under its stem.
+     *
+     * Hidden files (leading dot, as editors use for temporaries) are skipped, as are files
+     * whose stem is already a member.
+     *
+     * @throws std::logic_error if the watcher was started.
+     */
+    void watch_directory(const std::filesystem::path& dir, std::string_view extension = ".json") {
+        require_stopped("ConfigWatcher::watch_directory()");
+        directory(std::filesystem::absolute(dir)).extension = extension;
+    }
+
+    /**
+     * @brief Load and publish every watched file, then start watching.
+     *
+     * @return What the initial load published and which files failed, or ConfigError::IoError
+     *         (errno set) if inotify is unavailable or a directory cannot be watched; the watcher
+     *         is then left stopped.
+     * @throws std::length_error if the store has no free reader slot.
+     */
+    std::expected<Change, DocumentError> start() {
+        require_stopped("ConfigWatcher::start()");
+        config_detail::UniqueFd inotify{::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)};
+        config_detail::UniqueFd wake{::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)};
+        if (inotify.get() < 0 || wake.get() < 0) {
+            return std::unexpected(DocumentError{ConfigError::IoError, 0});
+        }
+        for (Directory& dir : dirs_) {
+            dir.wd = ::inotify_add_watch(inotify.get(), dir.path.c_str(), WATCH_MASK);
+            if (dir.wd < 0) {
+                return std::unexpected(DocumentError{ConfigError::IoError, 0});
+            }
+        }
+        if (!reader_) {
+            reader_.emplace(store_->reader());
+        }
+        inotify_ = std::move(inotify);
+        wake_ = std::move(wake);
+
+        // Watches are in place, so nothing written from now on is missed.
+        Pending pending;
+        rescan(pending);
+        Change initial = reload(pending);
+        thread_ = std::thread{[this] { run(); }};
+        return initial;
+    }
+
+    /// Stop watching and join the watcher thread. Idempotent.
+    void stop() noexcept {
+        if (thread_.joinable()) {
+            const std::uint64_t one = 1;
+            static_cast<void>(::write(wake_.get(), &one, sizeof one));
+            thread_.join();
+        }
+        inotify_.reset();
+        wake_.reset();
+    }
+
+    [[nodiscard]] bool running() const noexcept {
+        return thread_.joinable();
+    }
+
+  private:
+    static constexpr std::uint32_t WATCH_MASK =
+        IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_ONLYDIR;
+
+    struct Directory {
+        std::filesystem::path path;
+        int wd = -1;
+        std::string extension; // non-empty for watch_directory()
+        std::vector<std::pair<std::string, std::string>> names; // file name -> member key
+    };
+
+    using Pending = std::set<std::pair<std::size_t, std::string>>; // (directory, file name)
+
+    store_type* store_;
+    Callback on_change_;
+    std::chrono::milliseconds debounce_;
+    allocator_type alloc_;
+    std::vector<Directory> dirs_;
+    std::unordered_set<std::string> keys_;
+    std::optional<typename store_type::Reader> reader_;
+    config_detail::UniqueFd inotify_;
+    config_detail::UniqueFd wake_;
+    std::thread thread_;
+
+    void require_stopped(const char* where) const {
+        if (thread_.joinable()) {
+            throw std::logic_error{std::string{where} + ": the watcher is running"};
+        }
+    }
+
+    Directory& directory(std::filesystem::path path) {
+        path = path.lexically_normal();
+        for (Directory& dir : dirs_) {
+            if (dir.path == path) {
+                return dir;
+            }
+        }
+        Directory& dir = dirs_.emplace_back();
+        dir.path = std::move(path);
+        return dir;
+    }
+
+    static const std::string* key_of(const Directory& dir, std::string_view name) noexcept {
+        for (const auto& [file, key] : dir.names) {
+            if (file == name) {
+                return &key;
+            }
+        }
+        return nullptr;
+    }
+
+    // Queue @p name if it is (or, in a watched directory, may become) a member.
+    void touch(Pending& pending, std::size_t index, std::string_view name) {
+        const Directory& dir = dirs_[index];
+        if (key_of(dir, name) != nullptr ||
+            (!dir.extension.empty() && name.size() > dir.extension.size() && !name.starts_with('.') &&
+             name.ends_with(dir.extension))) {
+            pending.emplace(index, name);
+        }
+    }
+
+    // Queue every member and every candidate file, e.g. after the event queue overflowed.
+    void rescan(Pending& pending) {
+        for (std::size_t i = 0; i < dirs_.size(); ++i) {
+            for (const auto& entry : dirs_[i].names) {
+                pending.emplace(i, entry.first);
+            }
+            if (!dirs_[i].extension.empty()) {
+                std::error_code ec;
+                for (const auto& entry : std::filesystem::directory_iterator{dirs_[i].path, ec}) {
+                    if (entry.is_regular_file(ec)) {
+                        touch(pending, i, entry.path().filename().string());
+                    }
+                }
+            }
+        }
+    }
+
+    static const value_type* member(const value_type& root, std::string_view key) {
+        if (!root.is_object()) {
+            return nullptr;
+        }
+        auto it = root.find(key);
+        return it == root.as_object().end() ? nullptr : &it->second;
+    }
+
+    // Read and parse the pending files, then publish what changed in one update().
+    Change reload(const Pending& pending) {
+        Change change;
+        std::vector<std::pair<std::string, value_type>> replaced;
+        {
+            const auto pinned = reader_->pin();
+            for (const auto& [index, name] : pending) {
+                Directory& dir = dirs_[index];
+                const std::string* key = key_of(dir, name);
+                const auto text = config_detail::read_file((dir.path / name).c_str());
+                if (!text) {
+                    if (errno != ENOENT) {
+                        if (key != nullptr) {
+                            change.failed.emplace_back(*key, text.error());
+                        }
+                    }
+                    else if (key != nullptr && member(*pinned, *key) != nullptr) {
+                        change.removed.push_back(*key);
+                    }
+                    continue;
+                }
+                if (key == nullptr) { // a new file in a watched directory
+                    std::string stem = std::filesystem::path{name}.stem().string();
+                    if (!keys_.insert(stem).second) {
+                        continue;
+                    }
+                    key = &dir.names.emplace_back(name, std::move(stem)).second;
+                }
+                auto parsed = parse_json<Alloc, ObjectPolicy>(*text, alloc_);
+                if (!parsed) {
+                    change.failed.emplace_back(*key, parsed.error());
+                }
+                else if (const value_type* old = member(*pinned, *key);
+                         old == nullptr || !config_detail::same_subtree(*old, std::as_const(*parsed))) {
+                    change.updated.push_back(*key);
+                    replaced.emplace_back(*key, std::move(*parsed));
+                }
+            }
+        }
+        if (!replaced.empty() || !change.removed.empty()) {
+            change.version = store_->update([&](value_type& root) {
+                root.ensure_object();
+                for (auto& [key, value] : replaced) {
+                    root[std::string_view{key}] = std::move(value);
+                }
+                for (const std::string& key : change.removed) {
+                    auto& object = root.as_object();
+                    if (auto it = root.find(key); it != object.end()) {
+                        object.erase(it);
+                    }
+                }
+            });
+        }
+        return change;
+    }
+
+    // Report for a reload that threw: every pending file that has a member failed. Best effort, as
+    // it runs on the watcher thread where nothing may escape.
+    Change aborted(const Pending& pending) noexcept {
+        Change change;
+        try {
+            for (const auto& [index, name] : pending) {
+                if (const std::string* key = key_of(dirs_[index], name); key != nullptr) {
+                    change.failed.emplace_back(*key, DocumentError{ConfigError::Aborted, 0});
+                }
+            }
+        }
+        catch (...) { // NOLINT(bugprone-empty-catch): out of memory, report what fits
+        }
+        return change;
+    }
+
+    // Move the queued events into @p pending.
+    void drain(Pending& pending) {
+        alignas(inotify_event) char buffer[4096];
+        for (;;) {
+            const ::ssize_t n = ::read(inotify_.get(), buffer, sizeof buffer);
+            if (n <= 0) {
+                return; // EAGAIN: drained
+            }
+            for (std::size_t offset = 0; offset < static_cast<std::size_t>(n);) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+                if ((event->mask & IN_Q_OVERFLOW) != 0) {
+                    rescan(pending);
+                    continue;
+                }
+                for (std::size_t i = 0; i < dirs_.size(); ++i) {
+                    if (dirs_[i].wd == event->wd && event->len > 0) {
+                        touch(pending, i, std::string_view{event->name});
+                    }
+                }
+            }
+        }
+    }
+
+    void run() {
+        using Clock = std::chrono::steady_clock;
+        Pending pending;
+        Clock::time_point first{};
+        Clock::time_point last{};
+        for (;;) {
+            int timeout = -1;
+            if (!pending.empty()) {
+                const auto deadline = std::min(last + debounce_, first + MAX_DEBOUNCE_PERIODS * debounce_);
+                const auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+                timeout = static_cast<int>(std::max<std::chrono::milliseconds::rep>(left.count(), 0));
+            }
+            pollfd fds[2] = {{wake_.get(), POLLIN, 0}, {inotify_.get(), POLLIN, 0}};
+            const int ready = ::poll(fds, 2, timeout);
+            if (ready < 0 && errno != EINTR) {
+                return;
+            }
+            if ((fds[0].revents & POLLIN) != 0) {
+                return;
+            }
+            if (ready > 0 && (fds[1].revents & POLLIN) != 0) {
+                const bool was_idle = pending.empty();
+                drain(pending);
+                last = Clock::now();
+                if (was_idle) {
+                    first = last;
+                }
+            }
+            else if (ready == 0 && !pending.empty()) {
+                Change change;
+                try {
+                    change = reload(pending);
+                }
+                catch (...) {
+                    change = aborted(pending);
+                }
+                pending.clear();
+                if (on_change_ && (change.version != 0 || !change.failed.empty())) {
+                    try {
+                        on_change_(change);
+                    }
+                    catch (...) { // NOLINT(bugprone-empty-catch): documented as ignored
+                    }
+                }
+            }
+        }
+    }
+};
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_HAS_INOTIFY
+
+#endif // NFRRCONFIG_IMPL_CONFIG_WATCHER_HPP
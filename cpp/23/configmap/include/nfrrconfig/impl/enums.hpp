@@ -7,6 +7,9 @@ namespace nfrr::config {
 // Enum describing the high-level kind of the stored value.
 enum class ConfigValueKind : std::uint8_t { Null, Boolean, Integer, Floating, String, Array, Object };
 
+// Operation of a patch entry, as named by RFC 6902 (JSON Patch).
+enum class PatchOp : std::uint8_t { Add, Remove, Replace, Move, Copy, Test };
+
 /**
  * @brief Error codes used by safe value accessors such as try_get().
  */
@@ -16,7 +19,18 @@ enum class ConfigError : std::uint8_t {
     OutOfRange,     ///< Numeric conversion would overflow or underflow.
     FractionalLoss, ///< Floating-to-integer conversion would lose fraction.
     ParseError,     ///< String-to-number conversion failed.
-    KeyNotFound     ///< Requested key does not exist (for object access).
+    KeyNotFound,    ///< Requested key does not exist (for object access).
+    IndexNotFound,  ///< Requested array index is past the end of the array.
+    InvalidPath,    ///< Path expression is malformed.
+    SyntaxError,    ///< Document is not well-formed (unexpected character or token).
+    UnexpectedEnd,  ///< Document ended before the current value was complete.
+    InvalidNumber,  ///< Malformed number literal in a document.
+    InvalidString,  ///< Malformed string in a document (bad escape, control character, lone surrogate).
+    DepthExceeded,  ///< Document nests arrays/objects deeper than the parser limit.
+    Cancelled,      ///< A streaming handler asked the reader to stop.
+    IoError,        ///< A file could not be opened, inspected or mapped (errno has the cause).
+    TestFailed,     ///< A patch test operation found a different value.
+    Aborted         ///< An exception (e.g. std::bad_alloc) interrupted the operation; nothing was applied.
 };
 } // namespace nfrr::config
 
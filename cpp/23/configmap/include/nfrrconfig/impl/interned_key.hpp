@@ -0,0 +1,443 @@
+#ifndef NFRRCONFIG_IMPL_INTERNED_KEY_HPP
+#define NFRRCONFIG_IMPL_INTERNED_KEY_HPP
+
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nfrr::config {
+
+class KeyPool;
+
+template <typename CharAlloc>
+class BasicInternedKey;
+
+namespace config_detail {
+// Header of an interned key; the characters (NUL-terminated) follow it.
+struct KeyEntry {
+    const KeyPool* pool;                  // pool holding the entry, null for a standalone entry
+    std::pmr::memory_resource* resource;  // standalone entries: resource they came from (null: stateless)
+    std::uint32_t size;
+    std::uint32_t hash; // same 32-bit hash BasicConfigObject uses for its index
+
+    [[nodiscard]] const char* data() const noexcept {
+        return reinterpret_cast<const char*>(this + 1); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+    [[nodiscard]] std::string_view view() const noexcept {
+        return {data(), size};
+    }
+
+    // Number of KeyEntry-sized units holding a header plus @p size characters and the NUL.
+    static std::size_t units_for(std::size_t size) {
+        if (size > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error{"interned key longer than 4 GiB"};
+        }
+        return 1 + (size + sizeof(KeyEntry)) / sizeof(KeyEntry);
+    }
+
+    static std::uint32_t hash_of(std::string_view key) noexcept {
+        return static_cast<std::uint32_t>(std::hash<std::string_view>{}(key));
+    }
+
+    // Placement-initialize header and characters in a block of units_for(key.size()) units.
+    static KeyEntry* init(KeyEntry* block, std::string_view key, std::uint32_t hash, const KeyPool* pool,
+                          std::pmr::memory_resource* resource) noexcept {
+        auto* entry = std::construct_at(block, KeyEntry{pool, resource, static_cast<std::uint32_t>(key.size()), hash});
+        auto* chars = reinterpret_cast<char*>(entry + 1); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (!key.empty()) {
+            std::memcpy(chars, key.data(), key.size());
+        }
+        chars[key.size()] = '\0';
+        return entry;
+    }
+};
+} // namespace config_detail
+
+/**
+ * @brief Memory resource that also interns object keys: each distinct key is stored once.
+ *
+ * Allocations are forwarded to the upstream resource unchanged. Values whose allocator uses a
+ * KeyPool (directly, e.g. BasicConfigValue<PmrByteAllocator, InternedKeyPolicy<>>, or through a
+ * BasicConfigDocument with that policy) store their object keys as 8-byte BasicInternedKey
+ * handles into the pool, so a key repeated across thousands of sibling objects costs one copy.
+ * Keys interned up front with intern() make object lookups handle compares.
+ *
+ * Interned keys are never freed individually: the pool keeps them until it is destroyed or
+ * clear()ed, which must not happen while values using them are alive. Not thread-safe.
+ */
+class KeyPool : public std::pmr::memory_resource {
+  public:
+    explicit KeyPool(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : upstream_{upstream} {}
+
+    KeyPool(const KeyPool&) = delete;
+    KeyPool& operator=(const KeyPool&) = delete;
+
+    ~KeyPool() override {
+        clear();
+    }
+
+    /// The entry for @p key, adding it on first use.
+    const config_detail::KeyEntry* intern_entry(std::string_view key) {
+        const std::uint32_t hash = config_detail::KeyEntry::hash_of(key);
+        if ((count_ + 1) * 2 > capacity_) {
+            grow();
+        }
+        const std::size_t mask = capacity_ - 1;
+        std::size_t i = hash & mask;
+        for (; slots_[i] != nullptr; i = (i + 1) & mask) {
+            if (slots_[i]->hash == hash && slots_[i]->view() == key) {
+                return slots_[i];
+            }
+        }
+        const std::size_t units = config_detail::KeyEntry::units_for(key.size());
+        void* block = upstream_->allocate(units * sizeof(config_detail::KeyEntry), alignof(config_detail::KeyEntry));
+        auto* entry = static_cast<config_detail::KeyEntry*>(block);
+        slots_[i] = config_detail::KeyEntry::init(entry, key, hash, this, nullptr);
+        ++count_;
+        return slots_[i];
+    }
+
+    /// A handle for @p key, for lookups that compare handles instead of characters.
+    [[nodiscard]] BasicInternedKey<std::pmr::polymorphic_allocator<char>> intern(std::string_view key);
+
+    /// Number of distinct keys interned.
+    [[nodiscard]] std::size_t size() const noexcept {
+        return count_;
+    }
+
+    /// Return every interned key to the upstream resource. No key handle may be used afterwards.
+    void clear() noexcept {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (slots_[i] != nullptr) {
+                upstream_->deallocate(slots_[i], config_detail::KeyEntry::units_for(slots_[i]->size) *
+                                                     sizeof(config_detail::KeyEntry),
+                                      alignof(config_detail::KeyEntry));
+            }
+        }
+        if (slots_ != nullptr) {
+            upstream_->deallocate(slots_, capacity_ * sizeof(Slot), alignof(Slot));
+        }
+        slots_ = nullptr;
+        capacity_ = 0;
+        count_ = 0;
+    }
+
+    /// Forget every interned key without deallocating, for an upstream released wholesale.
+    void discard() noexcept {
+        slots_ = nullptr;
+        capacity_ = 0;
+        count_ = 0;
+    }
+
+    [[nodiscard]] std::pmr::memory_resource* upstream_resource() const noexcept {
+        return upstream_;
+    }
+
+  private:
+    using Slot = config_detail::KeyEntry*;
+
+    std::pmr::memory_resource* upstream_;
+    Slot* slots_ = nullptr; // open addressing, load factor <= 1/2
+    std::size_t capacity_ = 0;
+    std::size_t count_ = 0;
+
+    void grow() {
+        const std::size_t capacity = capacity_ == 0 ? 64 : capacity_ * 2;
+        auto* slots = static_cast<Slot*>(upstream_->allocate(capacity * sizeof(Slot), alignof(Slot)));
+        std::uninitialized_fill_n(slots, capacity, nullptr);
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (Slot entry = slots_[i]; entry != nullptr) {
+                std::size_t j = entry->hash & (capacity - 1);
+                while (slots[j] != nullptr) {
+                    j = (j + 1) & (capacity - 1);
+                }
+                slots[j] = entry;
+            }
+        }
+        if (slots_ != nullptr) {
+            upstream_->deallocate(slots_, capacity_ * sizeof(Slot), alignof(Slot));
+        }
+        slots_ = slots;
+        capacity_ = capacity;
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        upstream_->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+/**
+ * @brief Immutable object key held as a single pointer to a shared, hashed entry.
+ *
+ * Constructed with a polymorphic_allocator whose resource is a KeyPool, the key is interned in
+ * that pool: copies share the entry and equal keys of the same pool have equal handles. With any
+ * other resource, or a stateless allocator, the key owns a standalone entry (header plus
+ * characters in one allocation). Copies and allocator-extended moves re-intern into the target
+ * allocator's pool, so every key of an object on a pool belongs to that pool, which is what lets
+ * BasicConfigObject::find() compare handles for a key of the same pool.
+ *
+ * @tparam CharAlloc std::pmr::polymorphic_allocator<char> or a stateless allocator.
+ */
+template <typename CharAlloc>
+class BasicInternedKey {
+    static constexpr bool PMR = std::is_same_v<CharAlloc, std::pmr::polymorphic_allocator<char>>;
+    static_assert(PMR || std::allocator_traits<CharAlloc>::is_always_equal::value,
+                  "BasicInternedKey supports polymorphic_allocator and stateless allocators");
+
+    using Entry = config_detail::KeyEntry;
+    using entry_allocator = typename std::allocator_traits<CharAlloc>::template rebind_alloc<Entry>;
+    using entry_traits = std::allocator_traits<entry_allocator>;
+
+  public:
+    using allocator_type = CharAlloc;
+    using value_type = char;
+    using size_type = std::size_t;
+    using const_iterator = const char*;
+    using iterator = const_iterator;
+
+    /// The empty key, without an entry.
+    BasicInternedKey() noexcept = default;
+
+    BasicInternedKey(std::string_view key, const CharAlloc& alloc) : entry_{make_entry(key, alloc)} {}
+
+    /// Key from a contiguous character range (the std::basic_string constructor shape).
+    template <std::contiguous_iterator It>
+    BasicInternedKey(It first, It last, const CharAlloc& alloc)
+        : BasicInternedKey(std::string_view{std::to_address(first), static_cast<size_type>(last - first)}, alloc) {}
+
+    /// Copies share the entry when it is interned (a KeyPool outlives its keys anyway).
+    BasicInternedKey(const BasicInternedKey& other)
+        : entry_{other.pool() != nullptr
+                     ? other.entry_
+                     : make_entry(other.view(), std::allocator_traits<CharAlloc>::select_on_container_copy_construction(
+                                                    other.get_allocator()))} {}
+
+    BasicInternedKey(const BasicInternedKey& other, const CharAlloc& alloc) : entry_{rehome(other.entry_, alloc)} {}
+
+    BasicInternedKey(BasicInternedKey&& other) noexcept : entry_{std::exchange(other.entry_, nullptr)} {}
+
+    BasicInternedKey(BasicInternedKey&& other, const CharAlloc& alloc) : entry_{nullptr} {
+        if (belongs_to(other.entry_, alloc)) {
+            entry_ = std::exchange(other.entry_, nullptr);
+        }
+        else {
+            entry_ = rehome(other.entry_, alloc);
+        }
+    }
+
+    // An empty key without an entry has no allocator of its own and takes the source's; this keeps
+    // keys shifted through moved-from slots (vector insert/erase) in their container's pool.
+    BasicInternedKey& operator=(const BasicInternedKey& other) {
+        if (this != &other) {
+            const Entry* next = rehome(other.entry_, entry_ != nullptr ? get_allocator() : other.get_allocator());
+            release();
+            entry_ = next;
+        }
+        return *this;
+    }
+
+    BasicInternedKey& operator=(BasicInternedKey&& other) noexcept(!PMR) {
+        if (this != &other) {
+            if (entry_ == nullptr || belongs_to(other.entry_, get_allocator())) {
+                release();
+                entry_ = std::exchange(other.entry_, nullptr);
+            }
+            else {
+                *this = std::as_const(other);
+            }
+        }
+        return *this;
+    }
+
+    ~BasicInternedKey() {
+        release();
+    }
+
+    // --------- observers ---------
+
+    [[nodiscard]] const char* data() const noexcept {
+        return entry_ != nullptr ? entry_->data() : "";
+    }
+    [[nodiscard]] size_type size() const noexcept {
+        return entry_ != nullptr ? entry_->size : 0;
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return data();
+    }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return data() + size();
+    }
+
+    /// Hash of the characters, computed once when the entry was created.
+    [[nodiscard]] std::uint32_t hash() const noexcept {
+        return entry_ != nullptr ? entry_->hash : Entry::hash_of({});
+    }
+
+    /// The pool holding this key, or nullptr if it owns a standalone entry.
+    [[nodiscard]] const KeyPool* pool() const noexcept {
+        return entry_ != nullptr ? entry_->pool : nullptr;
+    }
+
+    /// Identity of the entry: two keys of one pool are equal exactly when their handles are.
+    [[nodiscard]] const void* handle() const noexcept {
+        return entry_;
+    }
+
+    /// True if keys created with @p alloc are interned in the same pool as this key.
+    template <typename A>
+    [[nodiscard]] bool interned_with(const A& alloc) const noexcept {
+        if constexpr (requires { alloc.resource(); }) {
+            return pool() != nullptr && static_cast<const std::pmr::memory_resource*>(pool()) == alloc.resource();
+        }
+        else {
+            return false;
+        }
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        if constexpr (PMR) {
+            if (entry_ != nullptr && entry_->pool != nullptr) {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+                return allocator_type{const_cast<KeyPool*>(entry_->pool)};
+            }
+            return allocator_type{entry_ != nullptr ? entry_->resource : std::pmr::get_default_resource()};
+        }
+        else {
+            return allocator_type{};
+        }
+    }
+
+    operator std::string_view() const noexcept { // NOLINT(google-explicit-constructor)
+        return {data(), size()};
+    }
+
+    // --------- comparison ---------
+
+    friend bool operator==(const BasicInternedKey& a, const BasicInternedKey& b) noexcept {
+        if (a.entry_ == b.entry_) {
+            return true;
+        }
+        if (a.pool() != nullptr && a.pool() == b.pool()) {
+            return false;
+        }
+        return a.view() == b.view();
+    }
+    friend bool operator==(const BasicInternedKey& a, std::string_view b) noexcept {
+        return a.view() == b;
+    }
+    friend std::strong_ordering operator<=>(const BasicInternedKey& a, const BasicInternedKey& b) noexcept {
+        return a.view() <=> b.view();
+    }
+    friend std::strong_ordering operator<=>(const BasicInternedKey& a, std::string_view b) noexcept {
+        return a.view() <=> b;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const BasicInternedKey& key) {
+        return os << key.view();
+    }
+
+  private:
+    const Entry* entry_ = nullptr; // null: empty key (default-constructed or moved from)
+
+    [[nodiscard]] std::string_view view() const noexcept {
+        return {data(), size()};
+    }
+
+    static KeyPool* pool_of(const CharAlloc& alloc) noexcept {
+        if constexpr (PMR) {
+            return dynamic_cast<KeyPool*>(alloc.resource());
+        }
+        else {
+            return nullptr;
+        }
+    }
+
+    static bool belongs_to(const Entry* entry, const CharAlloc& alloc) noexcept {
+        if (entry == nullptr) {
+            return true;
+        }
+        if constexpr (PMR) {
+            if (entry->pool != nullptr) {
+                return static_cast<const std::pmr::memory_resource*>(entry->pool) == alloc.resource();
+            }
+            return entry->resource == alloc.resource() && pool_of(alloc) == nullptr;
+        }
+        else {
+            return true;
+        }
+    }
+
+    static const Entry* rehome(const Entry* entry, const CharAlloc& alloc) {
+        if (entry != nullptr && entry->pool != nullptr && belongs_to(entry, alloc)) {
+            return entry;
+        }
+        return make_entry(entry != nullptr ? entry->view() : std::string_view{}, alloc);
+    }
+
+    static const Entry* make_entry(std::string_view key, const CharAlloc& alloc) {
+        if (KeyPool* pool = pool_of(alloc)) {
+            return pool->intern_entry(key);
+        }
+        const std::size_t units = Entry::units_for(key.size());
+        entry_allocator entries{alloc};
+        Entry* block = entry_traits::allocate(entries, units);
+        std::pmr::memory_resource* resource = nullptr;
+        if constexpr (PMR) {
+            resource = alloc.resource();
+        }
+        return Entry::init(block, key, Entry::hash_of(key), nullptr, resource);
+    }
+
+    void release() noexcept {
+        if (entry_ == nullptr || entry_->pool != nullptr) {
+            entry_ = nullptr;
+            return;
+        }
+        entry_allocator entries = [this] {
+            if constexpr (PMR) {
+                return entry_allocator{entry_->resource};
+            }
+            else {
+                return entry_allocator{};
+            }
+        }();
+        entry_traits::deallocate(entries, const_cast<Entry*>(entry_), Entry::units_for(entry_->size)); // NOLINT
+        entry_ = nullptr;
+    }
+};
+
+/// Key type of pmr values with InternedKeyPolicy.
+using InternedKey = BasicInternedKey<std::pmr::polymorphic_allocator<char>>;
+
+inline InternedKey KeyPool::intern(std::string_view key) {
+    return InternedKey{key, std::pmr::polymorphic_allocator<char>{this}};
+}
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_INTERNED_KEY_HPP
@@ -0,0 +1,196 @@
+#ifndef NFRRCONFIG_IMPL_JSON_FD_SINK_HPP
+#define NFRRCONFIG_IMPL_JSON_FD_SINK_HPP
+
+#if __has_include(<sys/uio.h>) && __has_include(<unistd.h>)
+#define NFRRCONFIG_HAS_WRITEV 1
+#else
+#define NFRRCONFIG_HAS_WRITEV 0
+#endif
+
+#if NFRRCONFIG_HAS_WRITEV
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <vector>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "basic_config_value.hpp"
+#include "enums.hpp"
+#include "json_index.hpp"
+#include "json_write.hpp"
+
+namespace nfrr::config {
+
+/**
+ * @brief JsonRefSink that gathers output as iovecs and writes it to a file descriptor with writev.
+ *
+ * Copied output (punctuation, numbers, short strings) goes into fixed-size chunks; long runs
+ * passed to append_ref() are referenced in place. Once flush_bytes are pending the batch is
+ * written and the chunks are reused, so memory stays bounded by flush_bytes plus one chunk
+ * however large the document is. Partial writes (pipes, sockets) and EINTR are handled.
+ *
+ * The first write error is latched: later output is dropped, and error() reports the errno.
+ */
+class JsonFdSink {
+  public:
+    static constexpr std::size_t CHUNK_SIZE = std::size_t{64} << 10;
+    static constexpr std::size_t DEFAULT_FLUSH_BYTES = std::size_t{1} << 20;
+
+    /// Write to @p fd (not owned). Pending output is written once it reaches @p flush_bytes.
+    explicit JsonFdSink(int fd, std::size_t flush_bytes = DEFAULT_FLUSH_BYTES)
+        : fd_{fd}, flush_bytes_{std::max<std::size_t>(flush_bytes, 1)} {}
+
+    JsonFdSink(const JsonFdSink&) = delete;
+    JsonFdSink& operator=(const JsonFdSink&) = delete;
+
+    /// Buffer a copy of [p, p + n).
+    void append(const char* p, std::size_t n) {
+        while (n != 0 && error_ == 0) {
+            if (chunk_used_ == CHUNK_SIZE || chunks_.empty()) {
+                next_chunk();
+            }
+            char* dst = chunks_[chunk_].get() + chunk_used_;
+            const std::size_t take = std::min(n, CHUNK_SIZE - chunk_used_);
+            std::memcpy(dst, p, take);
+            chunk_used_ += take;
+            if (!iov_.empty() && static_cast<char*>(iov_.back().iov_base) + iov_.back().iov_len == dst) {
+                iov_.back().iov_len += take;
+            }
+            else {
+                iov_.push_back(iovec{dst, take});
+            }
+            pending_ += take;
+            p += take;
+            n -= take;
+            maybe_flush();
+        }
+    }
+
+    /// Queue [p, p + n) without copying; the bytes must stay valid until the next flush().
+    void append_ref(const char* p, std::size_t n) {
+        if (n == 0 || error_ != 0) {
+            return;
+        }
+        iov_.push_back(iovec{const_cast<char*>(p), n}); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+        pending_ += n;
+        maybe_flush();
+    }
+
+    /**
+     * @brief Write everything pending.
+     *
+     * @return false if this or an earlier write failed (see error()).
+     */
+    bool flush() {
+        std::size_t first = 0;
+        while (first < iov_.size() && error_ == 0) {
+            const auto count = static_cast<int>(std::min<std::size_t>(iov_.size() - first, MAX_IOV));
+            const ssize_t n = ::writev(fd_, iov_.data() + first, count);
+            if (n < 0) {
+                if (errno != EINTR) {
+                    error_ = errno;
+                }
+                continue;
+            }
+            if (n == 0) {
+                error_ = EIO;
+                break;
+            }
+            written_ += static_cast<std::size_t>(n);
+            // Skip the iovecs written completely and trim a partially written one.
+            auto left = static_cast<std::size_t>(n);
+            while (left != 0 && left >= iov_[first].iov_len) {
+                left -= iov_[first].iov_len;
+                ++first;
+            }
+            if (left != 0) {
+                iov_[first].iov_base = static_cast<char*>(iov_[first].iov_base) + left;
+                iov_[first].iov_len -= left;
+            }
+        }
+        iov_.clear();
+        pending_ = 0;
+        chunk_ = 0;
+        chunk_used_ = chunks_.empty() ? CHUNK_SIZE : 0;
+        return error_ == 0;
+    }
+
+    /// errno of the first failed write, 0 if none.
+    [[nodiscard]] int error() const noexcept {
+        return error_;
+    }
+
+    /// Bytes written to the descriptor so far.
+    [[nodiscard]] std::size_t bytes_written() const noexcept {
+        return written_;
+    }
+
+  private:
+#ifdef IOV_MAX
+    static constexpr std::size_t MAX_IOV = IOV_MAX;
+#else
+    static constexpr std::size_t MAX_IOV = 1024;
+#endif
+
+    int fd_;
+    std::size_t flush_bytes_;
+    std::vector<std::unique_ptr<char[]>> chunks_; // reused across flushes
+    std::size_t chunk_ = 0;                       // chunk being filled
+    std::size_t chunk_used_ = CHUNK_SIZE;         // bytes used in chunks_[chunk_] (full: none yet)
+    std::vector<iovec> iov_;
+    std::size_t pending_ = 0;
+    std::size_t written_ = 0;
+    int error_ = 0;
+
+    void next_chunk() {
+        if (!chunks_.empty()) {
+            ++chunk_;
+        }
+        if (chunk_ == chunks_.size()) {
+            chunks_.push_back(std::make_unique_for_overwrite<char[]>(CHUNK_SIZE));
+        }
+        chunk_used_ = 0;
+    }
+
+    void maybe_flush() {
+        if (pending_ >= flush_bytes_ || iov_.size() >= MAX_IOV) {
+            flush();
+        }
+    }
+};
+
+/**
+ * @brief Serialize @p value as JSON straight to the file descriptor @p fd with writev.
+ *
+ * The document is never assembled in memory: output is gathered into a JsonFdSink (bounded by
+ * @p flush_bytes) and long string payloads are written from the value's own storage. The
+ * descriptor is neither closed nor synced.
+ *
+ * @return Bytes written, or ConfigError::IoError with the number of bytes written before the
+ *         failure as offset (errno holds the cause).
+ */
+template <typename Alloc, typename ObjectPolicy>
+[[nodiscard]] std::expected<std::size_t, DocumentError>
+to_json_fd(const BasicConfigValue<Alloc, ObjectPolicy>& value, int fd, const JsonWriteOptions& options = {},
+           std::size_t flush_bytes = JsonFdSink::DEFAULT_FLUSH_BYTES) {
+    JsonFdSink sink{fd, flush_bytes};
+    to_json(value, sink, options);
+    if (!sink.flush()) {
+        errno = sink.error();
+        return std::unexpected(DocumentError{ConfigError::IoError, sink.bytes_written()});
+    }
+    return sink.bytes_written();
+}
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_HAS_WRITEV
+
+#endif // NFRRCONFIG_IMPL_JSON_FD_SINK_HPP
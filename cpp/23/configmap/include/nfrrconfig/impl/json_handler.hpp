@@ -0,0 +1,167 @@
+#ifndef NFRRCONFIG_IMPL_JSON_HANDLER_HPP
+#define NFRRCONFIG_IMPL_JSON_HANDLER_HPP
+
+#include <concepts>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace nfrr::config {
+
+/**
+ * @brief Event sink for the streaming JSON readers (read_json / read_json_indexed).
+ *
+ * Events arrive in document order; every callback returns whether to continue, and returning
+ * false stops the read with ConfigError::Cancelled. Strings and keys passed as string_view are
+ * only valid for the duration of the call (they may point into the reader's scratch buffer).
+ * Object members arrive as on_key followed by the member's value events.
+ */
+template <typename H>
+concept JsonHandler = requires(H& h, bool b, std::int64_t i, double d, std::string_view s) {
+    { h.on_null() } -> std::convertible_to<bool>;
+    { h.on_bool(b) } -> std::convertible_to<bool>;
+    { h.on_int64(i) } -> std::convertible_to<bool>;
+    { h.on_double(d) } -> std::convertible_to<bool>;
+    { h.on_string(s) } -> std::convertible_to<bool>;
+    { h.on_key(s) } -> std::convertible_to<bool>;
+    { h.on_start_object() } -> std::convertible_to<bool>;
+    { h.on_end_object() } -> std::convertible_to<bool>;
+    { h.on_start_array() } -> std::convertible_to<bool>;
+    { h.on_end_array() } -> std::convertible_to<bool>;
+};
+
+/**
+ * @brief Stock JsonHandler that materializes the events into a BasicConfigValue.
+ *
+ * This is what parse_json() runs on top of the readers. Nested values are created through the
+ * parent's allocator (set_* helpers, the object's try_emplace), so a pmr root keeps the whole
+ * tree on its memory resource. Duplicate keys keep their first position and take the last value.
+ */
+template <typename Value>
+class JsonDomBuilder {
+  public:
+    /// Build into @p root, replacing its current content. @p root must outlive the builder.
+    explicit JsonDomBuilder(Value& root) : root_{&root} {}
+
+    /**
+     * @brief Build into @p root, referencing strings that lie inside @p pinned_source.
+     *
+     * If Value's string type supports views (ZeroCopyStringPolicy), keys and strings delivered as
+     * slices of @p pinned_source are stored as views instead of copies; strings the reader had to
+     * unescape are still copied. @p pinned_source must outlive the built tree.
+     */
+    JsonDomBuilder(Value& root, std::string_view pinned_source) : root_{&root}, pinned_{pinned_source} {}
+
+    bool on_null() {
+        slot().set_null();
+        return true;
+    }
+
+    bool on_bool(bool value) {
+        slot().set_bool(value);
+        return true;
+    }
+
+    bool on_int64(std::int64_t value) {
+        slot().set_integer(value);
+        return true;
+    }
+
+    bool on_double(double value) {
+        slot().set_floating(value);
+        return true;
+    }
+
+    bool on_string(std::string_view value) {
+        if (is_pinned(value)) {
+            slot().set_string_view(value);
+        }
+        else {
+            slot().set_string(value);
+        }
+        return true;
+    }
+
+    bool on_key(std::string_view key) {
+        auto& object = open_.back().value->as_object();
+        if constexpr (KEY_VIEWS) {
+            if (is_pinned(key)) {
+                member_ = &object.try_emplace(String::view(key, CharAlloc{object.get_allocator()})).first->second;
+                return true;
+            }
+        }
+        member_ = &object.try_emplace(key).first->second;
+        return true;
+    }
+
+    bool on_start_object() {
+        Value& target = slot();
+        target.set_object();
+        open_.push_back(Frame{&target, false});
+        return true;
+    }
+
+    bool on_end_object() {
+        open_.pop_back();
+        return true;
+    }
+
+    bool on_start_array() {
+        Value& target = slot();
+        target.set_array();
+        open_.push_back(Frame{&target, true});
+        return true;
+    }
+
+    bool on_end_array() {
+        open_.pop_back();
+        return true;
+    }
+
+  private:
+    struct Frame {
+        Value* value;
+        bool array;
+    };
+
+    using String = typename Value::String;
+    using CharAlloc = typename Value::storage_traits::char_allocator;
+    static constexpr bool VIEWS = requires(std::string_view s, const CharAlloc& a) { String::view(s, a); };
+    // Keys can be views too unless the policy stores keys as another type (InternedKeyPolicy).
+    static constexpr bool KEY_VIEWS = VIEWS && std::is_same_v<typename Value::Object::key_type, String>;
+
+    Value* root_;
+    std::string_view pinned_; // source whose slices may be referenced (empty: copy everything)
+    Value* member_{nullptr}; // object member announced by the last on_key
+    std::vector<Frame> open_; // containers being filled, innermost last
+
+    [[nodiscard]] bool is_pinned(std::string_view s) const noexcept {
+        if constexpr (VIEWS) {
+            // Compare as integers: the pointers need not belong to the same array.
+            const auto first = reinterpret_cast<std::uintptr_t>(pinned_.data());
+            const auto p = reinterpret_cast<std::uintptr_t>(s.data());
+            return !s.empty() && p >= first && p + s.size() <= first + pinned_.size();
+        }
+        else {
+            return false;
+        }
+    }
+
+    // Where the next value goes: the root, a new array element, or the pending object member.
+    // Appending to an array never invalidates open_: its entries are that array and its ancestors.
+    Value& slot() {
+        if (open_.empty()) {
+            return *root_;
+        }
+        const Frame& parent = open_.back();
+        if (parent.array) {
+            return parent.value->as_array().emplace_back(Value{parent.value->get_allocator()});
+        }
+        return *member_;
+    }
+};
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_JSON_HANDLER_HPP
@@ -0,0 +1,333 @@
+#ifndef NFRRCONFIG_IMPL_JSON_INDEX_HPP
+#define NFRRCONFIG_IMPL_JSON_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "enums.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define NFRRCONFIG_X86_DISPATCH 1
+#endif
+
+namespace nfrr::config {
+
+/**
+ * @brief Failure reported by the document parsers: what went wrong and where.
+ */
+struct DocumentError {
+    ConfigError code{ConfigError::None};
+    std::size_t offset{0}; ///< Byte offset of the offending character in the input.
+
+    friend bool operator==(const DocumentError&, const DocumentError&) = default;
+};
+
+/**
+ * @brief Instruction set used by the stage-one structural scanner.
+ *
+ * Chosen at runtime from the running CPU (see detected_simd_level()), so binaries built for a
+ * generic x86-64 baseline still use AVX2 / AVX-512 where available.
+ */
+enum class SimdLevel : std::uint8_t {
+    Scalar, ///< Portable byte loop.
+    Sse2,   ///< 4 x 16-byte compares per block (x86-64 baseline).
+    Avx2,   ///< 2 x 32-byte compares per block.
+    Avx512  ///< 1 x 64-byte compare per block (AVX-512BW mask registers).
+};
+
+/**
+ * @brief Best SimdLevel supported by the running CPU. Detected once, then cached.
+ */
+inline SimdLevel detected_simd_level() noexcept {
+#ifdef NFRRCONFIG_X86_DISPATCH
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512bw")) {
+            return SimdLevel::Avx512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::Avx2;
+        }
+        return __builtin_cpu_supports("sse2") ? SimdLevel::Sse2 : SimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+/**
+ * @brief Whether @p level can run on this CPU.
+ */
+inline bool simd_level_supported(SimdLevel level) noexcept {
+    return static_cast<std::uint8_t>(level) <= static_cast<std::uint8_t>(detected_simd_level());
+}
+
+namespace config_detail {
+
+// Per-64-byte-block character classes, one bit per byte (bit i = byte i).
+struct BlockMasks {
+    std::uint64_t quote;
+    std::uint64_t backslash;
+    std::uint64_t op; // { } [ ] : , (plus two control bytes that alias them; rejected in stage two)
+    std::uint64_t whitespace;
+};
+
+using ClassifyBlockFn = BlockMasks (*)(const char*) noexcept;
+
+inline BlockMasks classify_block_scalar(const char* p) noexcept {
+    BlockMasks m{0, 0, 0, 0};
+    for (unsigned i = 0; i < 64; ++i) {
+        const std::uint64_t bit = std::uint64_t{1} << i;
+        switch (p[i]) {
+            case '"':
+                m.quote |= bit;
+                break;
+            case '\\':
+                m.backslash |= bit;
+                break;
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                m.op |= bit;
+                break;
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                m.whitespace |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+    return m;
+}
+
+#ifdef NFRRCONFIG_X86_DISPATCH
+// The vector kernels fold case with c | 0x20 so that '[' / ']' compare equal to '{' / '}'; this also
+// maps 0x0C and 0x1A onto ',' and ':'. Those control bytes are never valid outside strings, and
+// stage two rejects any structural position that does not hold the expected character.
+
+inline BlockMasks classify_block_sse2(const char* p) noexcept {
+    const auto eq = [](__m128i x, char c) { return _mm_cmpeq_epi8(x, _mm_set1_epi8(c)); };
+    const auto bits = [](__m128i x) { return std::uint64_t{static_cast<std::uint16_t>(_mm_movemask_epi8(x))}; };
+    BlockMasks m{0, 0, 0, 0};
+    for (unsigned i = 0; i < 4; ++i) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i)); // NOLINT
+        const __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        const __m128i op = _mm_or_si128(_mm_or_si128(eq(folded, '{'), eq(folded, '}')),
+                                        _mm_or_si128(eq(folded, ','), eq(folded, ':')));
+        const __m128i ws = _mm_or_si128(_mm_or_si128(eq(v, ' '), eq(v, '\t')), _mm_or_si128(eq(v, '\n'), eq(v, '\r')));
+        const unsigned shift = 16 * i;
+        m.quote |= bits(eq(v, '"')) << shift;
+        m.backslash |= bits(eq(v, '\\')) << shift;
+        m.op |= bits(op) << shift;
+        m.whitespace |= bits(ws) << shift;
+    }
+    return m;
+}
+
+__attribute__((target("avx2"))) inline __m256i avx2_eq(__m256i x, char c) noexcept {
+    return _mm256_cmpeq_epi8(x, _mm256_set1_epi8(c));
+}
+
+__attribute__((target("avx2"))) inline std::uint64_t avx2_bits(__m256i x) noexcept {
+    return std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(x))};
+}
+
+__attribute__((target("avx2"))) inline BlockMasks classify_block_avx2(const char* p) noexcept {
+    BlockMasks m{0, 0, 0, 0};
+    for (unsigned i = 0; i < 2; ++i) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * i)); // NOLINT
+        const __m256i folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        const __m256i op = _mm256_or_si256(_mm256_or_si256(avx2_eq(folded, '{'), avx2_eq(folded, '}')),
+                                           _mm256_or_si256(avx2_eq(folded, ','), avx2_eq(folded, ':')));
+        const __m256i ws = _mm256_or_si256(_mm256_or_si256(avx2_eq(v, ' '), avx2_eq(v, '\t')),
+                                           _mm256_or_si256(avx2_eq(v, '\n'), avx2_eq(v, '\r')));
+        const unsigned shift = 32 * i;
+        m.quote |= avx2_bits(avx2_eq(v, '"')) << shift;
+        m.backslash |= avx2_bits(avx2_eq(v, '\\')) << shift;
+        m.op |= avx2_bits(op) << shift;
+        m.whitespace |= avx2_bits(ws) << shift;
+    }
+    return m;
+}
+
+__attribute__((target("avx512f,avx512bw"))) inline std::uint64_t avx512_eq(__m512i x, char c) noexcept {
+    return _mm512_cmpeq_epi8_mask(x, _mm512_set1_epi8(c));
+}
+
+__attribute__((target("avx512f,avx512bw"))) inline BlockMasks classify_block_avx512(const char* p) noexcept {
+    const __m512i v = _mm512_loadu_si512(p);
+    const __m512i folded = _mm512_or_si512(v, _mm512_set1_epi8(0x20));
+    BlockMasks m{};
+    m.quote = avx512_eq(v, '"');
+    m.backslash = avx512_eq(v, '\\');
+    m.op = avx512_eq(folded, '{') | avx512_eq(folded, '}') | avx512_eq(folded, ',') | avx512_eq(folded, ':');
+    m.whitespace = avx512_eq(v, ' ') | avx512_eq(v, '\t') | avx512_eq(v, '\n') | avx512_eq(v, '\r');
+    return m;
+}
+#endif
+
+inline ClassifyBlockFn classify_block_for(SimdLevel level) noexcept {
+#ifdef NFRRCONFIG_X86_DISPATCH
+    switch (level) {
+        case SimdLevel::Avx512:
+            return &classify_block_avx512;
+        case SimdLevel::Avx2:
+            return &classify_block_avx2;
+        case SimdLevel::Sse2:
+            return &classify_block_sse2;
+        case SimdLevel::Scalar:
+            break;
+    }
+#else
+    (void)level;
+#endif
+    return &classify_block_scalar;
+}
+
+// Inclusive prefix XOR: bit i of the result is the parity of bits [0, i] of x.
+inline std::uint64_t prefix_xor(std::uint64_t x) noexcept {
+    x ^= x << 1U;
+    x ^= x << 2U;
+    x ^= x << 4U;
+    x ^= x << 8U;
+    x ^= x << 16U;
+    x ^= x << 32U;
+    return x;
+}
+
+} // namespace config_detail
+
+/**
+ * @brief Stage one of the two-stage JSON parser: offsets of every structural character.
+ *
+ * The input is classified 64 bytes at a time with vector compares. Escaped quotes are resolved
+ * with carry-propagating bit arithmetic, and string interiors with a prefix XOR, so the scan has
+ * no per-byte branches. The index lists, in document order:
+ *  - every { } [ ] : , outside strings;
+ *  - the opening quote of every string;
+ *  - the first byte of every other scalar (number or literal).
+ *
+ * Stage two (parse_json_indexed, and the lazy document) jumps from entry to entry instead of
+ * re-scanning whitespace, and validates the grammar as it goes. Offsets are 32-bit, so inputs are
+ * limited to 4 GiB.
+ */
+class JsonStructuralIndex {
+  public:
+    JsonStructuralIndex() = default;
+
+    /**
+     * @brief Scan @p text with the given instruction set (defaults to the best one available).
+     *
+     * Only fails (with OutOfRange) if the input does not fit 32-bit offsets. Malformed input still
+     * yields an index; stage two reports the error at the right offset, e.g. an unterminated
+     * string is the last entry and runs into the end of the input.
+     *
+     * @pre simd_level_supported(level)
+     */
+    static std::expected<JsonStructuralIndex, DocumentError> build(std::string_view text,
+                                                                   SimdLevel level = detected_simd_level()) {
+        JsonStructuralIndex index;
+        if (text.size() >= std::numeric_limits<std::uint32_t>::max()) {
+            return std::unexpected(DocumentError{ConfigError::OutOfRange, 0});
+        }
+        index.positions_.reserve(text.size() / 8 + 8);
+        index.scan(text, config_detail::classify_block_for(level));
+        return index;
+    }
+
+    /// Structural offsets in document order.
+    [[nodiscard]] std::span<const std::uint32_t> positions() const noexcept {
+        return positions_;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return positions_.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return positions_.empty();
+    }
+
+  private:
+    std::vector<std::uint32_t> positions_;
+
+    void scan(std::string_view text, config_detail::ClassifyBlockFn classify) {
+        constexpr std::uint64_t EVEN_BITS = 0x5555'5555'5555'5555ULL;
+
+        std::uint64_t prev_escaped = 0;   // 1 if the first byte of the next block is escaped
+        std::uint64_t prev_in_string = 0; // all ones if the next block starts inside a string
+        std::uint64_t prev_scalar = 0;    // 1 if the previous block ended in a non-quote scalar byte
+
+        const std::size_t size = text.size();
+        char tail[64];
+        for (std::size_t base = 0; base < size; base += 64) {
+            const char* block = text.data() + base;
+            if (size - base < 64) {
+                // Pad the final partial block with spaces, which are never structural.
+                std::memset(tail, ' ', sizeof(tail));
+                std::memcpy(tail, block, size - base);
+                block = tail;
+            }
+            const config_detail::BlockMasks m = classify(block);
+
+            // Bytes escaped by an odd-length run of backslashes.
+            const std::uint64_t backslash = m.backslash & ~prev_escaped;
+            const std::uint64_t follows_escape = (backslash << 1U) | prev_escaped;
+            const std::uint64_t odd_starts = backslash & ~EVEN_BITS & ~follows_escape;
+            std::uint64_t even_carry_runs = 0;
+            prev_escaped = __builtin_add_overflow(odd_starts, backslash, &even_carry_runs) ? 1U : 0U;
+            const std::uint64_t escaped = (EVEN_BITS ^ (even_carry_runs << 1U)) & follows_escape;
+
+            // String regions: [opening quote, closing quote).
+            const std::uint64_t quote = m.quote & ~escaped;
+            const std::uint64_t in_string = config_detail::prefix_xor(quote) ^ prev_in_string;
+            prev_in_string = static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >> 63);
+
+            // Scalar starts: non-whitespace, non-operator bytes not preceded by another such byte.
+            const std::uint64_t scalar = ~(m.op | m.whitespace);
+            const std::uint64_t nonquote_scalar = scalar & ~quote;
+            const std::uint64_t follows_scalar = (nonquote_scalar << 1U) | prev_scalar;
+            prev_scalar = nonquote_scalar >> 63U;
+
+            // Drop everything inside strings and the closing quotes; keep the opening quotes.
+            const std::uint64_t string_tail = in_string ^ quote;
+            std::uint64_t structurals = (m.op | (scalar & ~follows_scalar)) & ~string_tail;
+            if (size - base < 64) {
+                structurals &= (std::uint64_t{1} << (size - base)) - 1;
+            }
+            flatten(structurals, static_cast<std::uint32_t>(base));
+        }
+    }
+
+    void flatten(std::uint64_t bits, std::uint32_t base) {
+        if (bits == 0) {
+            return;
+        }
+        const auto count = static_cast<std::size_t>(__builtin_popcountll(bits));
+        const std::size_t old_size = positions_.size();
+        positions_.resize(old_size + count);
+        std::uint32_t* out = positions_.data() + old_size;
+        while (bits != 0) {
+            *out++ = base + static_cast<std::uint32_t>(__builtin_ctzll(bits));
+            bits &= bits - 1;
+        }
+    }
+};
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_JSON_INDEX_HPP
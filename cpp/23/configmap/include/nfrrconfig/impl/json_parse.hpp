@@ -0,0 +1,751 @@
+#ifndef NFRRCONFIG_IMPL_JSON_PARSE_HPP
+#define NFRRCONFIG_IMPL_JSON_PARSE_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "basic_config_value.hpp"
+#include "bcv_impl.hpp"
+#include "enums.hpp"
+#include "json_handler.hpp"
+#include "json_index.hpp"
+#include "simd.hpp"
+
+/**
+ * @brief Maximum array/object nesting accepted by the JSON parser.
+ *
+ * Bounds the recursion of the readers; deeper documents fail with ConfigError::DepthExceeded.
+ */
+#ifndef NFRRCONFIG_JSON_MAX_DEPTH
+#define NFRRCONFIG_JSON_MAX_DEPTH 1024
+#endif
+
+namespace nfrr::config {
+
+namespace config_detail {
+
+/**
+ * @brief Decoded JSON number: Integer when it fits int64 without fraction or exponent, else Floating.
+ */
+struct JsonNumber {
+    bool integral;
+    std::int64_t integer;
+    double floating;
+};
+
+/**
+ * @brief Lexical layer shared by the JSON parsers: a position in the input plus the token
+ *        decoders (strings with escapes, numbers, literals) and error bookkeeping.
+ *
+ * Decoders start at cur_ and leave it just past the token, or at the offending byte after
+ * recording the error through fail().
+ */
+class JsonCursor {
+  public:
+    explicit JsonCursor(std::string_view text) noexcept
+        : begin_{text.data()}, cur_{text.data()}, end_{text.data() + text.size()} {}
+
+  protected:
+    const char* begin_;
+    const char* cur_;
+    const char* end_;
+    std::string scratch_; // decoded text of strings that contain escapes
+    DocumentError error_{};
+
+    bool fail(ConfigError code) noexcept {
+        error_ = DocumentError{code, static_cast<std::size_t>(cur_ - begin_)};
+        return false;
+    }
+
+    static bool is_digit(char c) noexcept {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    static bool is_whitespace(char c) noexcept {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    void skip_whitespace() noexcept {
+        while (cur_ != end_ && is_whitespace(*cur_)) {
+            ++cur_;
+        }
+    }
+
+    // Scalars must be followed by whitespace, an operator or the end of the input ("12x" is an error).
+    bool check_scalar_end() noexcept {
+        if (cur_ == end_ || is_whitespace(*cur_) || *cur_ == ',' || *cur_ == ']' || *cur_ == '}' || *cur_ == ':') {
+            return true;
+        }
+        return fail(ConfigError::SyntaxError);
+    }
+
+    bool parse_literal(std::string_view word) noexcept {
+        const auto available = static_cast<std::size_t>(end_ - cur_);
+        if (available < word.size()) {
+            if (std::memcmp(cur_, word.data(), available) != 0) {
+                return fail(ConfigError::SyntaxError);
+            }
+            cur_ = end_;
+            return fail(ConfigError::UnexpectedEnd);
+        }
+        if (std::memcmp(cur_, word.data(), word.size()) != 0) {
+            return fail(ConfigError::SyntaxError);
+        }
+        cur_ += word.size();
+        return true;
+    }
+
+    // Validates the JSON number grammar at cur_, then converts. Integers of up to 18 digits are
+    // accumulated inline; longer ones go through from_chars and fall back to double on overflow.
+    bool scan_number(JsonNumber& out) {
+        const char* start = cur_;
+        const bool negative = *cur_ == '-';
+        if (negative) {
+            ++cur_;
+        }
+        const char* digits = cur_;
+        if (cur_ == end_) {
+            return fail(ConfigError::UnexpectedEnd);
+        }
+        if (*cur_ == '0') {
+            ++cur_;
+        }
+        else if (is_digit(*cur_)) {
+            while (cur_ != end_ && is_digit(*cur_)) {
+                ++cur_;
+            }
+        }
+        else {
+            return fail(ConfigError::InvalidNumber);
+        }
+        const auto int_digits = static_cast<std::size_t>(cur_ - digits);
+
+        bool floating = false;
+        if (cur_ != end_ && *cur_ == '.') {
+            ++cur_;
+            if (cur_ == end_ || !is_digit(*cur_)) {
+                return fail(ConfigError::InvalidNumber);
+            }
+            while (cur_ != end_ && is_digit(*cur_)) {
+                ++cur_;
+            }
+            floating = true;
+        }
+        if (cur_ != end_ && (*cur_ == 'e' || *cur_ == 'E')) {
+            ++cur_;
+            if (cur_ != end_ && (*cur_ == '+' || *cur_ == '-')) {
+                ++cur_;
+            }
+            if (cur_ == end_ || !is_digit(*cur_)) {
+                return fail(ConfigError::InvalidNumber);
+            }
+            while (cur_ != end_ && is_digit(*cur_)) {
+                ++cur_;
+            }
+            floating = true;
+        }
+
+        if (!floating) {
+            if (int_digits <= 18) {
+                std::uint64_t magnitude = 0;
+                for (const char* p = digits; p != cur_; ++p) {
+                    magnitude = magnitude * 10 + static_cast<std::uint64_t>(*p - '0');
+                }
+                const auto value = static_cast<std::int64_t>(magnitude);
+                out = JsonNumber{true, negative ? -value : value, 0.0};
+                return true;
+            }
+            std::int64_t value = 0;
+            const auto [ptr, ec] = std::from_chars(start, cur_, value);
+            if (ec == std::errc{} && ptr == cur_) {
+                out = JsonNumber{true, value, 0.0};
+                return true;
+            }
+        }
+
+        double value = 0.0;
+        const auto [ptr, ec] = std::from_chars(start, cur_, value);
+        if (ec == std::errc::result_out_of_range) {
+            cur_ = start;
+            return fail(ConfigError::OutOfRange);
+        }
+        if (ec != std::errc{} || ptr != cur_) {
+            cur_ = start;
+            return fail(ConfigError::InvalidNumber);
+        }
+        out = JsonNumber{false, 0, value};
+        return true;
+    }
+
+    // On success @p out views either the input (no escapes) or scratch_, valid until the next string.
+    bool parse_string(std::string_view& out) {
+        ++cur_; // opening quote
+        const char* run = cur_;
+        cur_ = find_string_special(cur_, end_);
+        if (cur_ == end_) {
+            return fail(ConfigError::UnexpectedEnd);
+        }
+        if (*cur_ == '"') {
+            out = std::string_view{run, static_cast<std::size_t>(cur_ - run)};
+            ++cur_;
+            return true;
+        }
+
+        scratch_.assign(run, cur_);
+        while (true) {
+            if (*cur_ == '"') {
+                ++cur_;
+                out = scratch_;
+                return true;
+            }
+            if (*cur_ != '\\') {
+                return fail(ConfigError::InvalidString); // unescaped control character
+            }
+            if (!decode_escape()) {
+                return false;
+            }
+            run = cur_;
+            cur_ = find_string_special(cur_, end_);
+            scratch_.append(run, cur_);
+            if (cur_ == end_) {
+                return fail(ConfigError::UnexpectedEnd);
+            }
+        }
+    }
+
+    bool parse_hex4(std::uint32_t& out) noexcept {
+        if (end_ - cur_ < 4) {
+            cur_ = end_;
+            return fail(ConfigError::UnexpectedEnd);
+        }
+        std::uint32_t value = 0;
+        for (int i = 0; i < 4; ++i, ++cur_) {
+            const char c = *cur_;
+            std::uint32_t nibble = 0;
+            if (is_digit(c)) {
+                nibble = static_cast<std::uint32_t>(c - '0');
+            }
+            else if (c >= 'a' && c <= 'f') {
+                nibble = static_cast<std::uint32_t>(c - 'a' + 10);
+            }
+            else if (c >= 'A' && c <= 'F') {
+                nibble = static_cast<std::uint32_t>(c - 'A' + 10);
+            }
+            else {
+                return fail(ConfigError::InvalidString);
+            }
+            value = (value << 4U) | nibble;
+        }
+        out = value;
+        return true;
+    }
+
+    // cur_ is on a backslash; appends the decoded character(s) to scratch_.
+    bool decode_escape() {
+        const char* escape = cur_;
+        ++cur_;
+        if (cur_ == end_) {
+            return fail(ConfigError::UnexpectedEnd);
+        }
+        const char c = *cur_++;
+        switch (c) {
+            case '"':
+            case '\\':
+            case '/':
+                scratch_.push_back(c);
+                return true;
+            case 'b':
+                scratch_.push_back('\b');
+                return true;
+            case 'f':
+                scratch_.push_back('\f');
+                return true;
+            case 'n':
+                scratch_.push_back('\n');
+                return true;
+            case 'r':
+                scratch_.push_back('\r');
+                return true;
+            case 't':
+                scratch_.push_back('\t');
+                return true;
+            case 'u':
+                break;
+            default:
+                cur_ = escape;
+                return fail(ConfigError::InvalidString);
+        }
+
+        std::uint32_t code = 0;
+        if (!parse_hex4(code)) {
+            return false;
+        }
+        if (code >= 0xDC00 && code <= 0xDFFF) {
+            cur_ = escape;
+            return fail(ConfigError::InvalidString); // lone low surrogate
+        }
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            std::uint32_t low = 0;
+            if (end_ - cur_ < 2 || cur_[0] != '\\' || cur_[1] != 'u') {
+                cur_ = escape;
+                return fail(ConfigError::InvalidString); // high surrogate without a pair
+            }
+            cur_ += 2;
+            if (!parse_hex4(low)) {
+                return false;
+            }
+            if (low < 0xDC00 || low > 0xDFFF) {
+                cur_ = escape;
+                return fail(ConfigError::InvalidString);
+            }
+            code = 0x10000 + ((code - 0xD800) << 10U) + (low - 0xDC00);
+        }
+        append_utf8(code);
+        return true;
+    }
+
+    void append_utf8(std::uint32_t code) {
+        if (code < 0x80) {
+            scratch_.push_back(static_cast<char>(code));
+        }
+        else if (code < 0x800) {
+            scratch_.push_back(static_cast<char>(0xC0 | (code >> 6U)));
+            scratch_.push_back(static_cast<char>(0x80 | (code & 0x3FU)));
+        }
+        else if (code < 0x10000) {
+            scratch_.push_back(static_cast<char>(0xE0 | (code >> 12U)));
+            scratch_.push_back(static_cast<char>(0x80 | ((code >> 6U) & 0x3FU)));
+            scratch_.push_back(static_cast<char>(0x80 | (code & 0x3FU)));
+        }
+        else {
+            scratch_.push_back(static_cast<char>(0xF0 | (code >> 18U)));
+            scratch_.push_back(static_cast<char>(0x80 | ((code >> 12U) & 0x3FU)));
+            scratch_.push_back(static_cast<char>(0x80 | ((code >> 6U) & 0x3FU)));
+            scratch_.push_back(static_cast<char>(0x80 | (code & 0x3FU)));
+        }
+    }
+};
+
+/**
+ * @brief Single-pass recursive-descent JSON reader that reports the document to a JsonHandler.
+ *
+ * Grammar, string escapes and numbers are validated before the corresponding event is emitted.
+ * Syntax errors are returned, not thrown; exceptions only come from the handler.
+ */
+template <JsonHandler Handler>
+class JsonReader : public JsonCursor {
+  public:
+    JsonReader(std::string_view text, Handler& handler) noexcept : JsonCursor{text}, handler_{handler} {}
+
+    /**
+     * @brief Read the whole input (one value surrounded by optional whitespace).
+     */
+    std::expected<void, DocumentError> read() {
+        skip_whitespace();
+        if (!read_value(0)) {
+            return std::unexpected(error_);
+        }
+        skip_whitespace();
+        if (cur_ != end_) {
+            fail(ConfigError::SyntaxError);
+            return std::unexpected(error_);
+        }
+        return {};
+    }
+
+  private:
+    Handler& handler_;
+
+    bool emit(bool keep_going) noexcept {
+        return keep_going || fail(ConfigError::Cancelled);
+    }
+
+    bool read_value(std::size_t depth) {
+        if (cur_ == end_) {
+            return fail(ConfigError::UnexpectedEnd);
+        }
+        switch (*cur_) {
+            case '{':
+                return read_object(depth + 1);
+            case '[':
+                return read_array(depth + 1);
+            case '"': {
+                std::string_view text;
+                return parse_string(text) && emit(handler_.on_string(text));
+            }
+            case 't':
+                return parse_literal("true") && check_scalar_end() && emit(handler_.on_bool(true));
+            case 'f':
+                return parse_literal("false") && check_scalar_end() && emit(handler_.on_bool(false));
+            case 'n':
+                return parse_literal("null") && check_scalar_end() && emit(handler_.on_null());
+            default:
+                if (*cur_ == '-' || is_digit(*cur_)) {
+                    JsonNumber number{};
+                    if (!scan_number(number) || !check_scalar_end()) {
+                        return false;
+                    }
+                    return emit(number.integral ? handler_.on_int64(number.integer)
+                                                : handler_.on_double(number.floating));
+                }
+                return fail(ConfigError::SyntaxError);
+        }
+    }
+
+    bool read_object(std::size_t depth) {
+        if (depth > NFRRCONFIG_JSON_MAX_DEPTH) {
+            return fail(ConfigError::DepthExceeded);
+        }
+        ++cur_; // '{'
+        if (!emit(handler_.on_start_object())) {
+            return false;
+        }
+
+        skip_whitespace();
+        if (cur_ != end_ && *cur_ == '}') {
+            ++cur_;
+            return emit(handler_.on_end_object());
+        }
+        while (true) {
+            if (cur_ == end_) {
+                return fail(ConfigError::UnexpectedEnd);
+            }
+            if (*cur_ != '"') {
+                return fail(ConfigError::SyntaxError);
+            }
+            std::string_view key;
+            if (!parse_string(key)) {
+                return false;
+            }
+            skip_whitespace();
+            if (cur_ == end_) {
+                return fail(ConfigError::UnexpectedEnd);
+            }
+            if (*cur_ != ':') {
+                return fail(ConfigError::SyntaxError);
+            }
+            if (!emit(handler_.on_key(key))) {
+                return false;
+            }
+            ++cur_;
+            skip_whitespace();
+            if (!read_value(depth)) {
+                return false;
+            }
+
+            skip_whitespace();
+            if (cur_ == end_) {
+                return fail(ConfigError::UnexpectedEnd);
+            }
+            if (*cur_ == ',') {
+                ++cur_;
+                skip_whitespace();
+                continue;
+            }
+            if (*cur_ == '}') {
+                ++cur_;
+                return emit(handler_.on_end_object());
+            }
+            return fail(ConfigError::SyntaxError);
+        }
+    }
+
+    bool read_array(std::size_t depth) {
+        if (depth > NFRRCONFIG_JSON_MAX_DEPTH) {
+            return fail(ConfigError::DepthExceeded);
+        }
+        ++cur_; // '['
+        if (!emit(handler_.on_start_array())) {
+            return false;
+        }
+
+        skip_whitespace();
+        if (cur_ != end_ && *cur_ == ']') {
+            ++cur_;
+            return emit(handler_.on_end_array());
+        }
+        while (true) {
+            if (!read_value(depth)) {
+                return false;
+            }
+
+            skip_whitespace();
+            if (cur_ == end_) {
+                return fail(ConfigError::UnexpectedEnd);
+            }
+            if (*cur_ == ',') {
+                ++cur_;
+                skip_whitespace();
+                continue;
+            }
+            if (*cur_ == ']') {
+                ++cur_;
+                return emit(handler_.on_end_array());
+            }
+            return fail(ConfigError::SyntaxError);
+        }
+    }
+};
+
+/**
+ * @brief Stage two of the two-stage parser: reports the document to a JsonHandler by walking a
+ *        JsonStructuralIndex.
+ *
+ * Each step jumps to the next structural offset, so whitespace is never re-scanned and the
+ * dispatch is on a single byte. Grammar is validated here (stage one only classifies bytes);
+ * strings, numbers and literals are decoded by the shared JsonCursor routines.
+ */
+template <JsonHandler Handler>
+class JsonIndexedReader : public JsonCursor {
+  public:
+    /// Read the single value spanned by @p positions (a whole index, or one value's slice of it).
+    JsonIndexedReader(std::string_view text, std::span<const std::uint32_t> positions, Handler& handler) noexcept
+        : JsonCursor{text}, handler_{handler}, next_{positions.data()}, last_{positions.data() + positions.size()} {}
+
+    std::expected<void, DocumentError> read() {
+        if (!advance() || !read_value(0)) {
+            return std::unexpected(error_);
+        }
+        if (next_ != last_) {
+            cur_ = begin_ + *next_;
+            fail(ConfigError::SyntaxError);
+            return std::unexpected(error_);
+        }
+        return {};
+    }
+
+  private:
+    Handler& handler_;
+    const std::uint32_t* next_;
+    const std::uint32_t* last_;
+
+    bool emit(bool keep_going) noexcept {
+        return keep_going || fail(ConfigError::Cancelled);
+    }
+
+    // Move cur_ to the next structural character.
+    bool advance() noexcept {
+        if (next_ == last_) {
+            cur_ = end_;
+            return fail(ConfigError::UnexpectedEnd);
+        }
+        cur_ = begin_ + *next_++;
+        return true;
+    }
+
+    bool read_value(std::size_t depth) {
+        switch (*cur_) {
+            case '{':
+                return read_object(depth + 1);
+            case '[':
+                return read_array(depth + 1);
+            case '"': {
+                std::string_view text;
+                return parse_string(text) && emit(handler_.on_string(text));
+            }
+            case 't':
+                return parse_literal("true") && check_scalar_end() && emit(handler_.on_bool(true));
+            case 'f':
+                return parse_literal("false") && check_scalar_end() && emit(handler_.on_bool(false));
+            case 'n':
+                return parse_literal("null") && check_scalar_end() && emit(handler_.on_null());
+            default:
+                if (*cur_ == '-' || is_digit(*cur_)) {
+                    JsonNumber number{};
+                    if (!scan_number(number) || !check_scalar_end()) {
+                        return false;
+                    }
+                    return emit(number.integral ? handler_.on_int64(number.integer)
+                                                : handler_.on_double(number.floating));
+                }
+                return fail(ConfigError::SyntaxError);
+        }
+    }
+
+    bool read_object(std::size_t depth) {
+        if (depth > NFRRCONFIG_JSON_MAX_DEPTH) {
+            return fail(ConfigError::DepthExceeded);
+        }
+        if (!emit(handler_.on_start_object()) || !advance()) {
+            return false;
+        }
+        if (*cur_ == '}') {
+            return emit(handler_.on_end_object());
+        }
+        while (true) {
+            if (*cur_ != '"') {
+                return fail(ConfigError::SyntaxError);
+            }
+            std::string_view key;
+            if (!parse_string(key) || !advance()) {
+                return false;
+            }
+            if (*cur_ != ':') {
+                return fail(ConfigError::SyntaxError);
+            }
+            if (!emit(handler_.on_key(key)) || !advance() || !read_value(depth) || !advance()) {
+                return false;
+            }
+            if (*cur_ == ',') {
+                if (!advance()) {
+                    return false;
+                }
+                continue;
+            }
+            if (*cur_ == '}') {
+                return emit(handler_.on_end_object());
+            }
+            return fail(ConfigError::SyntaxError);
+        }
+    }
+
+    bool read_array(std::size_t depth) {
+        if (depth > NFRRCONFIG_JSON_MAX_DEPTH) {
+            return fail(ConfigError::DepthExceeded);
+        }
+        if (!emit(handler_.on_start_array()) || !advance()) {
+            return false;
+        }
+        if (*cur_ == ']') {
+            return emit(handler_.on_end_array());
+        }
+        while (true) {
+            if (!read_value(depth) || !advance()) {
+                return false;
+            }
+            if (*cur_ == ',') {
+                if (!advance()) {
+                    return false;
+                }
+                continue;
+            }
+            if (*cur_ == ']') {
+                return emit(handler_.on_end_array());
+            }
+            return fail(ConfigError::SyntaxError);
+        }
+    }
+};
+
+} // namespace config_detail
+
+/**
+ * @brief Stream a JSON document (RFC 8259) into @p handler without building a tree.
+ *
+ * Nothing is allocated apart from a scratch buffer for strings that contain escapes. Malformed
+ * input is reported through the result (error code and byte offset); events already delivered
+ * before the error are not retracted. A handler callback returning false stops the read with
+ * ConfigError::Cancelled, which makes "pick three fields out of a large document" cheap.
+ */
+template <JsonHandler Handler>
+[[nodiscard]] std::expected<void, DocumentError> read_json(std::string_view text, Handler& handler) {
+    config_detail::JsonReader<Handler> reader{text, handler};
+    return reader.read();
+}
+
+/**
+ * @brief Like read_json(), driven by the two-stage structural index (see parse_json_indexed()).
+ *
+ * @pre simd_level_supported(level)
+ */
+template <JsonHandler Handler>
+[[nodiscard]] std::expected<void, DocumentError> read_json_indexed(std::string_view text, Handler& handler,
+                                                                   SimdLevel level = detected_simd_level()) {
+    auto index = JsonStructuralIndex::build(text, level);
+    if (!index) {
+        return std::unexpected(index.error());
+    }
+    config_detail::JsonIndexedReader<Handler> reader{text, index->positions(), handler};
+    return reader.read();
+}
+
+/**
+ * @brief Parse a JSON document (RFC 8259) into a BasicConfigValue.
+ *
+ * All nested strings, arrays and objects are allocated through @p alloc, so passing a
+ * polymorphic_allocator places the whole tree on its memory resource. Objects keep document
+ * order; for duplicate keys the last value wins. Integers that fit in int64 are stored as
+ * Integer, everything else as Floating.
+ *
+ * Malformed input never throws: the result carries the error code and the byte offset where
+ * parsing stopped. Only allocation failure propagates as an exception.
+ *
+ * This is read_json() driving a JsonDomBuilder.
+ *
+ * @code
+ * auto cfg = parse_json(text);                                   // std::allocator
+ * auto pmr = parse_json(text, PmrByteAllocator{&arena});          // everything in the arena
+ * auto srt = parse_json<StdByteAllocator, SortedObjectPolicy<>>(text);
+ * @endcode
+ */
+template <typename Alloc = std::allocator<std::byte>, typename ObjectPolicy = DefaultObjectPolicy>
+[[nodiscard]] std::expected<BasicConfigValue<Alloc, ObjectPolicy>, DocumentError>
+parse_json(std::string_view text, const Alloc& alloc = Alloc{}) {
+    using Value = BasicConfigValue<Alloc, ObjectPolicy>;
+    Value root{alloc};
+    JsonDomBuilder<Value> builder{root};
+    if (auto parsed = read_json(text, builder); !parsed) {
+        return std::unexpected(parsed.error());
+    }
+    return root;
+}
+
+/**
+ * @brief Parse a JSON document with the two-stage (structural index) parser.
+ *
+ * Produces the same value and the same errors as parse_json(). Stage one classifies the input
+ * 64 bytes at a time with the widest vector unit the CPU offers (selected at runtime, see
+ * SimdLevel), stage two walks the resulting JsonStructuralIndex to build the tree. Pays off on
+ * large, whitespace-heavy documents; @p level forces a specific scanner (e.g. for testing).
+ *
+ * @pre simd_level_supported(level)
+ */
+template <typename Alloc = std::allocator<std::byte>, typename ObjectPolicy = DefaultObjectPolicy>
+[[nodiscard]] std::expected<BasicConfigValue<Alloc, ObjectPolicy>, DocumentError>
+parse_json_indexed(std::string_view text, const Alloc& alloc = Alloc{}, SimdLevel level = detected_simd_level()) {
+    using Value = BasicConfigValue<Alloc, ObjectPolicy>;
+    Value root{alloc};
+    JsonDomBuilder<Value> builder{root};
+    if (auto parsed = read_json_indexed(text, builder, level); !parsed) {
+        return std::unexpected(parsed.error());
+    }
+    return root;
+}
+
+/**
+ * @brief Parse a JSON document whose buffer outlives the result, referencing it instead of copying.
+ *
+ * With ZeroCopyStringPolicy, keys and strings without escapes become views into @p pinned_text
+ * (e.g. a memory-mapped file), so they cost neither an allocation nor a copy; only strings that
+ * need unescaping are copied through @p alloc. With any other policy this is parse_json().
+ *
+ * The result must not outlive @p pinned_text. Copying a value (or the whole tree) produces owning
+ * strings, which is how to detach a subtree from the buffer.
+ *
+ * @code
+ * auto cfg = parse_json_pinned<StdByteAllocator, ZeroCopyStringPolicy<>>(mapped_text);
+ * @endcode
+ */
+template <typename Alloc = std::allocator<std::byte>, typename ObjectPolicy = ZeroCopyStringPolicy<>>
+[[nodiscard]] std::expected<BasicConfigValue<Alloc, ObjectPolicy>, DocumentError>
+parse_json_pinned(std::string_view pinned_text, const Alloc& alloc = Alloc{}) {
+    using Value = BasicConfigValue<Alloc, ObjectPolicy>;
+    Value root{alloc};
+    JsonDomBuilder<Value> builder{root, pinned_text};
+    if (auto parsed = read_json(pinned_text, builder); !parsed) {
+        return std::unexpected(parsed.error());
+    }
+    return root;
+}
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_JSON_PARSE_HPP
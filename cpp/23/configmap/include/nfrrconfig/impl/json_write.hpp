@@ -0,0 +1,352 @@
+#ifndef NFRRCONFIG_IMPL_JSON_WRITE_HPP
+#define NFRRCONFIG_IMPL_JSON_WRITE_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "basic_config_value.hpp"
+#include "bcv_impl.hpp"
+#include "enums.hpp"
+#include "simd.hpp"
+
+namespace nfrr::config {
+
+/**
+ * @brief Output target for to_json(): anything with append(const char*, std::size_t),
+ *        e.g. std::string.
+ *
+ * The writer batches output in a local buffer, so append() is called with chunks of a few
+ * kilobytes rather than per token.
+ */
+template <typename S>
+concept JsonSink = requires(S& s, const char* p, std::size_t n) { s.append(p, n); };
+
+/**
+ * @brief JsonSink that can also take bytes by reference: append_ref(p, n) may keep the pointer
+ *        instead of copying, until the sink's own flush.
+ *
+ * For such sinks to_json() passes long string payloads straight from the value's storage
+ * (see JsonFdSink), so the value must not change until the sink has been flushed.
+ */
+template <typename S>
+concept JsonRefSink = JsonSink<S> && requires(S& s, const char* p, std::size_t n) { s.append_ref(p, n); };
+
+/**
+ * @brief Layout options for to_json().
+ */
+struct JsonWriteOptions {
+    bool pretty = false;     ///< One member / element per line, indented; compact (no whitespace) otherwise.
+    std::uint8_t indent = 2; ///< Spaces per nesting level in pretty mode.
+};
+
+namespace config_detail {
+
+// "00" "01" ... "99": two digits per table lookup when formatting integers.
+inline constexpr char DIGIT_PAIRS[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                                      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                                      "8081828384858687888990919293949596979899";
+
+/**
+ * @brief Buffered JSON emitter behind to_json().
+ *
+ * Formatting goes into a fixed stack buffer which is handed to the sink when full and by
+ * finish(). Integers use the digit-pair table, doubles std::to_chars (shortest round-trip
+ * representation), strings are copied in runs between the bytes that need escaping, which
+ * find_string_special() locates 16/32 bytes at a time.
+ */
+template <JsonSink Sink>
+class JsonWriter {
+  public:
+    JsonWriter(Sink& sink, const JsonWriteOptions& options) noexcept : sink_{&sink}, options_{options} {}
+
+    template <typename Value>
+    void write(const Value& value) {
+        write_value(value, 0);
+    }
+
+    /// Hand the buffered tail to the sink.
+    void finish() {
+        flush();
+    }
+
+  private:
+    static constexpr std::size_t BUFFER_SIZE = 4096;
+    static constexpr std::size_t MAX_TOKEN = 32; // longest integer / double / escape sequence
+    static constexpr std::size_t REF_THRESHOLD = 512; // runs handed to append_ref() instead of copied
+
+    Sink* sink_;
+    JsonWriteOptions options_;
+    std::size_t used_ = 0;
+    char buffer_[BUFFER_SIZE];
+
+    void flush() {
+        if (used_ != 0) {
+            sink_->append(buffer_, used_);
+            used_ = 0;
+        }
+    }
+
+    // Room for at least n more bytes (n <= BUFFER_SIZE).
+    char* reserve(std::size_t n) {
+        if (BUFFER_SIZE - used_ < n) {
+            flush();
+        }
+        return buffer_ + used_;
+    }
+
+    void put(char c) {
+        *reserve(1) = c;
+        ++used_;
+    }
+
+    // p must stay valid for the whole to_json() call (string storage or a literal).
+    void put(const char* p, std::size_t n) {
+        if constexpr (JsonRefSink<Sink>) {
+            if (n >= REF_THRESHOLD) {
+                flush();
+                sink_->append_ref(p, n);
+                return;
+            }
+        }
+        if (BUFFER_SIZE - used_ >= n) {
+            std::memcpy(buffer_ + used_, p, n);
+            used_ += n;
+            return;
+        }
+        flush();
+        if (n >= BUFFER_SIZE / 2) {
+            sink_->append(p, n); // large runs bypass the buffer
+            return;
+        }
+        std::memcpy(buffer_, p, n);
+        used_ = n;
+    }
+
+    void put(std::string_view s) {
+        put(s.data(), s.size());
+    }
+
+    void newline(std::size_t depth) {
+        const std::size_t width = depth * options_.indent;
+        put('\n');
+        for (std::size_t done = 0; done < width;) {
+            const std::size_t chunk = std::min<std::size_t>(width - done, BUFFER_SIZE);
+            std::memset(reserve(chunk), ' ', chunk);
+            used_ += chunk;
+            done += chunk;
+        }
+    }
+
+    template <typename Value>
+    void write_value(const Value& value, std::size_t depth) {
+        switch (value.kind()) {
+            case ConfigValueKind::Null:
+                put("null");
+                break;
+            case ConfigValueKind::Boolean:
+                put(value.as_bool() ? std::string_view{"true"} : std::string_view{"false"});
+                break;
+            case ConfigValueKind::Integer:
+                write_integer(value.as_integer());
+                break;
+            case ConfigValueKind::Floating:
+                write_floating(value.as_floating());
+                break;
+            case ConfigValueKind::String:
+                write_string(std::string_view{value.as_string().data(), value.as_string().size()});
+                break;
+            case ConfigValueKind::Array:
+                write_array(value.as_array(), depth);
+                break;
+            case ConfigValueKind::Object:
+                write_object(value.as_object(), depth);
+                break;
+        }
+    }
+
+    template <typename Array>
+    void write_array(const Array& array, std::size_t depth) {
+        put('[');
+        bool first = true;
+        for (const auto& element : array) {
+            if (!first) {
+                put(',');
+            }
+            first = false;
+            if (options_.pretty) {
+                newline(depth + 1);
+            }
+            write_value(element, depth + 1);
+        }
+        if (options_.pretty && !first) {
+            newline(depth);
+        }
+        put(']');
+    }
+
+    template <typename Object>
+    void write_object(const Object& object, std::size_t depth) {
+        put('{');
+        bool first = true;
+        for (const auto& member : object) {
+            if (!first) {
+                put(',');
+            }
+            first = false;
+            if (options_.pretty) {
+                newline(depth + 1);
+            }
+            write_string(std::string_view{member.first.data(), member.first.size()});
+            put(':');
+            if (options_.pretty) {
+                put(' ');
+            }
+            write_value(member.second, depth + 1);
+        }
+        if (options_.pretty && !first) {
+            newline(depth);
+        }
+        put('}');
+    }
+
+    void write_integer(std::int64_t value) {
+        char* out = reserve(MAX_TOKEN);
+        // Negate in unsigned arithmetic so INT64_MIN does not overflow.
+        auto magnitude = static_cast<std::uint64_t>(value);
+        if (value < 0) {
+            *out++ = '-';
+            magnitude = ~magnitude + 1;
+        }
+        char digits[20];
+        char* p = digits + sizeof(digits);
+        while (magnitude >= 100) {
+            const auto pair = static_cast<std::size_t>(magnitude % 100) * 2;
+            magnitude /= 100;
+            p -= 2;
+            std::memcpy(p, DIGIT_PAIRS + pair, 2);
+        }
+        if (magnitude >= 10) {
+            p -= 2;
+            std::memcpy(p, DIGIT_PAIRS + static_cast<std::size_t>(magnitude) * 2, 2);
+        }
+        else {
+            *--p = static_cast<char>('0' + magnitude);
+        }
+        const auto count = static_cast<std::size_t>(digits + sizeof(digits) - p);
+        std::memcpy(out, p, count);
+        used_ = static_cast<std::size_t>(out + count - buffer_);
+    }
+
+    // Shortest representation that parses back to the same double. JSON has no NaN or
+    // infinity, so those are written as null. Integral values keep a ".0" so that reading the
+    // output back yields Floating again rather than Integer.
+    void write_floating(double value) {
+        if (!std::isfinite(value)) {
+            put("null");
+            return;
+        }
+        char* out = reserve(MAX_TOKEN);
+        const auto res = std::to_chars(out, out + MAX_TOKEN, value);
+        char* end = res.ptr;
+        if (std::memchr(out, '.', static_cast<std::size_t>(end - out)) == nullptr &&
+            std::memchr(out, 'e', static_cast<std::size_t>(end - out)) == nullptr) {
+            *end++ = '.';
+            *end++ = '0';
+        }
+        used_ = static_cast<std::size_t>(end - buffer_);
+    }
+
+    void write_string(std::string_view s) {
+        static constexpr char HEX[] = "0123456789abcdef";
+        put('"');
+        const char* p = s.data();
+        const char* const end = p + s.size();
+        while (p != end) {
+            const char* special = find_string_special(p, end);
+            put(p, static_cast<std::size_t>(special - p));
+            if (special == end) {
+                break;
+            }
+            char* out = reserve(6);
+            const auto c = static_cast<unsigned char>(*special);
+            std::size_t n = 2;
+            out[0] = '\\';
+            switch (c) {
+                case '"':
+                    out[1] = '"';
+                    break;
+                case '\\':
+                    out[1] = '\\';
+                    break;
+                case '\b':
+                    out[1] = 'b';
+                    break;
+                case '\f':
+                    out[1] = 'f';
+                    break;
+                case '\n':
+                    out[1] = 'n';
+                    break;
+                case '\r':
+                    out[1] = 'r';
+                    break;
+                case '\t':
+                    out[1] = 't';
+                    break;
+                default:
+                    std::memcpy(out + 1, "u00", 3);
+                    out[4] = HEX[c >> 4];
+                    out[5] = HEX[c & 0xF];
+                    n = 6;
+                    break;
+            }
+            used_ += n;
+            p = special + 1;
+        }
+        put('"');
+    }
+};
+
+} // namespace config_detail
+
+/**
+ * @brief Serialize @p value as JSON (RFC 8259) into @p sink.
+ *
+ * Output is UTF-8 as stored (strings are not validated); '"', '\\' and control characters are
+ * escaped. Objects are written in their iteration order. Doubles use the shortest form that
+ * reads back to the same value, with NaN and infinities written as null. parse_json() of the
+ * output reproduces the value, including the Integer / Floating distinction.
+ *
+ * @code
+ * std::string out;
+ * to_json(cfg, out);                                   // {"port":8080,"hosts":["a","b"]}
+ * to_json(cfg, out, JsonWriteOptions{.pretty = true}); // indented, one member per line
+ * @endcode
+ */
+template <typename Alloc, typename ObjectPolicy, JsonSink Sink>
+void to_json(const BasicConfigValue<Alloc, ObjectPolicy>& value, Sink& sink, const JsonWriteOptions& options = {}) {
+    config_detail::JsonWriter<Sink> writer{sink, options};
+    writer.write(value);
+    writer.finish();
+}
+
+/// Serialize @p value as JSON into a new std::string.
+template <typename Alloc, typename ObjectPolicy>
+[[nodiscard]] std::string to_json(const BasicConfigValue<Alloc, ObjectPolicy>& value,
+                                  const JsonWriteOptions& options = {}) {
+    std::string out;
+    to_json(value, out, options);
+    return out;
+}
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_JSON_WRITE_HPP
@@ -0,0 +1,379 @@
+#ifndef NFRRCONFIG_IMPL_LAZY_DOCUMENT_HPP
+#define NFRRCONFIG_IMPL_LAZY_DOCUMENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "basic_config_value.hpp"
+#include "config_path.hpp"
+#include "enums.hpp"
+#include "json_handler.hpp"
+#include "json_index.hpp"
+#include "json_parse.hpp"
+
+namespace nfrr::config {
+
+namespace config_detail {
+// Decodes the key string that starts at a given offset (escapes included) without building values.
+class JsonKeyReader : public JsonCursor {
+  public:
+    using JsonCursor::JsonCursor;
+
+    std::expected<std::string_view, DocumentError> key_at(std::size_t offset) {
+        cur_ = begin_ + offset;
+        std::string_view key;
+        if (!parse_string(key)) {
+            return std::unexpected(error_);
+        }
+        return key;
+    }
+};
+} // namespace config_detail
+
+/**
+ * @brief Read-only JSON document that builds BasicConfigValue subtrees only when they are accessed.
+ *
+ * parse() keeps the raw text, runs stage one of the two-stage parser (JsonStructuralIndex) and
+ * derives a skip table mapping every '{' / '[' entry to its matching close. Nothing else is
+ * decoded or allocated up front. A lookup walks the index: the skip table hops over sibling
+ * values without looking inside them, and only keys on the path are decoded. The subtree at
+ * the end of the path is then materialized once (through the document's allocator) and cached,
+ * so later lookups into it, or into its descendants, resolve against the cached tree.
+ *
+ * Paths use the ConfigPath syntaxes ("a.b[2]" or "/a/b/2"). Duplicate keys resolve to the last
+ * occurrence, as in parse_json().
+ *
+ * Validation is on demand as well: parse() only checks bracket balance, and a syntax error
+ * inside a subtree is reported when that subtree is first accessed.
+ *
+ * @note Lookups mutate the cache, so a document must not be accessed from several threads at
+ *       once. Returned pointers and references stay valid for the lifetime of the document.
+ */
+template <typename Alloc = std::allocator<std::byte>, typename ObjectPolicy = DefaultObjectPolicy>
+class LazyConfigDocument {
+  public:
+    using allocator_type = Alloc;
+    using value_type = BasicConfigValue<Alloc, ObjectPolicy>;
+
+    /**
+     * @brief Index @p text (taking ownership of it) without building any value.
+     *
+     * Fails on unbalanced brackets, an empty document or trailing content after the root value.
+     */
+    [[nodiscard]] static std::expected<LazyConfigDocument, DocumentError>
+    parse(std::string text, const allocator_type& alloc = allocator_type{}, SimdLevel level = detected_simd_level()) {
+        LazyConfigDocument doc{std::move(text), alloc};
+        auto index = JsonStructuralIndex::build(doc.text_, level);
+        if (!index) {
+            return std::unexpected(index.error());
+        }
+        doc.index_ = std::move(*index);
+        if (auto ok = doc.build_skip_table(); !ok) {
+            return std::unexpected(ok.error());
+        }
+        return doc;
+    }
+
+    /**
+     * @brief Resolve @p path, materializing the target subtree if it is not cached yet.
+     *
+     * @return The target value, or KeyNotFound / IndexNotFound / TypeMismatch (with the offset
+     *         of the container being searched), or the syntax error met on the way.
+     */
+    [[nodiscard]] std::expected<const value_type*, DocumentError> resolve(const ConfigPath& path) {
+        const auto& segments = path.segments();
+        std::uint32_t entry = 0;
+        for (std::size_t s = 0; s < segments.size(); ++s) {
+            if (auto hit = materialized_.find(entry); hit != materialized_.end()) {
+                return resolve_cached(hit->second, segments, s, entry);
+            }
+            auto next = step(entry, segments[s]);
+            if (!next) {
+                return std::unexpected(next.error());
+            }
+            entry = *next;
+        }
+        return materialize(entry);
+    }
+
+    /// Parse @p path (ConfigPath syntax) and resolve it. A malformed path yields InvalidPath.
+    [[nodiscard]] std::expected<const value_type*, DocumentError> resolve(std::string_view path) {
+        auto compiled = ConfigPath::parse(path);
+        if (!compiled) {
+            return std::unexpected(DocumentError{ConfigError::InvalidPath, 0});
+        }
+        return resolve(*compiled);
+    }
+
+    /// Resolve @p path, returning nullptr if it does not exist or cannot be parsed.
+    [[nodiscard]] const value_type* find(std::string_view path) {
+        auto res = resolve(path);
+        return res ? *res : nullptr;
+    }
+
+    /**
+     * @brief Resolve @p path (ConfigPath syntax).
+     *
+     * @throws std::out_of_range if a step is missing or meets a non-container.
+     * @throws std::runtime_error if the accessed part of the document is malformed.
+     */
+    const value_type& at(std::string_view path) {
+        auto res = resolve(path);
+        if (!res) {
+            throw_for(res.error(), path);
+        }
+        return **res;
+    }
+
+    /**
+     * @brief Top-level member @p key. Unlike at(), the argument is a literal key, not a path.
+     *
+     * @throws std::out_of_range if the root is not an object or has no such key.
+     * @throws std::runtime_error if the accessed part of the document is malformed.
+     */
+    const value_type& operator[](std::string_view key) {
+        auto res = resolve(ConfigPath::from_segments(std::span<const std::string_view>{&key, 1}));
+        if (!res) {
+            throw_for(res.error(), key);
+        }
+        return **res;
+    }
+
+    /**
+     * @brief The whole document, materialized (equivalent to parse_json on the same text).
+     *
+     * @throws std::runtime_error if the document is malformed.
+     */
+    const value_type& root() {
+        auto res = materialize(0);
+        if (!res) {
+            throw_for(res.error(), {});
+        }
+        return **res;
+    }
+
+    /// Number of subtrees materialized so far.
+    [[nodiscard]] std::size_t materialized_count() const noexcept {
+        return materialized_.size();
+    }
+
+    /// The raw document text.
+    [[nodiscard]] std::string_view text() const noexcept {
+        return text_;
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_;
+    }
+
+  private:
+    std::string text_;
+    JsonStructuralIndex index_;
+    std::vector<std::uint32_t> skip_; // for '{' / '[' entries: index of the matching close entry
+    std::unordered_map<std::uint32_t, value_type> materialized_; // keyed by structural entry
+    allocator_type allocator_;
+
+    LazyConfigDocument(std::string text, const allocator_type& alloc) : text_{std::move(text)}, allocator_{alloc} {}
+
+    [[nodiscard]] std::uint32_t offset(std::uint32_t entry) const noexcept {
+        return index_.positions()[entry];
+    }
+
+    [[nodiscard]] char token(std::uint32_t entry) const noexcept {
+        return text_[offset(entry)];
+    }
+
+    [[nodiscard]] DocumentError error_at(ConfigError code, std::uint32_t entry) const noexcept {
+        return DocumentError{code, offset(entry)};
+    }
+
+    std::expected<void, DocumentError> build_skip_table() {
+        const std::size_t n = index_.size();
+        if (n == 0) {
+            return std::unexpected(DocumentError{ConfigError::UnexpectedEnd, text_.size()});
+        }
+        skip_.assign(n, 0);
+        std::vector<std::uint32_t> open;
+        for (std::uint32_t i = 0; i < n; ++i) {
+            const char c = token(i);
+            if (c == '{' || c == '[') {
+                open.push_back(i);
+            }
+            else if (c == '}' || c == ']') {
+                if (open.empty() || token(open.back()) != (c == '}' ? '{' : '[')) {
+                    return std::unexpected(error_at(ConfigError::SyntaxError, i));
+                }
+                skip_[open.back()] = i;
+                open.pop_back();
+            }
+        }
+        if (!open.empty()) {
+            return std::unexpected(DocumentError{ConfigError::UnexpectedEnd, text_.size()});
+        }
+        const std::uint32_t last = last_entry(0);
+        if (last + 1 != n) {
+            return std::unexpected(error_at(ConfigError::SyntaxError, last + 1));
+        }
+        return {};
+    }
+
+    // Last index entry of the value starting at @p entry.
+    [[nodiscard]] std::uint32_t last_entry(std::uint32_t entry) const noexcept {
+        const char c = token(entry);
+        return (c == '{' || c == '[') ? skip_[entry] : entry;
+    }
+
+    // Entry following the value that starts at @p entry; rejects entries that cannot start a value.
+    [[nodiscard]] std::expected<std::uint32_t, DocumentError> after_value(std::uint32_t entry) const noexcept {
+        const char c = token(entry);
+        if (c == '}' || c == ']' || c == ',' || c == ':') {
+            return std::unexpected(error_at(ConfigError::SyntaxError, entry));
+        }
+        return last_entry(entry) + 1;
+    }
+
+    // Entry after a member or element: ',' continues, @p close ends the container.
+    [[nodiscard]] std::expected<std::uint32_t, DocumentError> next_member(std::uint32_t value, char close) const {
+        auto next = after_value(value);
+        if (!next) {
+            return next;
+        }
+        const char c = token(*next);
+        if (c == ',') {
+            // A trailing comma is rejected here as it is by the eager parser.
+            if (token(*next + 1) == close) {
+                return std::unexpected(error_at(ConfigError::SyntaxError, *next + 1));
+            }
+            return *next + 1;
+        }
+        if (c == close) {
+            return *next;
+        }
+        return std::unexpected(error_at(ConfigError::SyntaxError, *next));
+    }
+
+    // Entry of the child selected by @p seg inside the container starting at @p entry.
+    std::expected<std::uint32_t, DocumentError> step(std::uint32_t entry, const ConfigPath::Segment& seg) {
+        const char c = token(entry);
+        if (c == '[') {
+            if (seg.index == ConfigPath::NO_INDEX) {
+                return std::unexpected(error_at(ConfigError::TypeMismatch, entry));
+            }
+            std::uint32_t e = entry + 1;
+            for (std::size_t i = 0; token(e) != ']'; ++i) {
+                if (i == seg.index) {
+                    return e;
+                }
+                auto next = next_member(e, ']');
+                if (!next) {
+                    return next;
+                }
+                e = *next;
+            }
+            return std::unexpected(error_at(ConfigError::IndexNotFound, entry));
+        }
+        if (c != '{' || seg.index_only) {
+            return std::unexpected(error_at(ConfigError::TypeMismatch, entry));
+        }
+
+        config_detail::JsonKeyReader keys{text_};
+        std::uint32_t found = 0;
+        std::uint32_t e = entry + 1;
+        while (token(e) != '}') {
+            if (token(e) != '"') {
+                return std::unexpected(error_at(ConfigError::SyntaxError, e));
+            }
+            auto key = keys.key_at(offset(e));
+            if (!key) {
+                return std::unexpected(key.error());
+            }
+            if (token(e + 1) != ':') {
+                return std::unexpected(error_at(ConfigError::SyntaxError, e + 1));
+            }
+            if (*key == seg.key) {
+                found = e + 2; // keep going: the last duplicate wins
+            }
+            auto next = next_member(e + 2, '}');
+            if (!next) {
+                return next;
+            }
+            e = *next;
+        }
+        if (found == 0) {
+            return std::unexpected(error_at(ConfigError::KeyNotFound, entry));
+        }
+        return found;
+    }
+
+    // Remaining steps of a path that entered an already materialized subtree.
+    std::expected<const value_type*, DocumentError> resolve_cached(const value_type& subtree,
+                                                                   const std::vector<ConfigPath::Segment>& segments,
+                                                                   std::size_t first, std::uint32_t entry) const {
+        const value_type* current = &subtree;
+        for (std::size_t s = first; s < segments.size(); ++s) {
+            const ConfigPath::Segment& seg = segments[s];
+            if (current->is_array()) {
+                if (seg.index == ConfigPath::NO_INDEX) {
+                    return std::unexpected(error_at(ConfigError::TypeMismatch, entry));
+                }
+                if (seg.index >= current->as_array().size()) {
+                    return std::unexpected(error_at(ConfigError::IndexNotFound, entry));
+                }
+                current = &current->as_array()[seg.index];
+            }
+            else if (current->is_object() && !seg.index_only) {
+                auto it = current->find(seg.key);
+                if (it == current->as_object().end()) {
+                    return std::unexpected(error_at(ConfigError::KeyNotFound, entry));
+                }
+                current = &it->second;
+            }
+            else {
+                return std::unexpected(error_at(ConfigError::TypeMismatch, entry));
+            }
+        }
+        return current;
+    }
+
+    std::expected<const value_type*, DocumentError> materialize(std::uint32_t entry) {
+        auto [it, inserted] = materialized_.try_emplace(entry, allocator_);
+        if (!inserted) {
+            return &it->second;
+        }
+        const std::uint32_t last = last_entry(entry);
+        JsonDomBuilder<value_type> builder{it->second};
+        config_detail::JsonIndexedReader<JsonDomBuilder<value_type>> reader{
+            text_, index_.positions().subspan(entry, last - entry + 1), builder};
+        if (auto ok = reader.read(); !ok) {
+            materialized_.erase(it);
+            return std::unexpected(ok.error());
+        }
+        return &it->second;
+    }
+
+    [[noreturn]] static void throw_for(const DocumentError& error, std::string_view what) {
+        const std::string where = " at offset " + std::to_string(error.offset);
+        switch (error.code) {
+            case ConfigError::KeyNotFound:
+            case ConfigError::IndexNotFound:
+            case ConfigError::TypeMismatch:
+            case ConfigError::InvalidPath:
+                throw std::out_of_range("LazyConfigDocument: cannot resolve '" + std::string(what) + "'" + where);
+            default:
+                throw std::runtime_error("LazyConfigDocument: malformed document" + where);
+        }
+    }
+};
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_LAZY_DOCUMENT_HPP
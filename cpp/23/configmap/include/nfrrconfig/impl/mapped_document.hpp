@@ -0,0 +1,234 @@
+#ifndef NFRRCONFIG_IMPL_MAPPED_DOCUMENT_HPP
+#define NFRRCONFIG_IMPL_MAPPED_DOCUMENT_HPP
+
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#define NFRRCONFIG_HAS_MMAP 1
+#else
+#define NFRRCONFIG_HAS_MMAP 0
+#endif
+
+#if NFRRCONFIG_HAS_MMAP
+
+#include <cerrno>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "basic_config_value.hpp"
+#include "config_path.hpp"
+#include "enums.hpp"
+#include "json_index.hpp"
+#include "json_parse.hpp"
+
+namespace nfrr::config {
+
+namespace config_detail {
+// Read-only private mapping of a whole file. Empty files are represented without a mapping.
+class MappedRegion {
+  public:
+    MappedRegion() noexcept = default;
+
+    MappedRegion(MappedRegion&& other) noexcept
+        : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)} {}
+
+    MappedRegion& operator=(MappedRegion&& other) noexcept {
+        if (this != &other) {
+            reset();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    MappedRegion(const MappedRegion&) = delete;
+    MappedRegion& operator=(const MappedRegion&) = delete;
+
+    ~MappedRegion() {
+        reset();
+    }
+
+    // Map @p path read-only. On failure returns IoError and leaves errno describing the cause.
+    static std::expected<MappedRegion, DocumentError> map(const char* path) {
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC); // NOLINT(cppcoreguidelines-pro-type-vararg)
+        if (fd < 0) {
+            return std::unexpected(DocumentError{ConfigError::IoError, 0});
+        }
+        MappedRegion region;
+        struct stat info {};
+        bool ok = ::fstat(fd, &info) == 0;
+        if (ok && !S_ISREG(info.st_mode)) {
+            errno = EINVAL;
+            ok = false;
+        }
+        if (ok && info.st_size > 0) {
+            void* addr = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            ok = addr != MAP_FAILED;
+            if (ok) {
+                region.data_ = static_cast<const char*>(addr);
+                region.size_ = static_cast<std::size_t>(info.st_size);
+            }
+        }
+        const int saved = errno;
+        ::close(fd); // the mapping keeps its own reference to the file
+        if (!ok) {
+            errno = saved;
+            return std::unexpected(DocumentError{ConfigError::IoError, 0});
+        }
+        return region;
+    }
+
+    // Access-pattern hint for the kernel's readahead; purely advisory, failures are ignored.
+    void advise(int advice) const noexcept {
+        if (data_ != nullptr) {
+            ::madvise(const_cast<char*>(data_), size_, advice); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+        }
+    }
+
+    [[nodiscard]] std::string_view text() const noexcept {
+        return {data_, size_};
+    }
+
+  private:
+    const char* data_{nullptr};
+    std::size_t size_{0};
+
+    void reset() noexcept {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char*>(data_), size_); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+};
+} // namespace config_detail
+
+/**
+ * @brief Read-only configuration parsed from a memory-mapped file, owning both the mapping and
+ *        the value tree.
+ *
+ * Created by load_file_mmap(). With the default ZeroCopyStringPolicy the tree's keys and strings
+ * view the mapped bytes, so the file is never copied into a std::string and unescaped strings
+ * are never copied at all; the mapping lives exactly as long as the document, which keeps those
+ * views valid. Moving the document does not move the mapping. Values copied out of root() own
+ * their strings and may outlive the document.
+ *
+ * The mapping is private and read-only: later writes to the file by other processes may or may
+ * not become visible through text(), but the parsed tree never changes.
+ */
+template <typename Alloc = std::allocator<std::byte>, typename ObjectPolicy = ZeroCopyStringPolicy<>>
+class MappedConfigDocument {
+  public:
+    using allocator_type = Alloc;
+    using value_type = BasicConfigValue<Alloc, ObjectPolicy>;
+
+    MappedConfigDocument(MappedConfigDocument&&) noexcept = default;
+    // Not noexcept for every allocator: a pmr tree moved across resources is copied.
+    MappedConfigDocument& operator=(MappedConfigDocument&&) = default;
+    MappedConfigDocument(const MappedConfigDocument&) = delete;
+    MappedConfigDocument& operator=(const MappedConfigDocument&) = delete;
+    ~MappedConfigDocument() = default;
+
+    /**
+     * @brief Map the file at @p path and parse it (see load_file_mmap()).
+     */
+    [[nodiscard]] static std::expected<MappedConfigDocument, DocumentError>
+    load(const std::filesystem::path& path, const allocator_type& alloc = allocator_type{},
+         SimdLevel level = detected_simd_level()) {
+        auto region = config_detail::MappedRegion::map(path.c_str());
+        if (!region) {
+            return std::unexpected(region.error());
+        }
+        const std::string_view text = region->text();
+
+        region->advise(MADV_SEQUENTIAL);
+        auto index = JsonStructuralIndex::build(text, level);
+        if (!index) {
+            return std::unexpected(index.error());
+        }
+        value_type root{alloc};
+        JsonDomBuilder<value_type> builder{root, text};
+        config_detail::JsonIndexedReader<JsonDomBuilder<value_type>> reader{text, index->positions(), builder};
+        if (auto parsed = reader.read(); !parsed) {
+            return std::unexpected(parsed.error());
+        }
+        region->advise(MADV_NORMAL);
+        return MappedConfigDocument{std::move(*region), std::move(root)};
+    }
+
+    /// The parsed document.
+    [[nodiscard]] const value_type& root() const noexcept {
+        return root_;
+    }
+
+    /// Resolve @p path (ConfigPath syntax), returning nullptr if it is missing or malformed.
+    [[nodiscard]] const value_type* find(std::string_view path) const {
+        auto compiled = ConfigPath::parse(path);
+        return compiled ? compiled->find(root_) : nullptr;
+    }
+
+    /**
+     * @brief Resolve @p path (ConfigPath syntax).
+     *
+     * @throws std::out_of_range if the path is malformed or does not exist.
+     */
+    [[nodiscard]] const value_type& at(std::string_view path) const {
+        if (const value_type* found = find(path)) {
+            return *found;
+        }
+        throw std::out_of_range{"MappedConfigDocument::at(): path not found"};
+    }
+
+    /// The mapped file contents.
+    [[nodiscard]] std::string_view text() const noexcept {
+        return region_.text();
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type{root_.get_allocator()};
+    }
+
+  private:
+    MappedConfigDocument(config_detail::MappedRegion region, value_type root) noexcept
+        : region_{std::move(region)}, root_{std::move(root)} {}
+
+    // Declaration order matters: root_ (which may view region_) is destroyed first.
+    config_detail::MappedRegion region_;
+    value_type root_;
+};
+
+/**
+ * @brief Map the JSON file at @p path and parse it into a MappedConfigDocument.
+ *
+ * The file is mapped read-only with MADV_SEQUENTIAL for the duration of the parse (the reader
+ * touches every page once, front to back) and MADV_NORMAL afterwards. Parsing uses the two-stage
+ * reader, see parse_json_indexed().
+ *
+ * @return The document, ConfigError::IoError (offset 0, errno set) if the file cannot be opened,
+ *         is not a regular file or cannot be mapped, or the parse error with its byte offset.
+ *
+ * @code
+ * auto doc = load_file_mmap("/etc/service/config.json");
+ * if (doc) { auto port = doc->at("server.port").get<int>(); }
+ * @endcode
+ */
+template <typename Alloc = std::allocator<std::byte>, typename ObjectPolicy = ZeroCopyStringPolicy<>>
+[[nodiscard]] std::expected<MappedConfigDocument<Alloc, ObjectPolicy>, DocumentError>
+load_file_mmap(const std::filesystem::path& path, const Alloc& alloc = Alloc{},
+               SimdLevel level = detected_simd_level()) {
+    return MappedConfigDocument<Alloc, ObjectPolicy>::load(path, alloc, level);
+}
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_HAS_MMAP
+
+#endif // NFRRCONFIG_IMPL_MAPPED_DOCUMENT_HPP
@@ -0,0 +1,447 @@
+#ifndef NFRRCONFIG_IMPL_MSGPACK_HPP
+#define NFRRCONFIG_IMPL_MSGPACK_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "basic_config_value.hpp"
+#include "bcv_impl.hpp"
+#include "enums.hpp"
+#include "json_index.hpp"
+#include "json_parse.hpp"
+#include "json_write.hpp"
+
+namespace nfrr::config {
+
+namespace config_detail {
+
+// MessagePack format bytes (see the MessagePack specification, "Formats").
+inline constexpr std::uint8_t MSGPACK_NIL = 0xC0;
+inline constexpr std::uint8_t MSGPACK_FALSE = 0xC2;
+inline constexpr std::uint8_t MSGPACK_TRUE = 0xC3;
+inline constexpr std::uint8_t MSGPACK_FLOAT32 = 0xCA;
+inline constexpr std::uint8_t MSGPACK_FLOAT64 = 0xCB;
+inline constexpr std::uint8_t MSGPACK_UINT8 = 0xCC;
+inline constexpr std::uint8_t MSGPACK_INT8 = 0xD0;
+inline constexpr std::uint8_t MSGPACK_STR8 = 0xD9;
+inline constexpr std::uint8_t MSGPACK_ARRAY16 = 0xDC;
+inline constexpr std::uint8_t MSGPACK_MAP16 = 0xDE;
+inline constexpr std::uint8_t MSGPACK_FIXSTR = 0xA0;
+inline constexpr std::uint8_t MSGPACK_FIXARRAY = 0x90;
+inline constexpr std::uint8_t MSGPACK_FIXMAP = 0x80;
+
+/**
+ * @brief Emits one BasicConfigValue in MessagePack, always choosing the smallest format
+ *        (fixint / fixstr / fixarray / fixmap where they fit, float32 when exact).
+ */
+template <JsonSink Sink>
+class MsgpackWriter {
+  public:
+    explicit MsgpackWriter(Sink& sink) noexcept : sink_{&sink} {}
+
+    template <typename Value>
+    void write(const Value& value) {
+        switch (value.kind()) {
+            case ConfigValueKind::Null:
+                put_byte(MSGPACK_NIL);
+                break;
+            case ConfigValueKind::Boolean:
+                put_byte(value.as_bool() ? MSGPACK_TRUE : MSGPACK_FALSE);
+                break;
+            case ConfigValueKind::Integer:
+                put_integer(value.as_integer());
+                break;
+            case ConfigValueKind::Floating:
+                put_floating(value.as_floating());
+                break;
+            case ConfigValueKind::String:
+                put_string(std::string_view{value.as_string().data(), value.as_string().size()});
+                break;
+            case ConfigValueKind::Array:
+                put_length(MSGPACK_FIXARRAY, 15, MSGPACK_ARRAY16, value.as_array().size());
+                for (const auto& element : value.as_array()) {
+                    write(element);
+                }
+                break;
+            case ConfigValueKind::Object:
+                put_length(MSGPACK_FIXMAP, 15, MSGPACK_MAP16, value.as_object().size());
+                for (const auto& member : value.as_object()) {
+                    put_string(std::string_view{member.first.data(), member.first.size()});
+                    write(member.second);
+                }
+                break;
+        }
+    }
+
+  private:
+    Sink* sink_;
+
+    void put_byte(std::uint8_t b) {
+        const auto c = static_cast<char>(b);
+        sink_->append(&c, 1);
+    }
+
+    // Format byte followed by @p bytes big-endian bytes of @p value.
+    void put_tagged(std::uint8_t format, std::uint64_t value, int bytes) {
+        char buf[9];
+        buf[0] = static_cast<char>(format);
+        for (int i = 0; i < bytes; ++i) {
+            buf[1 + i] = static_cast<char>(value >> (8 * (bytes - 1 - i)));
+        }
+        sink_->append(buf, static_cast<std::size_t>(1 + bytes));
+    }
+
+    void put_integer(std::int64_t i) {
+        if (i >= -32 && i <= 127) {
+            put_byte(static_cast<std::uint8_t>(i)); // positive / negative fixint
+            return;
+        }
+        if (i > 0) {
+            const auto u = static_cast<std::uint64_t>(i);
+            const int idx = u <= 0xFF ? 0 : u <= 0xFFFF ? 1 : u <= 0xFFFF'FFFF ? 2 : 3; // uint 8/16/32/64
+            put_tagged(static_cast<std::uint8_t>(MSGPACK_UINT8 + idx), u, 1 << idx);
+            return;
+        }
+        const int idx = i >= std::numeric_limits<std::int8_t>::min()    ? 0
+                        : i >= std::numeric_limits<std::int16_t>::min() ? 1
+                        : i >= std::numeric_limits<std::int32_t>::min() ? 2
+                                                                        : 3; // int 8/16/32/64
+        put_tagged(static_cast<std::uint8_t>(MSGPACK_INT8 + idx), static_cast<std::uint64_t>(i), 1 << idx);
+    }
+
+    void put_floating(double d) {
+        const auto single = static_cast<float>(d);
+        if (static_cast<double>(single) == d || std::isnan(d)) {
+            put_tagged(MSGPACK_FLOAT32, std::bit_cast<std::uint32_t>(single), 4);
+        }
+        else {
+            put_tagged(MSGPACK_FLOAT64, std::bit_cast<std::uint64_t>(d), 8);
+        }
+    }
+
+    // fix format up to fix_max entries, else the 16-bit / 32-bit format (wide16 and wide16 + 1).
+    void put_length(std::uint8_t fix, std::size_t fix_max, std::uint8_t wide16, std::size_t n) {
+        if (n <= fix_max) {
+            put_byte(static_cast<std::uint8_t>(fix | n));
+        }
+        else if (n <= 0xFFFF) {
+            put_tagged(wide16, n, 2);
+        }
+        else if (n <= 0xFFFF'FFFF) {
+            put_tagged(static_cast<std::uint8_t>(wide16 + 1), n, 4);
+        }
+        else {
+            throw std::length_error{"write_msgpack(): container or string exceeds 2^32 - 1 entries"};
+        }
+    }
+
+    void put_string(std::string_view s) {
+        if (s.size() > 31 && s.size() <= 0xFF) {
+            put_tagged(MSGPACK_STR8, s.size(), 1);
+        }
+        else {
+            // fixstr, or str16 / str32 (0xDA / 0xDB).
+            put_length(MSGPACK_FIXSTR, 31, static_cast<std::uint8_t>(MSGPACK_STR8 + 1), s.size());
+        }
+        sink_->append(s.data(), s.size());
+    }
+};
+
+/**
+ * @brief Decodes one MessagePack object from a buffer into a BasicConfigValue.
+ *
+ * Every string, array and object is created through the target value's allocator, and
+ * containers are reserve()d from their length prefix (capped by the bytes left, so a bogus
+ * prefix cannot trigger a huge allocation). bin and ext have no ConfigValueKind and fail with
+ * TypeMismatch, as do non-string map keys; uint64 values above INT64_MAX become Floating.
+ */
+template <typename Value>
+class MsgpackDecoder {
+  public:
+    explicit MsgpackDecoder(std::string_view bytes) noexcept
+        : begin_{reinterpret_cast<const unsigned char*>(bytes.data())}, cur_{begin_}, end_{begin_ + bytes.size()} {}
+
+    std::expected<void, DocumentError> decode(Value& out) {
+        if (!item(out, 0)) {
+            return std::unexpected(error_);
+        }
+        return {};
+    }
+
+    [[nodiscard]] std::size_t offset() const noexcept {
+        return static_cast<std::size_t>(cur_ - begin_);
+    }
+
+  private:
+    const unsigned char* begin_;
+    const unsigned char* cur_;
+    const unsigned char* end_;
+    DocumentError error_{};
+
+    bool fail(ConfigError code, const unsigned char* at) noexcept {
+        error_ = DocumentError{code, static_cast<std::size_t>(at - begin_)};
+        return false;
+    }
+
+    [[nodiscard]] std::size_t remaining() const noexcept {
+        return static_cast<std::size_t>(end_ - cur_);
+    }
+
+    // Big-endian unsigned of @p bytes bytes at cur_ (advancing), false if truncated.
+    bool read_be(int bytes, std::uint64_t& out) noexcept {
+        if (remaining() < static_cast<std::size_t>(bytes)) {
+            return fail(ConfigError::UnexpectedEnd, end_);
+        }
+        std::uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) {
+            v = (v << 8) | cur_[i];
+        }
+        cur_ += bytes;
+        out = v;
+        return true;
+    }
+
+    bool read_string(std::uint64_t length, std::string_view& out) noexcept {
+        if (remaining() < length) {
+            return fail(ConfigError::UnexpectedEnd, end_);
+        }
+        out = {reinterpret_cast<const char*>(cur_), static_cast<std::size_t>(length)};
+        cur_ += length;
+        return true;
+    }
+
+    // Length of a str value whose format byte is @p format, or false if it is not a str.
+    bool string_length(std::uint8_t format, std::uint64_t& length) noexcept {
+        if ((format & 0xE0) == MSGPACK_FIXSTR) {
+            length = format & 0x1F;
+            return true;
+        }
+        if (format >= MSGPACK_STR8 && format <= MSGPACK_STR8 + 2) {
+            return read_be(1 << (format - MSGPACK_STR8), length);
+        }
+        return false;
+    }
+
+    bool item(Value& out, std::size_t depth) {
+        const unsigned char* start = cur_;
+        if (cur_ == end_) {
+            return fail(ConfigError::UnexpectedEnd, end_);
+        }
+        const std::uint8_t format = *cur_++;
+        std::uint64_t n = 0;
+
+        if (format <= 0x7F) {
+            out.set_integer(format);
+            return true;
+        }
+        if (format >= 0xE0) {
+            out.set_integer(static_cast<std::int8_t>(format));
+            return true;
+        }
+        if ((format & 0xF0) == MSGPACK_FIXMAP) {
+            return map(format & 0x0F, out, depth, start);
+        }
+        if ((format & 0xF0) == MSGPACK_FIXARRAY) {
+            return array(format & 0x0F, out, depth, start);
+        }
+        if (string_length(format, n)) {
+            std::string_view s;
+            if (!read_string(n, s)) {
+                return false;
+            }
+            out.set_string(s);
+            return true;
+        }
+        if (error_.code != ConfigError::None) {
+            return false; // truncated str8/16/32 length
+        }
+        switch (format) {
+            case MSGPACK_NIL:
+                out.set_null();
+                return true;
+            case MSGPACK_FALSE:
+                out.set_bool(false);
+                return true;
+            case MSGPACK_TRUE:
+                out.set_bool(true);
+                return true;
+            case MSGPACK_FLOAT32:
+                if (!read_be(4, n)) {
+                    return false;
+                }
+                out.set_floating(static_cast<double>(std::bit_cast<float>(static_cast<std::uint32_t>(n))));
+                return true;
+            case MSGPACK_FLOAT64:
+                if (!read_be(8, n)) {
+                    return false;
+                }
+                out.set_floating(std::bit_cast<double>(n));
+                return true;
+            case 0xCC: // uint 8/16/32/64
+            case 0xCD:
+            case 0xCE:
+            case 0xCF:
+                if (!read_be(1 << (format - MSGPACK_UINT8), n)) {
+                    return false;
+                }
+                if (n <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) {
+                    out.set_integer(static_cast<std::int64_t>(n));
+                }
+                else {
+                    out.set_floating(static_cast<double>(n));
+                }
+                return true;
+            case 0xD0: // int 8/16/32/64
+            case 0xD1:
+            case 0xD2:
+            case 0xD3: {
+                const int bytes = 1 << (format - MSGPACK_INT8);
+                if (!read_be(bytes, n)) {
+                    return false;
+                }
+                // Sign-extend from the encoded width.
+                const int shift = 64 - 8 * bytes;
+                out.set_integer(static_cast<std::int64_t>(n << shift) >> shift);
+                return true;
+            }
+            case 0xDC: // array 16/32
+            case 0xDD:
+                if (!read_be(2 << (format - MSGPACK_ARRAY16), n)) {
+                    return false;
+                }
+                return array(n, out, depth, start);
+            case 0xDE: // map 16/32
+            case 0xDF:
+                if (!read_be(2 << (format - MSGPACK_MAP16), n)) {
+                    return false;
+                }
+                return map(n, out, depth, start);
+            case 0xC1: // never used
+                return fail(ConfigError::SyntaxError, start);
+            default: // bin, ext, fixext
+                return fail(ConfigError::TypeMismatch, start);
+        }
+    }
+
+    bool array(std::uint64_t count, Value& out, std::size_t depth, const unsigned char* start) {
+        if (depth >= NFRRCONFIG_JSON_MAX_DEPTH) {
+            return fail(ConfigError::DepthExceeded, start);
+        }
+        out.set_array();
+        auto& elements = out.as_array();
+        elements.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(count, remaining())));
+        for (std::uint64_t i = 0; i < count; ++i) {
+            if (!item(append_null(elements), depth + 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool map(std::uint64_t count, Value& out, std::size_t depth, const unsigned char* start) {
+        if (depth >= NFRRCONFIG_JSON_MAX_DEPTH) {
+            return fail(ConfigError::DepthExceeded, start);
+        }
+        out.set_object();
+        auto& members = out.as_object();
+        members.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(count, remaining() / 2)));
+        for (std::uint64_t i = 0; i < count; ++i) {
+            const unsigned char* key_at = cur_;
+            if (cur_ == end_) {
+                return fail(ConfigError::UnexpectedEnd, end_);
+            }
+            std::uint64_t length = 0;
+            std::string_view key;
+            if (!string_length(*cur_++, length)) {
+                return error_.code != ConfigError::None ? false : fail(ConfigError::TypeMismatch, key_at);
+            }
+            if (!read_string(length, key)) {
+                return false;
+            }
+            // Duplicate keys keep their first position and take the last value.
+            if (!item(members.try_emplace(key).first->second, depth + 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace config_detail
+
+/**
+ * @brief Encode @p value as one MessagePack object, appending it to @p sink.
+ *
+ * @throws std::length_error for strings or containers with more than 2^32 - 1 entries.
+ */
+template <typename Alloc, typename ObjectPolicy, JsonSink Sink>
+void write_msgpack(const BasicConfigValue<Alloc, ObjectPolicy>& value, Sink& sink) {
+    config_detail::MsgpackWriter<Sink> writer{sink};
+    writer.write(value);
+}
+
+/// Encode @p value as MessagePack into a new buffer.
+template <typename Alloc, typename ObjectPolicy>
+[[nodiscard]] std::string to_msgpack(const BasicConfigValue<Alloc, ObjectPolicy>& value) {
+    std::string out;
+    write_msgpack(value, out);
+    return out;
+}
+
+/**
+ * @brief Decode the single MessagePack object in @p bytes.
+ *
+ * All nested strings, arrays and objects come from @p alloc. Malformed input never throws:
+ * the result carries UnexpectedEnd (truncated), SyntaxError (0xC1, trailing bytes),
+ * TypeMismatch (bin / ext, non-string keys) or DepthExceeded, with the byte offset.
+ */
+template <typename Alloc = std::allocator<std::byte>, typename ObjectPolicy = DefaultObjectPolicy>
+    requires(!std::is_base_of_v<std::pmr::memory_resource, Alloc>) // see the arena overload below
+[[nodiscard]] std::expected<BasicConfigValue<Alloc, ObjectPolicy>, DocumentError>
+parse_msgpack(std::string_view bytes, const Alloc& alloc = Alloc{}) {
+    using Value = BasicConfigValue<Alloc, ObjectPolicy>;
+    Value root{alloc};
+    config_detail::MsgpackDecoder<Value> decoder{bytes};
+    if (auto ok = decoder.decode(root); !ok) {
+        return std::unexpected(ok.error());
+    }
+    if (decoder.offset() != bytes.size()) {
+        return std::unexpected(DocumentError{ConfigError::SyntaxError, decoder.offset()});
+    }
+    return root;
+}
+
+/**
+ * @brief Decode @p bytes into a tree allocated entirely from @p arena.
+ *
+ * Meant for a std::pmr::monotonic_buffer_resource (or another arena): nothing is freed
+ * piecemeal, so discarding a decoded message is one release() of the arena instead of a
+ * deallocation per node. The tree must be destroyed before the arena is released.
+ *
+ * @code
+ * std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer)};
+ * auto msg = parse_msgpack(bytes, arena);
+ * ...
+ * msg.reset(); // or let it go out of scope
+ * arena.release();
+ * @endcode
+ */
+[[nodiscard]] inline std::expected<BasicConfigValue<std::pmr::polymorphic_allocator<std::byte>>, DocumentError>
+parse_msgpack(std::string_view bytes, std::pmr::memory_resource& arena) {
+    return parse_msgpack(bytes, std::pmr::polymorphic_allocator<std::byte>{&arena});
+}
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_MSGPACK_HPP
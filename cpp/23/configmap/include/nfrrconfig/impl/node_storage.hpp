@@ -0,0 +1,577 @@
+#ifndef NFRRCONFIG_IMPL_NODE_STORAGE_HPP
+#define NFRRCONFIG_IMPL_NODE_STORAGE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace nfrr::config::config_detail {
+
+// Node storage: what a BasicConfigValue keeps per node, i.e. the alternative that is active plus
+// the allocator for nested storage. Both layouts share one interface, modelled on std::variant:
+//   index(), emplace<T>(args...), get<T>() (throws std::bad_variant_access), get_if<T>(),
+//   get_allocator(), construction from an allocator, and move construction / assignment that
+//   transfer the payload together with its allocator. Copies go through BasicConfigValue's
+//   rebuild_storage(), so no layout is copyable; SharedNodeStorage adds share() on top.
+// Alternatives are, by index: std::monostate, bool, std::int64_t, double, String, Array, Object.
+
+template <typename T, typename String, typename Array, typename Object>
+inline constexpr std::size_t NODE_INDEX = std::is_same_v<T, std::monostate> ? 0
+                                          : std::is_same_v<T, bool>         ? 1
+                                          : std::is_same_v<T, std::int64_t> ? 2
+                                          : std::is_same_v<T, double>       ? 3
+                                          : std::is_same_v<T, String>       ? 4
+                                          : std::is_same_v<T, Array>        ? 5
+                                          : std::is_same_v<T, Object>       ? 6
+                                                                            : 7;
+
+/// Default layout: a std::variant holding every alternative inline, next to the allocator.
+template <typename Alloc, typename String, typename Array, typename Object>
+class VariantNodeStorage {
+  public:
+    using allocator_type = Alloc;
+
+    VariantNodeStorage() = default;
+    explicit VariantNodeStorage(const allocator_type& alloc) noexcept : allocator_{alloc} {}
+
+    VariantNodeStorage(VariantNodeStorage&&) noexcept = default;
+
+    // polymorphic_allocator is not assignable; callers only hand it storage on an equal allocator.
+    VariantNodeStorage& operator=(VariantNodeStorage&& other) noexcept(std::is_nothrow_move_assignable_v<Variant>) {
+        variant_ = std::move(other.variant_);
+        if constexpr (std::is_move_assignable_v<allocator_type>) {
+            allocator_ = std::move(other.allocator_);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] std::size_t index() const noexcept {
+        return variant_.index();
+    }
+
+    template <typename T, typename... Args>
+    T& emplace(Args&&... args) {
+        return variant_.template emplace<T>(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    [[nodiscard]] T& get() {
+        return std::get<T>(variant_);
+    }
+
+    template <typename T>
+    [[nodiscard]] const T& get() const {
+        return std::get<T>(variant_);
+    }
+
+    template <typename T>
+    [[nodiscard]] T* get_if() noexcept {
+        return std::get_if<T>(&variant_);
+    }
+
+    template <typename T>
+    [[nodiscard]] const T* get_if() const noexcept {
+        return std::get_if<T>(&variant_);
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_;
+    }
+
+  private:
+    using Variant = std::variant<std::monostate, bool, std::int64_t, double, String, Array, Object>;
+
+    Variant variant_;
+    [[no_unique_address]] allocator_type allocator_{};
+};
+
+// Kind tag plus allocator for CompactNodeStorage. In general the tag is a byte next to the
+// allocator (nothing else for stateless allocators); polymorphic_allocator is one pointer to an
+// over-aligned memory_resource, so the tag lives in the pointer's low bits.
+template <typename Alloc>
+class CompactTagWord {
+  public:
+    CompactTagWord() = default;
+    explicit CompactTagWord(const Alloc& alloc) noexcept : allocator_{alloc} {}
+
+    [[nodiscard]] std::size_t tag() const noexcept {
+        return tag_;
+    }
+    void set_tag(std::size_t tag) noexcept {
+        tag_ = static_cast<std::uint8_t>(tag);
+    }
+    [[nodiscard]] Alloc allocator() const noexcept {
+        return allocator_;
+    }
+
+  private:
+    std::uint8_t tag_ = 0;
+    [[no_unique_address]] Alloc allocator_{};
+};
+
+template <typename T>
+class CompactTagWord<std::pmr::polymorphic_allocator<T>> {
+  public:
+    using allocator_type = std::pmr::polymorphic_allocator<T>;
+
+    CompactTagWord() noexcept : CompactTagWord{allocator_type{}} {}
+    explicit CompactTagWord(const allocator_type& alloc) noexcept
+        : bits_{reinterpret_cast<std::uintptr_t>(alloc.resource())} {}
+
+    [[nodiscard]] std::size_t tag() const noexcept {
+        return bits_ & TAG_MASK;
+    }
+    void set_tag(std::size_t tag) noexcept {
+        bits_ = (bits_ & ~TAG_MASK) | tag;
+    }
+    [[nodiscard]] allocator_type allocator() const noexcept {
+        return allocator_type{reinterpret_cast<std::pmr::memory_resource*>(bits_ & ~TAG_MASK)};
+    }
+
+  private:
+    static constexpr std::uintptr_t TAG_MASK = 7;
+    static_assert(alignof(std::pmr::memory_resource) > TAG_MASK, "memory_resource pointers need 3 free low bits");
+
+    std::uintptr_t bits_;
+};
+
+/**
+ * @brief Compact layout: a tag plus an 8-byte payload, 16 bytes per node for std::allocator and
+ *        std::pmr::polymorphic_allocator.
+ *
+ * Scalars live in the payload. Strings, arrays and objects are allocated out of line through the
+ * node's allocator (rebound) and the payload points at them; as those containers carry their own
+ * allocator, a node only needs one for creating them, and for pmr that shares the tag's word.
+ */
+template <typename Alloc, typename String, typename Array, typename Object>
+class CompactNodeStorage {
+  public:
+    using allocator_type = Alloc;
+
+    CompactNodeStorage() noexcept = default;
+    explicit CompactNodeStorage(const allocator_type& alloc) noexcept : word_{alloc} {}
+
+    CompactNodeStorage(CompactNodeStorage&& other) noexcept : payload_{other.payload_}, word_{other.word_} {
+        other.word_.set_tag(0);
+    }
+
+    CompactNodeStorage& operator=(CompactNodeStorage&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            payload_ = other.payload_;
+            word_ = other.word_;
+            other.word_.set_tag(0);
+        }
+        return *this;
+    }
+
+    ~CompactNodeStorage() {
+        destroy();
+    }
+
+    [[nodiscard]] std::size_t index() const noexcept {
+        return word_.tag();
+    }
+
+    template <typename T, typename... Args>
+    T& emplace(Args&&... args) {
+        constexpr std::size_t I = NODE_INDEX<T, String, Array, Object>;
+        static_assert(I < 7, "CompactNodeStorage::emplace(): not a node alternative");
+        // Build the new payload before releasing the old one: args may refer into it.
+        Payload next{};
+        if constexpr (I == 1) {
+            next.boolean = bool(std::forward<Args>(args)...);
+        }
+        else if constexpr (I == 2) {
+            next.integer = std::int64_t(std::forward<Args>(args)...);
+        }
+        else if constexpr (I == 3) {
+            next.floating = double(std::forward<Args>(args)...);
+        }
+        else if constexpr (I >= 4) {
+            next.*member<T>() = create<T>(std::forward<Args>(args)...);
+        }
+        destroy();
+        payload_ = next;
+        word_.set_tag(I);
+        return *get_if<T>();
+    }
+
+    template <typename T>
+    [[nodiscard]] T& get() {
+        if (T* p = get_if<T>()) {
+            return *p;
+        }
+        throw std::bad_variant_access{};
+    }
+
+    template <typename T>
+    [[nodiscard]] const T& get() const {
+        if (const T* p = get_if<T>()) {
+            return *p;
+        }
+        throw std::bad_variant_access{};
+    }
+
+    template <typename T>
+    [[nodiscard]] T* get_if() noexcept {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        return const_cast<T*>(std::as_const(*this).template get_if<T>());
+    }
+
+    template <typename T>
+    [[nodiscard]] const T* get_if() const noexcept {
+        constexpr std::size_t I = NODE_INDEX<T, String, Array, Object>;
+        if (word_.tag() != I) {
+            return nullptr;
+        }
+        if constexpr (I == 0) {
+            static constexpr std::monostate NONE{};
+            return &NONE;
+        }
+        else if constexpr (I == 1) {
+            return &payload_.boolean;
+        }
+        else if constexpr (I == 2) {
+            return &payload_.integer;
+        }
+        else if constexpr (I == 3) {
+            return &payload_.floating;
+        }
+        else {
+            return payload_.*member<T>();
+        }
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return word_.allocator();
+    }
+
+  private:
+    union Payload {
+        bool boolean;
+        std::int64_t integer;
+        double floating;
+        String* string;
+        Array* array;
+        Object* object;
+    };
+
+    Payload payload_{};
+    CompactTagWord<Alloc> word_{};
+
+    template <typename T>
+    static constexpr auto member() noexcept {
+        if constexpr (std::is_same_v<T, String>) {
+            return &Payload::string;
+        }
+        else if constexpr (std::is_same_v<T, Array>) {
+            return &Payload::array;
+        }
+        else {
+            return &Payload::object;
+        }
+    }
+
+    template <typename T>
+    using allocator_for = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        allocator_for<T> alloc{word_.allocator()};
+        T* p = std::allocator_traits<allocator_for<T>>::allocate(alloc, 1);
+        try {
+            // Plain construction: the arguments already carry the payload's allocator.
+            std::construct_at(p, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            std::allocator_traits<allocator_for<T>>::deallocate(alloc, p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    template <typename T>
+    void release(T* p) noexcept {
+        allocator_for<T> alloc{word_.allocator()};
+        std::destroy_at(p);
+        std::allocator_traits<allocator_for<T>>::deallocate(alloc, p, 1);
+    }
+
+    void destroy() noexcept {
+        switch (word_.tag()) {
+            case 4:
+                release(payload_.string);
+                break;
+            case 5:
+                release(payload_.array);
+                break;
+            case 6:
+                release(payload_.object);
+                break;
+            default:
+                break;
+        }
+        word_.set_tag(0);
+    }
+};
+
+// Reference count heading every out-of-line payload of SharedNodeStorage.
+struct SharedCount {
+    std::atomic<std::size_t> refs{1};
+};
+
+template <typename T>
+struct SharedBox : SharedCount {
+    template <typename... Args>
+    explicit SharedBox(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+    T value;
+};
+
+/**
+ * @brief Copy-on-write layout: CompactNodeStorage whose strings, arrays and objects are reference
+ *        counted, so several nodes can share one payload.
+ *
+ * share() returns another node referring to the same payload in O(1). A shared payload is
+ * treated as immutable: non-const access (get(), get_if()) first gives this node a private copy,
+ * so writes never show through the other nodes. Only nodes with equal allocators may share, as
+ * whichever releases the payload last frees it with its own allocator. Counts are atomic, so
+ * sharing nodes may live in different threads; a single node is no more thread-safe than before.
+ */
+template <typename Alloc, typename String, typename Array, typename Object>
+class SharedNodeStorage {
+  public:
+    using allocator_type = Alloc;
+
+    SharedNodeStorage() noexcept = default;
+    explicit SharedNodeStorage(const allocator_type& alloc) noexcept : word_{alloc} {}
+
+    SharedNodeStorage(SharedNodeStorage&& other) noexcept : payload_{other.payload_}, word_{other.word_} {
+        other.word_.set_tag(0);
+    }
+
+    SharedNodeStorage& operator=(SharedNodeStorage&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            payload_ = other.payload_;
+            word_ = other.word_;
+            other.word_.set_tag(0);
+        }
+        return *this;
+    }
+
+    ~SharedNodeStorage() {
+        destroy();
+    }
+
+    /// Another node with the same allocator and value, sharing the payload if there is one.
+    [[nodiscard]] SharedNodeStorage share() const noexcept {
+        SharedNodeStorage out{word_.allocator()};
+        if (SharedCount* count = shared_count()) {
+            count->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        out.payload_ = payload_;
+        out.word_.set_tag(word_.tag());
+        return out;
+    }
+
+    /// Number of nodes referring to the payload; 0 for scalars, which have none.
+    [[nodiscard]] std::size_t use_count() const noexcept {
+        const SharedCount* count = shared_count();
+        return count != nullptr ? count->refs.load(std::memory_order_relaxed) : 0;
+    }
+
+    /// Address of the payload (nullptr for scalars): nodes sharing it report the same identity.
+    [[nodiscard]] const void* identity() const noexcept {
+        return shared_count();
+    }
+
+    [[nodiscard]] std::size_t index() const noexcept {
+        return word_.tag();
+    }
+
+    template <typename T, typename... Args>
+    T& emplace(Args&&... args) {
+        constexpr std::size_t I = NODE_INDEX<T, String, Array, Object>;
+        static_assert(I < 7, "SharedNodeStorage::emplace(): not a node alternative");
+        // Build the new payload before releasing the old one: args may refer into it.
+        Payload next{};
+        if constexpr (I == 1) {
+            next.boolean = bool(std::forward<Args>(args)...);
+        }
+        else if constexpr (I == 2) {
+            next.integer = std::int64_t(std::forward<Args>(args)...);
+        }
+        else if constexpr (I == 3) {
+            next.floating = double(std::forward<Args>(args)...);
+        }
+        else if constexpr (I >= 4) {
+            next.*member<T>() = create<T>(std::forward<Args>(args)...);
+        }
+        destroy();
+        payload_ = next;
+        word_.set_tag(I);
+        return *get_if<T>();
+    }
+
+    template <typename T>
+    [[nodiscard]] T& get() {
+        if (T* p = get_if<T>()) {
+            return *p;
+        }
+        throw std::bad_variant_access{};
+    }
+
+    template <typename T>
+    [[nodiscard]] const T& get() const {
+        if (const T* p = get_if<T>()) {
+            return *p;
+        }
+        throw std::bad_variant_access{};
+    }
+
+    /// Mutable access: unshares a string, array or object payload first.
+    template <typename T>
+    [[nodiscard]] T* get_if() {
+        constexpr std::size_t I = NODE_INDEX<T, String, Array, Object>;
+        if constexpr (I >= 4) {
+            if (word_.tag() == I) {
+                unshare<T>();
+            }
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        return const_cast<T*>(std::as_const(*this).template get_if<T>());
+    }
+
+    template <typename T>
+    [[nodiscard]] const T* get_if() const noexcept {
+        constexpr std::size_t I = NODE_INDEX<T, String, Array, Object>;
+        if (word_.tag() != I) {
+            return nullptr;
+        }
+        if constexpr (I == 0) {
+            static constexpr std::monostate NONE{};
+            return &NONE;
+        }
+        else if constexpr (I == 1) {
+            return &payload_.boolean;
+        }
+        else if constexpr (I == 2) {
+            return &payload_.integer;
+        }
+        else if constexpr (I == 3) {
+            return &payload_.floating;
+        }
+        else {
+            return &(payload_.*member<T>())->value;
+        }
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return word_.allocator();
+    }
+
+  private:
+    union Payload {
+        bool boolean;
+        std::int64_t integer;
+        double floating;
+        SharedBox<String>* string;
+        SharedBox<Array>* array;
+        SharedBox<Object>* object;
+    };
+
+    Payload payload_{};
+    CompactTagWord<Alloc> word_{};
+
+    template <typename T>
+    static constexpr auto member() noexcept {
+        if constexpr (std::is_same_v<T, String>) {
+            return &Payload::string;
+        }
+        else if constexpr (std::is_same_v<T, Array>) {
+            return &Payload::array;
+        }
+        else {
+            return &Payload::object;
+        }
+    }
+
+    template <typename T>
+    using allocator_for = typename std::allocator_traits<Alloc>::template rebind_alloc<SharedBox<T>>;
+
+    [[nodiscard]] SharedCount* shared_count() const noexcept {
+        switch (word_.tag()) {
+            case 4:
+                return payload_.string;
+            case 5:
+                return payload_.array;
+            case 6:
+                return payload_.object;
+            default:
+                return nullptr;
+        }
+    }
+
+    template <typename T, typename... Args>
+    SharedBox<T>* create(Args&&... args) {
+        allocator_for<T> alloc{word_.allocator()};
+        SharedBox<T>* p = std::allocator_traits<allocator_for<T>>::allocate(alloc, 1);
+        try {
+            // Plain construction: the arguments already carry the payload's allocator.
+            std::construct_at(p, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            std::allocator_traits<allocator_for<T>>::deallocate(alloc, p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    template <typename T>
+    void release(SharedBox<T>* p) noexcept {
+        if (p->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            allocator_for<T> alloc{word_.allocator()};
+            std::destroy_at(p);
+            std::allocator_traits<allocator_for<T>>::deallocate(alloc, p, 1);
+        }
+    }
+
+    // Replace a shared payload by a private copy (made with this node's allocator).
+    template <typename T>
+    void unshare() {
+        SharedBox<T>*& box = payload_.*member<T>();
+        if (box->refs.load(std::memory_order_acquire) != 1) {
+            SharedBox<T>* copy = create<T>(std::as_const(box->value), typename T::allocator_type{word_.allocator()});
+            release(box);
+            box = copy;
+        }
+    }
+
+    void destroy() noexcept {
+        switch (word_.tag()) {
+            case 4:
+                release(payload_.string);
+                break;
+            case 5:
+                release(payload_.array);
+                break;
+            case 6:
+                release(payload_.object);
+                break;
+            default:
+                break;
+        }
+        word_.set_tag(0);
+    }
+};
+
+} // namespace nfrr::config::config_detail
+
+#endif // NFRRCONFIG_IMPL_NODE_STORAGE_HPP
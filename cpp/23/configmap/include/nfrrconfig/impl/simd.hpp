@@ -0,0 +1,144 @@
+#ifndef NFRRCONFIG_IMPL_SIMD_HPP
+#define NFRRCONFIG_IMPL_SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Small vector helpers shared by the lookup paths. The instruction set is chosen
+// at compile time from the target flags (SSE2 is always present on x86-64),
+// with a portable scalar fallback.
+namespace nfrr::config::config_detail {
+
+/**
+ * @brief Index of the first element of data[start, n) equal to needle, or n if none.
+ *
+ * Compares 8 words per iteration with AVX2, 4 with SSE2 / NEON.
+ */
+inline std::size_t find_u64(const std::uint64_t* data, std::size_t n, std::uint64_t needle,
+                            std::size_t start = 0) noexcept {
+    std::size_t i = start;
+
+#if defined(__AVX2__)
+    const __m256i wanted = _mm256_set1_epi64x(static_cast<long long>(needle));
+    for (; i + 8 <= n; i += 8) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));     // NOLINT
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 4)); // NOLINT
+        const __m256d eq_a = _mm256_castsi256_pd(_mm256_cmpeq_epi64(a, wanted));
+        const __m256d eq_b = _mm256_castsi256_pd(_mm256_cmpeq_epi64(b, wanted));
+        const auto mask_a = static_cast<unsigned>(_mm256_movemask_pd(eq_a));
+        const auto mask_b = static_cast<unsigned>(_mm256_movemask_pd(eq_b));
+        const unsigned mask = mask_a | (mask_b << 4U);
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+#elif defined(__SSE2__)
+    // SSE2 has no 64-bit equality: compare 32-bit halves and require both to match.
+    const __m128i wanted = _mm_set1_epi64x(static_cast<long long>(needle));
+    for (; i + 4 <= n; i += 4) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));     // NOLINT
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 2)); // NOLINT
+        const auto bytes_a = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi32(a, wanted)));
+        const auto bytes_b = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi32(b, wanted)));
+        const unsigned lanes = static_cast<unsigned>((bytes_a & 0x00FFU) == 0x00FFU) |
+                               (static_cast<unsigned>((bytes_a & 0xFF00U) == 0xFF00U) << 1U) |
+                               (static_cast<unsigned>((bytes_b & 0x00FFU) == 0x00FFU) << 2U) |
+                               (static_cast<unsigned>((bytes_b & 0xFF00U) == 0xFF00U) << 3U);
+        if (lanes != 0) {
+            return i + static_cast<std::size_t>(__builtin_ctz(lanes));
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const uint64x2_t wanted = vdupq_n_u64(needle);
+    for (; i + 4 <= n; i += 4) {
+        const uint64x2_t a = vceqq_u64(vld1q_u64(data + i), wanted);
+        const uint64x2_t b = vceqq_u64(vld1q_u64(data + i + 2), wanted);
+        if ((vmaxvq_u32(vreinterpretq_u32_u64(vorrq_u64(a, b)))) != 0) {
+            if (vgetq_lane_u64(a, 0) != 0) {
+                return i;
+            }
+            if (vgetq_lane_u64(a, 1) != 0) {
+                return i + 1;
+            }
+            if (vgetq_lane_u64(b, 0) != 0) {
+                return i + 2;
+            }
+            return i + 3;
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        if (data[i] == needle) {
+            return i;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief First byte in [p, end) that ends a plain JSON string run: '"', '\\' or a control
+ *        character below 0x20. Returns end if there is none.
+ *
+ * Classifies 32 bytes per iteration with AVX2, 16 with SSE2 / NEON.
+ */
+inline const char* find_string_special(const char* p, const char* end) noexcept {
+#if defined(__AVX2__)
+    const __m256i quote32 = _mm256_set1_epi8('"');
+    const __m256i escape32 = _mm256_set1_epi8('\\');
+    const __m256i ctrl32 = _mm256_set1_epi8(0x1F);
+    for (; end - p >= 32; p += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); // NOLINT
+        const __m256i specials = _mm256_or_si256(_mm256_cmpeq_epi8(v, quote32), _mm256_cmpeq_epi8(v, escape32));
+        // Unsigned v <= 0x1F  <=>  max(v, 0x1F) == 0x1F.
+        const __m256i controls = _mm256_cmpeq_epi8(_mm256_max_epu8(v, ctrl32), ctrl32);
+        const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(specials, controls)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i escape = _mm_set1_epi8('\\');
+    const __m128i ctrl = _mm_set1_epi8(0x1F);
+    for (; end - p >= 16; p += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); // NOLINT
+        const __m128i specials = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, escape));
+        const __m128i controls = _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl);
+        const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(specials, controls)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t escape = vdupq_n_u8('\\');
+    const uint8x16_t ctrl = vdupq_n_u8(0x1F);
+    for (; end - p >= 16; p += 16) {
+        const uint8x16_t v = vld1q_u8(reinterpret_cast<const std::uint8_t*>(p)); // NOLINT
+        const uint8x16_t hit = vorrq_u8(vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, escape)), vcleq_u8(v, ctrl));
+        if (vmaxvq_u8(hit) != 0) {
+            break; // the scalar loop below locates the byte within this block
+        }
+    }
+#endif
+
+    for (; p != end; ++p) {
+        const auto c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\' || c < 0x20) {
+            return p;
+        }
+    }
+    return end;
+}
+
+} // namespace nfrr::config::config_detail
+
+#endif // NFRRCONFIG_IMPL_SIMD_HPP
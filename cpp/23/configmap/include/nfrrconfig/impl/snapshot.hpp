@@ -0,0 +1,690 @@
+#ifndef NFRRCONFIG_IMPL_SNAPSHOT_HPP
+#define NFRRCONFIG_IMPL_SNAPSHOT_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "basic_config_value.hpp"
+#include "bcv_impl.hpp"
+#include "config_details.hpp"
+#include "config_path.hpp"
+#include "enums.hpp"
+#include "json_index.hpp"
+#include "json_write.hpp"
+#include "mapped_document.hpp"
+
+namespace nfrr::config {
+
+// Snapshot layout (native byte order, all sections 8-byte aligned relative to the start):
+//
+//   SnapshotHeader  32 bytes    magic, version, byte-order mark, section sizes
+//   nodes           16 bytes x node_count   breadth-first: the children of a container are
+//                                           contiguous and always follow their parent
+//   keys             8 bytes x key_count    per object, sorted by key bytes, parallel to
+//                                           the object's children
+//   string pool     pool_size bytes          keys and strings, identical contents stored once
+//
+// Node payloads by kind: Boolean 0/1, Integer / Floating the value bits, String pool offset
+// (count = length), Array first child (count = elements), Object first child in the low and
+// first key entry in the high 32 bits (count = members). Node 0 is the root.
+
+namespace config_detail {
+
+inline constexpr char SNAPSHOT_MAGIC[8] = {'N', 'F', 'R', 'R', 'S', 'N', 'A', 'P'};
+inline constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+inline constexpr std::uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t node_count;
+    std::uint32_t key_count;
+    std::uint64_t pool_size;
+};
+
+struct SnapshotNode {
+    std::uint8_t kind;
+    std::uint8_t reserved[3];
+    std::uint32_t count;
+    std::uint64_t payload;
+};
+
+struct SnapshotKey {
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+static_assert(sizeof(SnapshotHeader) == 32 && sizeof(SnapshotNode) == 16 && sizeof(SnapshotKey) == 8);
+
+// Unaligned read of a trivially copyable record (compiles to plain loads).
+template <typename T>
+[[nodiscard]] inline T load_record(const char* p) noexcept {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+/**
+ * @brief Flattens a BasicConfigValue tree into the snapshot sections.
+ *
+ * Nodes are assigned breadth-first, so that every container's children occupy a contiguous
+ * range. Strings are interned by content while the source tree is alive (the map views it).
+ */
+template <typename Value>
+class SnapshotBuilder {
+  public:
+    explicit SnapshotBuilder(const Value& root) {
+        enqueue(root);
+        for (std::size_t i = 0; i < queue_.size(); ++i) {
+            encode(i);
+        }
+    }
+
+    template <JsonSink Sink>
+    void write(Sink& sink) const {
+        SnapshotHeader header{};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.byte_order = SNAPSHOT_BYTE_ORDER;
+        header.node_count = static_cast<std::uint32_t>(nodes_.size());
+        header.key_count = static_cast<std::uint32_t>(keys_.size());
+        header.pool_size = pool_.size();
+        sink.append(reinterpret_cast<const char*>(&header), sizeof(header)); // NOLINT
+        sink.append(reinterpret_cast<const char*>(nodes_.data()), nodes_.size() * sizeof(SnapshotNode)); // NOLINT
+        sink.append(reinterpret_cast<const char*>(keys_.data()), keys_.size() * sizeof(SnapshotKey));     // NOLINT
+        sink.append(pool_.data(), pool_.size());
+    }
+
+  private:
+    std::vector<const Value*> queue_; // queue_[i] is encoded into nodes_[i]
+    std::vector<SnapshotNode> nodes_;
+    std::vector<SnapshotKey> keys_;
+    std::string pool_;
+    std::unordered_map<std::string_view, std::uint32_t> interned_;
+    std::vector<std::pair<std::string_view, const Value*>> members_; // scratch for sorting
+
+    static std::uint32_t checked(std::size_t n) {
+        if (n > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error{"write_snapshot(): value exceeds the 4 GiB snapshot limits"};
+        }
+        return static_cast<std::uint32_t>(n);
+    }
+
+    void enqueue(const Value& value) {
+        queue_.push_back(&value);
+        nodes_.push_back(SnapshotNode{});
+    }
+
+    std::uint32_t intern(std::string_view s) {
+        auto [it, inserted] = interned_.try_emplace(s, 0);
+        if (inserted) {
+            it->second = checked(pool_.size());
+            pool_.append(s);
+            checked(pool_.size());
+        }
+        return it->second;
+    }
+
+    void encode(std::size_t i) {
+        const Value& value = *queue_[i];
+        SnapshotNode node{};
+        node.kind = static_cast<std::uint8_t>(value.kind());
+        switch (value.kind()) {
+            case ConfigValueKind::Null:
+                break;
+            case ConfigValueKind::Boolean:
+                node.payload = value.as_bool() ? 1 : 0;
+                break;
+            case ConfigValueKind::Integer:
+                node.payload = static_cast<std::uint64_t>(value.as_integer());
+                break;
+            case ConfigValueKind::Floating:
+                node.payload = std::bit_cast<std::uint64_t>(value.as_floating());
+                break;
+            case ConfigValueKind::String: {
+                const std::string_view s{value.as_string().data(), value.as_string().size()};
+                node.count = checked(s.size());
+                node.payload = intern(s);
+                break;
+            }
+            case ConfigValueKind::Array: {
+                const auto& array = value.as_array();
+                node.count = checked(array.size());
+                node.payload = checked(nodes_.size());
+                for (const auto& element : array) {
+                    enqueue(element);
+                }
+                break;
+            }
+            case ConfigValueKind::Object: {
+                const auto& object = value.as_object();
+                members_.clear();
+                for (const auto& member : object) {
+                    members_.emplace_back(std::string_view{member.first.data(), member.first.size()}, &member.second);
+                }
+                std::sort(members_.begin(), members_.end(),
+                          [](const auto& a, const auto& b) { return a.first < b.first; });
+                node.count = checked(members_.size());
+                node.payload = checked(nodes_.size()) | (std::uint64_t{checked(keys_.size())} << 32);
+                for (const auto& [key, member] : members_) {
+                    keys_.push_back(SnapshotKey{intern(key), checked(key.size())});
+                    enqueue(*member);
+                }
+                checked(keys_.size());
+                break;
+            }
+        }
+        checked(nodes_.size());
+        nodes_[i] = node;
+    }
+};
+
+} // namespace config_detail
+
+/**
+ * @brief Read-only view of one value inside a binary snapshot (see write_snapshot()).
+ *
+ * Mirrors the read side of BasicConfigValue: kind() / is_*(), as_*(), try_get<T>() / get<T>()
+ * with the same conversions, find() / contains() / at() for object keys, operator[] / at() for
+ * array elements. Nothing is decoded up front; every accessor reads the snapshot bytes in place
+ * (object lookups are binary searches over the sorted key table), and strings are returned as
+ * std::string_view into the string pool.
+ *
+ * A ConfigView is two words and is passed by value. It stays valid as long as the snapshot
+ * bytes do. Object members iterate in key order (key_at() / value_at()).
+ */
+class ConfigView {
+  public:
+    using size_type = std::size_t;
+
+    [[nodiscard]] ConfigValueKind kind() const noexcept {
+        return static_cast<ConfigValueKind>(node().kind);
+    }
+
+    [[nodiscard]] bool is_null() const noexcept {
+        return kind() == ConfigValueKind::Null;
+    }
+    [[nodiscard]] bool is_bool() const noexcept {
+        return kind() == ConfigValueKind::Boolean;
+    }
+    [[nodiscard]] bool is_integer() const noexcept {
+        return kind() == ConfigValueKind::Integer;
+    }
+    [[nodiscard]] bool is_floating() const noexcept {
+        return kind() == ConfigValueKind::Floating;
+    }
+    [[nodiscard]] bool is_string() const noexcept {
+        return kind() == ConfigValueKind::String;
+    }
+    [[nodiscard]] bool is_array() const noexcept {
+        return kind() == ConfigValueKind::Array;
+    }
+    [[nodiscard]] bool is_object() const noexcept {
+        return kind() == ConfigValueKind::Object;
+    }
+
+    // --------- typed access (std::bad_variant_access on kind mismatch, as in BasicConfigValue) ---------
+
+    [[nodiscard]] bool as_bool() const {
+        return expect(ConfigValueKind::Boolean).payload != 0;
+    }
+
+    [[nodiscard]] std::int64_t as_integer() const {
+        return static_cast<std::int64_t>(expect(ConfigValueKind::Integer).payload);
+    }
+
+    [[nodiscard]] double as_floating() const {
+        return std::bit_cast<double>(expect(ConfigValueKind::Floating).payload);
+    }
+
+    [[nodiscard]] std::string_view as_string() const {
+        const auto n = expect(ConfigValueKind::String);
+        return {pool() + n.payload, n.count};
+    }
+
+    /// Number of array elements or object members; 0 for scalars.
+    [[nodiscard]] size_type size() const noexcept {
+        const auto n = node();
+        const auto k = static_cast<ConfigValueKind>(n.kind);
+        return (k == ConfigValueKind::Array || k == ConfigValueKind::Object) ? n.count : 0;
+    }
+
+    /**
+     * @brief Converting access, with the same rules as BasicConfigValue::try_get():
+     *        arithmetic targets from Integer / Floating / Boolean, std::string_view and
+     *        std::string from String.
+     */
+    template <typename T>
+    [[nodiscard]] std::expected<T, ConfigError> try_get() const noexcept {
+        if constexpr (config_detail::Arithmetic<T>) {
+            switch (kind()) {
+                case ConfigValueKind::Integer:
+                    return config_detail::numeric_from_int64<T>(as_integer());
+                case ConfigValueKind::Floating:
+                    return config_detail::numeric_from_double<T>(as_floating());
+                case ConfigValueKind::Boolean:
+                    return config_detail::numeric_from_bool<T>(as_bool());
+                default:
+                    return std::unexpected(ConfigError::TypeMismatch);
+            }
+        }
+        else if constexpr (std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string>) {
+            if (!is_string()) {
+                return std::unexpected(ConfigError::TypeMismatch);
+            }
+            return T{as_string()};
+        }
+        else {
+            static_assert(sizeof(T) == 0, "ConfigView::try_get<T>(): unsupported target type");
+        }
+    }
+
+    /// try_get<T>(), throwing std::runtime_error on failure.
+    template <typename T>
+    [[nodiscard]] T get() const {
+        auto res = try_get<T>();
+        if (!res) {
+            throw std::runtime_error{"ConfigView::get(): type mismatch or conversion error"};
+        }
+        return *std::move(res);
+    }
+
+    // --------- objects ---------
+
+    /// Member @p key (binary search), or nullopt if absent or this is not an object.
+    [[nodiscard]] std::optional<ConfigView> find(std::string_view key) const noexcept {
+        const auto n = node();
+        if (static_cast<ConfigValueKind>(n.kind) != ConfigValueKind::Object) {
+            return std::nullopt;
+        }
+        const auto first_key = static_cast<std::uint32_t>(n.payload >> 32);
+        std::uint32_t lo = 0;
+        std::uint32_t hi = n.count;
+        while (lo < hi) {
+            const std::uint32_t mid = lo + (hi - lo) / 2;
+            const int cmp = key_view(first_key + mid).compare(key);
+            if (cmp == 0) {
+                return child(static_cast<std::uint32_t>(n.payload) + mid);
+            }
+            if (cmp < 0) {
+                lo = mid + 1;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] bool contains(std::string_view key) const noexcept {
+        return find(key).has_value();
+    }
+
+    /// @throws std::out_of_range if this is not an object or has no member @p key.
+    [[nodiscard]] ConfigView at(std::string_view key) const {
+        if (!is_object()) {
+            throw std::out_of_range{"Config value is not an object"};
+        }
+        if (auto found = find(key)) {
+            return *found;
+        }
+        throw std::out_of_range{"Key not found in object"};
+    }
+
+    /// Key of the @p i-th member in key order. @pre is_object() && i < size()
+    [[nodiscard]] std::string_view key_at(size_type i) const noexcept {
+        return key_view(static_cast<std::uint32_t>(node().payload >> 32) + static_cast<std::uint32_t>(i));
+    }
+
+    /// Value of the @p i-th member in key order. @pre is_object() && i < size()
+    [[nodiscard]] ConfigView value_at(size_type i) const noexcept {
+        return child(static_cast<std::uint32_t>(node().payload) + static_cast<std::uint32_t>(i));
+    }
+
+    // --------- arrays ---------
+
+    /// @pre is_array() && i < size()
+    [[nodiscard]] ConfigView operator[](size_type i) const noexcept {
+        return child(static_cast<std::uint32_t>(node().payload) + static_cast<std::uint32_t>(i));
+    }
+
+    /// @throws std::out_of_range if this is not an array or @p i is past the end.
+    [[nodiscard]] ConfigView at(size_type i) const {
+        if (!is_array()) {
+            throw std::out_of_range{"Config value is not an array"};
+        }
+        if (i >= size()) {
+            throw std::out_of_range{"Index past the end of the array"};
+        }
+        return (*this)[i];
+    }
+
+    /**
+     * @brief Resolve @p path (see ConfigPath) without throwing.
+     *
+     * @return The target, or KeyNotFound / IndexNotFound / TypeMismatch as ConfigPath::resolve().
+     */
+    [[nodiscard]] std::expected<ConfigView, ConfigError> resolve(const ConfigPath& path) const {
+        ConfigView current = *this;
+        for (const auto& seg : path.segments()) {
+            if (current.is_array()) {
+                if (seg.index == ConfigPath::NO_INDEX) {
+                    return std::unexpected(ConfigError::TypeMismatch);
+                }
+                if (seg.index >= current.size()) {
+                    return std::unexpected(ConfigError::IndexNotFound);
+                }
+                current = current[seg.index];
+            }
+            else if (current.is_object() && !seg.index_only) {
+                auto found = current.find(seg.key);
+                if (!found) {
+                    return std::unexpected(ConfigError::KeyNotFound);
+                }
+                current = *found;
+            }
+            else {
+                return std::unexpected(ConfigError::TypeMismatch);
+            }
+        }
+        return current;
+    }
+
+    /// Copy this subtree into a BasicConfigValue (e.g. to modify it).
+    template <typename Value>
+    [[nodiscard]] Value materialize(const typename Value::allocator_type& alloc = {}) const {
+        Value out{alloc};
+        materialize_into(out);
+        return out;
+    }
+
+  private:
+    friend std::expected<ConfigView, DocumentError> open_snapshot(std::string_view bytes);
+
+    const char* base_ = nullptr;
+    std::uint32_t index_ = 0;
+
+    ConfigView(const char* base, std::uint32_t index) noexcept : base_{base}, index_{index} {}
+
+    [[nodiscard]] std::uint32_t node_count() const noexcept {
+        return config_detail::load_record<std::uint32_t>(base_ + offsetof(config_detail::SnapshotHeader, node_count));
+    }
+    [[nodiscard]] std::uint32_t key_count() const noexcept {
+        return config_detail::load_record<std::uint32_t>(base_ + offsetof(config_detail::SnapshotHeader, key_count));
+    }
+    [[nodiscard]] const char* nodes() const noexcept {
+        return base_ + sizeof(config_detail::SnapshotHeader);
+    }
+    [[nodiscard]] const char* keys() const noexcept {
+        return nodes() + std::size_t{node_count()} * sizeof(config_detail::SnapshotNode);
+    }
+    [[nodiscard]] const char* pool() const noexcept {
+        return keys() + std::size_t{key_count()} * sizeof(config_detail::SnapshotKey);
+    }
+
+    [[nodiscard]] config_detail::SnapshotNode node() const noexcept {
+        return config_detail::load_record<config_detail::SnapshotNode>(nodes() +
+                                                                       index_ * sizeof(config_detail::SnapshotNode));
+    }
+
+    [[nodiscard]] config_detail::SnapshotNode expect(ConfigValueKind k) const {
+        const auto n = node();
+        if (static_cast<ConfigValueKind>(n.kind) != k) {
+            throw std::bad_variant_access{};
+        }
+        return n;
+    }
+
+    [[nodiscard]] ConfigView child(std::uint32_t index) const noexcept {
+        return ConfigView{base_, index};
+    }
+
+    [[nodiscard]] std::string_view key_view(std::uint32_t entry) const noexcept {
+        const auto k =
+            config_detail::load_record<config_detail::SnapshotKey>(keys() + entry * sizeof(config_detail::SnapshotKey));
+        return {pool() + k.offset, k.length};
+    }
+
+    template <typename Value>
+    void materialize_into(Value& out) const {
+        switch (kind()) {
+            case ConfigValueKind::Null:
+                out.set_null();
+                break;
+            case ConfigValueKind::Boolean:
+                out.set_bool(as_bool());
+                break;
+            case ConfigValueKind::Integer:
+                out.set_integer(as_integer());
+                break;
+            case ConfigValueKind::Floating:
+                out.set_floating(as_floating());
+                break;
+            case ConfigValueKind::String:
+                out.set_string(as_string());
+                break;
+            case ConfigValueKind::Array: {
+                out.set_array();
+                auto& array = out.as_array();
+                array.reserve(size());
+                for (size_type i = 0; i < size(); ++i) {
+                    (*this)[i].materialize_into(array.emplace_back(Value{out.get_allocator()}));
+                }
+                break;
+            }
+            case ConfigValueKind::Object: {
+                out.set_object();
+                auto& object = out.as_object();
+                for (size_type i = 0; i < size(); ++i) {
+                    value_at(i).materialize_into(object.try_emplace(key_at(i)).first->second);
+                }
+                break;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Serialize @p value into the binary snapshot format, appending it to @p sink.
+ *
+ * Objects are stored with their keys sorted (so lookups in a ConfigView are binary searches);
+ * identical keys and strings are stored once. The format uses native byte order and is meant
+ * as a cache for the machine (architecture) that wrote it; open_snapshot() rejects a foreign
+ * byte order.
+ *
+ * @throws std::length_error if the tree needs more than 2^32 nodes, keys or pool bytes.
+ */
+template <typename Alloc, typename ObjectPolicy, JsonSink Sink>
+void write_snapshot(const BasicConfigValue<Alloc, ObjectPolicy>& value, Sink& sink) {
+    config_detail::SnapshotBuilder<BasicConfigValue<Alloc, ObjectPolicy>> builder{value};
+    builder.write(sink);
+}
+
+/// Serialize @p value into a new snapshot buffer.
+template <typename Alloc, typename ObjectPolicy>
+[[nodiscard]] std::string to_snapshot(const BasicConfigValue<Alloc, ObjectPolicy>& value) {
+    std::string out;
+    write_snapshot(value, out);
+    return out;
+}
+
+/**
+ * @brief Root view of the snapshot in @p bytes, checking only the header (O(1), no parsing).
+ *
+ * Fails with SyntaxError (offset 0) on a wrong magic, version or byte order, and with
+ * UnexpectedEnd (offset = size of @p bytes) if the sections do not fit. The content itself is
+ * trusted; use verify_snapshot() first for bytes that may be corrupt or hostile.
+ */
+[[nodiscard]] inline std::expected<ConfigView, DocumentError> open_snapshot(std::string_view bytes) {
+    using config_detail::SnapshotHeader;
+    if (bytes.size() < sizeof(SnapshotHeader)) {
+        return std::unexpected(DocumentError{ConfigError::UnexpectedEnd, bytes.size()});
+    }
+    const auto header = config_detail::load_record<SnapshotHeader>(bytes.data());
+    if (std::memcmp(header.magic, config_detail::SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != config_detail::SNAPSHOT_VERSION || header.byte_order != config_detail::SNAPSHOT_BYTE_ORDER ||
+        header.node_count == 0) {
+        return std::unexpected(DocumentError{ConfigError::SyntaxError, 0});
+    }
+    const std::uint64_t needed = sizeof(SnapshotHeader) + header.pool_size +
+                                 std::uint64_t{header.node_count} * sizeof(config_detail::SnapshotNode) +
+                                 std::uint64_t{header.key_count} * sizeof(config_detail::SnapshotKey);
+    if (header.pool_size > std::numeric_limits<std::uint32_t>::max() || needed > bytes.size()) {
+        return std::unexpected(DocumentError{ConfigError::UnexpectedEnd, bytes.size()});
+    }
+    return ConfigView{bytes.data(), 0};
+}
+
+/**
+ * @brief Full structural check of a snapshot, O(size): every node kind, child range, key and
+ *        string reference is in bounds, children follow their parent, and object keys are
+ *        strictly sorted. A snapshot that passes is safe to read through ConfigView.
+ *
+ * @return Nothing, or the open_snapshot() error, or SyntaxError with the byte offset of the
+ *         first bad node / key record.
+ */
+[[nodiscard]] inline std::expected<void, DocumentError> verify_snapshot(std::string_view bytes) {
+    using config_detail::load_record;
+    using config_detail::SnapshotHeader;
+    using config_detail::SnapshotKey;
+    using config_detail::SnapshotNode;
+    if (auto root = open_snapshot(bytes); !root) {
+        return std::unexpected(root.error());
+    }
+    const auto header = load_record<SnapshotHeader>(bytes.data());
+    const std::size_t nodes_at = sizeof(SnapshotHeader);
+    const std::size_t keys_at = nodes_at + std::size_t{header.node_count} * sizeof(SnapshotNode);
+    const std::size_t pool_at = keys_at + std::size_t{header.key_count} * sizeof(SnapshotKey);
+    const std::string_view pool = bytes.substr(pool_at, header.pool_size);
+
+    const auto in_pool = [&](std::uint64_t offset, std::uint64_t length) {
+        return offset <= pool.size() && length <= pool.size() - offset;
+    };
+    for (std::uint32_t i = 0; i < header.node_count; ++i) {
+        const std::size_t at = nodes_at + std::size_t{i} * sizeof(SnapshotNode);
+        const auto n = load_record<SnapshotNode>(bytes.data() + at);
+        const auto bad = std::unexpected(DocumentError{ConfigError::SyntaxError, at});
+        switch (static_cast<ConfigValueKind>(n.kind)) {
+            case ConfigValueKind::Null:
+            case ConfigValueKind::Integer:
+            case ConfigValueKind::Floating:
+                break;
+            case ConfigValueKind::Boolean:
+                if (n.payload > 1) {
+                    return bad;
+                }
+                break;
+            case ConfigValueKind::String:
+                if (!in_pool(n.payload, n.count)) {
+                    return bad;
+                }
+                break;
+            case ConfigValueKind::Array:
+                if (n.payload <= i || n.payload + n.count > header.node_count) {
+                    return bad;
+                }
+                break;
+            case ConfigValueKind::Object: {
+                const std::uint64_t first = n.payload & 0xFFFF'FFFFU;
+                const std::uint64_t first_key = n.payload >> 32;
+                if (first <= i || first + n.count > header.node_count || first_key + n.count > header.key_count) {
+                    return bad;
+                }
+                std::string_view previous;
+                for (std::uint32_t m = 0; m < n.count; ++m) {
+                    const std::size_t key_at = keys_at + (first_key + m) * sizeof(SnapshotKey);
+                    const auto k = load_record<SnapshotKey>(bytes.data() + key_at);
+                    if (!in_pool(k.offset, k.length)) {
+                        return std::unexpected(DocumentError{ConfigError::SyntaxError, key_at});
+                    }
+                    const std::string_view key = pool.substr(k.offset, k.length);
+                    if (m != 0 && !(previous < key)) {
+                        return std::unexpected(DocumentError{ConfigError::SyntaxError, key_at});
+                    }
+                    previous = key;
+                }
+                break;
+            }
+            default:
+                return bad;
+        }
+    }
+    return {};
+}
+
+#if NFRRCONFIG_HAS_MMAP
+/**
+ * @brief Snapshot file mapped read-only, with views into it (see load_snapshot_mmap()).
+ *
+ * Views obtained from root() are valid as long as the MappedSnapshot (moving it keeps them
+ * valid, the mapping does not move).
+ */
+class MappedSnapshot {
+  public:
+    /**
+     * @brief Map the snapshot file at @p path. Only the header is checked unless @p verify.
+     *
+     * @return The snapshot, IoError (errno set) if the file cannot be mapped, or the
+     *         open_snapshot() / verify_snapshot() error.
+     */
+    [[nodiscard]] static std::expected<MappedSnapshot, DocumentError> load(const std::filesystem::path& path,
+                                                                           bool verify = false) {
+        auto region = config_detail::MappedRegion::map(path.c_str());
+        if (!region) {
+            return std::unexpected(region.error());
+        }
+        if (verify) {
+            if (auto ok = verify_snapshot(region->text()); !ok) {
+                return std::unexpected(ok.error());
+            }
+        }
+        auto root = open_snapshot(region->text());
+        if (!root) {
+            return std::unexpected(root.error());
+        }
+        return MappedSnapshot{std::move(*region), *root};
+    }
+
+    [[nodiscard]] ConfigView root() const noexcept {
+        return root_;
+    }
+
+    /// The mapped snapshot bytes.
+    [[nodiscard]] std::string_view bytes() const noexcept {
+        return region_.text();
+    }
+
+  private:
+    config_detail::MappedRegion region_;
+    ConfigView root_;
+
+    MappedSnapshot(config_detail::MappedRegion region, ConfigView root) noexcept
+        : region_{std::move(region)}, root_{root} {}
+};
+
+/// Map the snapshot file at @p path (see MappedSnapshot::load()).
+[[nodiscard]] inline std::expected<MappedSnapshot, DocumentError> load_snapshot_mmap(const std::filesystem::path& path,
+                                                                                     bool verify = false) {
+    return MappedSnapshot::load(path, verify);
+}
+#endif // NFRRCONFIG_HAS_MMAP
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_SNAPSHOT_HPP
@@ -0,0 +1,455 @@
+#ifndef NFRRCONFIG_IMPL_SORTED_CONFIG_OBJECT_HPP
+#define NFRRCONFIG_IMPL_SORTED_CONFIG_OBJECT_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nfrr::config {
+
+/**
+ * @brief Sorted flat-map object storage: contiguous key array plus parallel value array.
+ *
+ * Keys are kept sorted in their own vector, so a lookup is a branch-light binary
+ * search that only touches key memory; values live in a parallel vector at the
+ * same positions. Lookups are O(log n), inserts and erases O(n). Iteration visits
+ * entries in key order.
+ *
+ * With TrackInsertionOrder = true an extra side array records the sorted position
+ * of each entry in insertion order, see insertion_order().
+ *
+ * Iterators are proxies: dereferencing yields std::pair<const Key&, Mapped&>, so
+ * bind entries with `auto [key, value]` or `const auto& [key, value]`.
+ *
+ * @tparam Key                 Key string type.
+ * @tparam Mapped              Mapped value type (BasicConfigValue).
+ * @tparam Alloc               Allocator for std::pair<Key, Mapped>; rebound for the arrays.
+ * @tparam TrackInsertionOrder Whether to maintain the insertion-order side array.
+ */
+template <typename Key, typename Mapped, typename Alloc, bool TrackInsertionOrder = false>
+class SortedConfigObject {
+  public:
+    using key_type = Key;
+    using mapped_type = Mapped;
+    using value_type = std::pair<Key, Mapped>;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+  private:
+    using key_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<Key>;
+    using mapped_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<Mapped>;
+    using order_allocator = typename std::allocator_traits<allocator_type>::template rebind_alloc<std::uint32_t>;
+
+    using key_vector = std::vector<Key, key_allocator>;
+    using mapped_vector = std::vector<Mapped, mapped_allocator>;
+    using order_vector = std::vector<std::uint32_t, order_allocator>;
+
+    // Stand-in for order_vector when insertion order is not tracked.
+    struct NoOrder {
+        NoOrder() = default;
+        explicit NoOrder(const order_allocator& /*unused*/) noexcept {}
+        NoOrder(const NoOrder& /*unused*/, const order_allocator& /*unused*/) noexcept {}
+    };
+
+    using order_storage = std::conditional_t<TrackInsertionOrder, order_vector, NoOrder>;
+
+  public:
+    /**
+     * @brief Random-access proxy iterator over (key, value) pairs in key order.
+     */
+    template <bool Const>
+    class basic_iterator {
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::pair<Key, Mapped>;
+        using difference_type = std::ptrdiff_t;
+        using mapped_ref = std::conditional_t<Const, const Mapped&, Mapped&>;
+        using reference = std::pair<const Key&, mapped_ref>;
+
+        // operator-> support for a by-value reference proxy.
+        struct pointer {
+            reference ref;
+            const reference* operator->() const noexcept {
+                return &ref;
+            }
+        };
+
+      private:
+        using mapped_ptr = std::conditional_t<Const, const Mapped*, Mapped*>;
+
+        const Key* key_ = nullptr;
+        mapped_ptr mapped_ = nullptr;
+
+        friend class SortedConfigObject;
+        friend class basic_iterator<!Const>;
+
+        basic_iterator(const Key* key, mapped_ptr mapped) noexcept : key_{key}, mapped_{mapped} {}
+
+      public:
+        basic_iterator() = default;
+
+        // iterator -> const_iterator conversion.
+        template <bool OtherConst>
+            requires(Const && !OtherConst)
+        basic_iterator(const basic_iterator<OtherConst>& other) noexcept // NOLINT(google-explicit-constructor)
+            : key_{other.key_}, mapped_{other.mapped_} {}
+
+        reference operator*() const noexcept {
+            return reference{*key_, *mapped_};
+        }
+        pointer operator->() const noexcept {
+            return pointer{**this};
+        }
+        reference operator[](difference_type n) const noexcept {
+            return *(*this + n);
+        }
+
+        /// Direct access to the key without building the pair proxy.
+        const Key& key() const noexcept {
+            return *key_;
+        }
+        /// Direct access to the value without building the pair proxy.
+        mapped_ref value() const noexcept {
+            return *mapped_;
+        }
+
+        basic_iterator& operator++() noexcept {
+            ++key_;
+            ++mapped_;
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        basic_iterator& operator--() noexcept {
+            --key_;
+            --mapped_;
+            return *this;
+        }
+        basic_iterator operator--(int) noexcept {
+            auto tmp = *this;
+            --*this;
+            return tmp;
+        }
+        basic_iterator& operator+=(difference_type n) noexcept {
+            key_ += n;
+            mapped_ += n;
+            return *this;
+        }
+        basic_iterator& operator-=(difference_type n) noexcept {
+            return *this += -n;
+        }
+        friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept {
+            return it += n;
+        }
+        friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept {
+            return it += n;
+        }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+        friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return a.key_ - b.key_;
+        }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return a.key_ == b.key_;
+        }
+        friend auto operator<=>(const basic_iterator& a, const basic_iterator& b) noexcept {
+            return a.key_ <=> b.key_;
+        }
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+  private:
+    key_vector keys_;
+    mapped_vector values_;
+    [[no_unique_address]] order_storage order_;
+
+  public:
+    // --------- ctors / assignment ---------
+
+    SortedConfigObject() = default;
+
+    explicit SortedConfigObject(const allocator_type& alloc)
+        : keys_(key_allocator{alloc}), values_(mapped_allocator{alloc}), order_(order_allocator{alloc}) {}
+
+    /// Allocator-extended copy.
+    SortedConfigObject(const SortedConfigObject& other, const allocator_type& alloc)
+        : keys_(other.keys_, key_allocator{alloc}), values_(other.values_, mapped_allocator{alloc}),
+          order_(other.order_, order_allocator{alloc}) {}
+
+    /// Allocator-extended move.
+    SortedConfigObject(SortedConfigObject&& other, const allocator_type& alloc)
+        : keys_(std::move(other.keys_), key_allocator{alloc}), values_(std::move(other.values_), mapped_allocator{alloc}),
+          order_(std::move(other.order_), order_allocator{alloc}) {}
+
+    SortedConfigObject(const SortedConfigObject&) = default;
+    SortedConfigObject(SortedConfigObject&&) noexcept = default;
+    SortedConfigObject& operator=(const SortedConfigObject&) = default;
+    SortedConfigObject& operator=(SortedConfigObject&&) noexcept = default;
+    ~SortedConfigObject() = default;
+
+    allocator_type get_allocator() const noexcept {
+        return allocator_type{keys_.get_allocator()};
+    }
+
+    // --------- iteration (key order) ---------
+
+    iterator begin() noexcept {
+        return iterator{keys_.data(), values_.data()};
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator{keys_.data(), values_.data()};
+    }
+    iterator end() noexcept {
+        return begin() + static_cast<difference_type>(size());
+    }
+    const_iterator end() const noexcept {
+        return begin() + static_cast<difference_type>(size());
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    /// Sorted keys as one contiguous array.
+    std::span<const Key> keys() const noexcept {
+        return {keys_.data(), keys_.size()};
+    }
+
+    /// Values, parallel to keys().
+    std::span<Mapped> values() noexcept {
+        return {values_.data(), values_.size()};
+    }
+    std::span<const Mapped> values() const noexcept {
+        return {values_.data(), values_.size()};
+    }
+
+    /**
+     * @brief Sorted positions of the entries, listed in insertion order.
+     *
+     * Only available when TrackInsertionOrder is true. Entry i in insertion
+     * order is (*this)[insertion_order()[i]].
+     */
+    std::span<const std::uint32_t> insertion_order() const noexcept
+        requires TrackInsertionOrder
+    {
+        return {order_.data(), order_.size()};
+    }
+
+    // --------- capacity ---------
+
+    [[nodiscard]] size_type size() const noexcept {
+        return keys_.size();
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return keys_.empty();
+    }
+    void reserve(size_type n) {
+        keys_.reserve(n);
+        values_.reserve(n);
+        if constexpr (TrackInsertionOrder) {
+            order_.reserve(n);
+        }
+    }
+
+    // --------- positional access ---------
+
+    typename iterator::reference operator[](size_type pos) noexcept {
+        return begin()[static_cast<difference_type>(pos)];
+    }
+    typename const_iterator::reference operator[](size_type pos) const noexcept {
+        return begin()[static_cast<difference_type>(pos)];
+    }
+
+    // --------- lookup ---------
+
+    iterator find(std::string_view key) noexcept {
+        const size_type pos = lower_bound_pos(key);
+        return (pos != size() && std::string_view{keys_[pos]} == key) ? begin() + static_cast<difference_type>(pos)
+                                                                        : end();
+    }
+
+    const_iterator find(std::string_view key) const noexcept {
+        const size_type pos = lower_bound_pos(key);
+        return (pos != size() && std::string_view{keys_[pos]} == key) ? begin() + static_cast<difference_type>(pos)
+                                                                        : end();
+    }
+
+    [[nodiscard]] bool contains(std::string_view key) const noexcept {
+        return find(key) != end();
+    }
+
+    // --------- modifiers ---------
+
+    /**
+     * @brief Insert @p key with a null value if absent.
+     *
+     * @return Iterator to the entry and whether it was inserted.
+     */
+    std::pair<iterator, bool> try_emplace(std::string_view key) {
+        const size_type pos = lower_bound_pos(key);
+        if (pos != size() && std::string_view{keys_[pos]} == key) {
+            return {begin() + static_cast<difference_type>(pos), false};
+        }
+        insert_at(pos, make_key(key), Mapped{typename Mapped::allocator_type{get_allocator()}});
+        return {begin() + static_cast<difference_type>(pos), true};
+    }
+
+    /**
+     * @brief Insert an already constructed @p key with a null value if absent.
+     *
+     * Lets callers supply a key with a non-default representation (e.g. a BasicConfigString view);
+     * @p key is left untouched if it is already present.
+     */
+    template <typename K>
+        requires std::same_as<K, Key>
+    std::pair<iterator, bool> try_emplace(K&& key) {
+        const std::string_view view{key};
+        const size_type pos = lower_bound_pos(view);
+        if (pos != size() && std::string_view{keys_[pos]} == view) {
+            return {begin() + static_cast<difference_type>(pos), false};
+        }
+        insert_at(pos, std::move(key), Mapped{typename Mapped::allocator_type{get_allocator()}});
+        return {begin() + static_cast<difference_type>(pos), true};
+    }
+
+    /**
+     * @brief Insert @p key with @p value if absent; @p value is left untouched otherwise.
+     */
+    template <typename M>
+        requires std::is_constructible_v<Mapped, M&&>
+    std::pair<iterator, bool> try_emplace(std::string_view key, M&& value) {
+        const size_type pos = lower_bound_pos(key);
+        if (pos != size() && std::string_view{keys_[pos]} == key) {
+            return {begin() + static_cast<difference_type>(pos), false};
+        }
+        insert_at(pos, make_key(key), std::forward<M>(value));
+        return {begin() + static_cast<difference_type>(pos), true};
+    }
+
+    /**
+     * @brief Insert @p key with @p value, or assign @p value if the key exists.
+     */
+    template <typename M>
+        requires std::is_constructible_v<Mapped, M&&>
+    std::pair<iterator, bool> insert_or_assign(std::string_view key, M&& value) {
+        const size_type pos = lower_bound_pos(key);
+        if (pos != size() && std::string_view{keys_[pos]} == key) {
+            values_[pos] = std::forward<M>(value);
+            return {begin() + static_cast<difference_type>(pos), false};
+        }
+        insert_at(pos, make_key(key), std::forward<M>(value));
+        return {begin() + static_cast<difference_type>(pos), true};
+    }
+
+    iterator erase(const_iterator it) {
+        const auto pos = static_cast<size_type>(it - cbegin());
+        keys_.erase(keys_.begin() + static_cast<difference_type>(pos));
+        values_.erase(values_.begin() + static_cast<difference_type>(pos));
+        if constexpr (TrackInsertionOrder) {
+            std::erase(order_, static_cast<std::uint32_t>(pos));
+            for (auto& p : order_) {
+                p -= static_cast<std::uint32_t>(p > pos);
+            }
+        }
+        return begin() + static_cast<difference_type>(pos);
+    }
+
+    /// Remove the entry with the given key; returns the number of entries removed (0 or 1).
+    size_type erase(std::string_view key) {
+        auto it = find(key);
+        if (it == end()) {
+            return 0;
+        }
+        erase(it);
+        return 1;
+    }
+
+    void clear() noexcept {
+        keys_.clear();
+        values_.clear();
+        if constexpr (TrackInsertionOrder) {
+            order_.clear();
+        }
+    }
+
+    void swap(SortedConfigObject& other) noexcept {
+        keys_.swap(other.keys_);
+        values_.swap(other.values_);
+        if constexpr (TrackInsertionOrder) {
+            order_.swap(other.order_);
+        }
+    }
+
+  private:
+    // Branch-light lower_bound over the key array: the loop only narrows a base
+    // pointer, which compilers lower to a conditional move.
+    [[nodiscard]] size_type lower_bound_pos(std::string_view key) const noexcept {
+        size_type n = keys_.size();
+        if (n == 0) {
+            return 0;
+        }
+        const Key* base = keys_.data();
+        while (n > 1) {
+            const size_type half = n / 2;
+            base = (std::string_view{base[half - 1]} < key) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<size_type>(base - keys_.data()) + static_cast<size_type>(std::string_view{*base} < key);
+    }
+
+    Key make_key(std::string_view key) const {
+        return Key{key.begin(), key.end(), typename Key::allocator_type{keys_.get_allocator()}};
+    }
+
+    template <typename M>
+    void insert_at(size_type pos, Key&& key, M&& value) {
+        if constexpr (TrackInsertionOrder) {
+            // Grown up front (geometrically, as push_back would) so that the push_back below
+            // cannot throw once keys_ and values_ have changed.
+            if (order_.size() == order_.capacity()) {
+                order_.reserve(std::max<size_type>(2 * order_.size(), 1));
+            }
+        }
+        const auto offset = static_cast<difference_type>(pos);
+        keys_.insert(keys_.begin() + offset, std::move(key));
+        try {
+            if constexpr (std::is_same_v<std::remove_cvref_t<M>, Mapped>) {
+                values_.insert(values_.begin() + offset, std::forward<M>(value));
+            }
+            else {
+                values_.insert(values_.begin() + offset, Mapped(std::forward<M>(value)));
+            }
+        } catch (...) {
+            keys_.erase(keys_.begin() + offset);
+            throw;
+        }
+        if constexpr (TrackInsertionOrder) {
+            for (auto& p : order_) {
+                p += static_cast<std::uint32_t>(p >= pos);
+            }
+            order_.push_back(static_cast<std::uint32_t>(pos));
+        }
+    }
+};
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_SORTED_CONFIG_OBJECT_HPP
@@ -0,0 +1,229 @@
+#ifndef NFRRCONFIG_IMPL_SUBTREE_POOL_HPP
+#define NFRRCONFIG_IMPL_SUBTREE_POOL_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "basic_config_value.hpp"
+#include "bcv_impl.hpp"
+#include "enums.hpp"
+
+namespace nfrr::config {
+
+namespace config_detail {
+
+inline std::uint64_t hash_mix(std::uint64_t seed, std::uint64_t value) noexcept {
+    seed ^= value + 0x9E37'79B9'7F4A'7C15ULL + (seed << 6U) + (seed >> 2U);
+    return seed;
+}
+
+inline std::uint64_t hash_seed(ConfigValueKind kind) noexcept {
+    return hash_mix(0, static_cast<std::uint64_t>(kind) + 1);
+}
+
+inline std::uint64_t hash_chars(std::string_view s) noexcept {
+    return std::hash<std::string_view>{}(s);
+}
+
+template <typename Key>
+std::string_view key_chars(const Key& key) noexcept {
+    return std::string_view{key.data(), key.size()};
+}
+
+// Hash of a scalar or string; containers fold their children in with hash_mix().
+template <typename Value>
+std::uint64_t hash_leaf(const Value& v) noexcept {
+    const std::uint64_t seed = hash_seed(v.kind());
+    switch (v.kind()) {
+        case ConfigValueKind::Boolean:
+            return hash_mix(seed, v.as_bool() ? 1 : 0);
+        case ConfigValueKind::Integer:
+            return hash_mix(seed, static_cast<std::uint64_t>(v.as_integer()));
+        case ConfigValueKind::Floating:
+            return hash_mix(seed, std::bit_cast<std::uint64_t>(v.as_floating()));
+        case ConfigValueKind::String:
+            return hash_mix(seed, hash_chars(std::string_view{v.as_string().data(), v.as_string().size()}));
+        default:
+            return seed;
+    }
+}
+
+// Structural equality as used by hash-consing: same kinds, floating values with the same bits,
+// object members in the same order. Nodes sharing a payload are equal without looking further.
+template <typename Value>
+bool same_subtree(const Value& a, const Value& b) noexcept {
+    if (a.kind() != b.kind()) {
+        return false;
+    }
+    if constexpr (requires { a.shared_identity(); }) {
+        if (a.shared_identity() != nullptr && a.shared_identity() == b.shared_identity()) {
+            return true;
+        }
+    }
+    switch (a.kind()) {
+        case ConfigValueKind::Array: {
+            const auto& x = a.as_array();
+            const auto& y = b.as_array();
+            if (x.size() != y.size()) {
+                return false;
+            }
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                if (!same_subtree(x[i], y[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case ConfigValueKind::Object: {
+            const auto& x = a.as_object();
+            const auto& y = b.as_object();
+            if (x.size() != y.size()) {
+                return false;
+            }
+            for (auto i = x.begin(), j = y.begin(); i != x.end(); ++i, ++j) {
+                const auto& m = *i;
+                const auto& n = *j;
+                if (key_chars(m.first) != key_chars(n.first) || !same_subtree(m.second, n.second)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case ConfigValueKind::String:
+            return std::string_view{a.as_string().data(), a.as_string().size()} ==
+                   std::string_view{b.as_string().data(), b.as_string().size()};
+        case ConfigValueKind::Floating:
+            return std::bit_cast<std::uint64_t>(a.as_floating()) == std::bit_cast<std::uint64_t>(b.as_floating());
+        case ConfigValueKind::Boolean:
+            return a.as_bool() == b.as_bool();
+        case ConfigValueKind::Integer:
+            return a.as_integer() == b.as_integer();
+        default:
+            return true;
+    }
+}
+
+} // namespace config_detail
+
+/**
+ * @brief Structural hash of @p v: kinds, scalars (floating values by bit pattern), strings, array
+ *        elements in order and object members in iteration order.
+ *
+ * Values that are equal for SubtreePool hash equal; it does not depend on allocators, policies or
+ * sharing. O(size of the tree).
+ */
+template <typename Alloc, typename ObjectPolicy>
+std::uint64_t hash_value(const BasicConfigValue<Alloc, ObjectPolicy>& v) noexcept {
+    std::uint64_t hash = config_detail::hash_leaf(v);
+    if (v.is_array()) {
+        for (const auto& element : v.as_array()) {
+            hash = config_detail::hash_mix(hash, hash_value(element));
+        }
+    }
+    else if (v.is_object()) {
+        for (const auto& member : v.as_object()) {
+            hash = config_detail::hash_mix(hash, config_detail::hash_chars(config_detail::key_chars(member.first)));
+            hash = config_detail::hash_mix(hash, hash_value(member.second));
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief Hash-consing table for SharedNodePolicy trees: equal subtrees become one shared payload.
+ *
+ * intern() walks a tree bottom-up and replaces every string, array and object equal to one the
+ * pool already holds (same contents in the same order, and an equal allocator) by a reference to
+ * the pooled payload; the others are added to the pool. Interning many similar trees, such as
+ * per-tenant configurations derived from one template, through one pool stores each distinct
+ * subtree once. Shared payloads are copy-on-write, so every tree remains independently mutable.
+ *
+ * Each candidate costs O(children) to compare, as its children are pooled first and equal
+ * children are then the same payload. The pool keeps a reference to every distinct subtree it
+ * has seen until clear() or destruction, and must not outlive the memory resources of those
+ * values. Not thread-safe.
+ *
+ * @tparam Value A BasicConfigValue with SharedNodePolicy.
+ */
+template <typename Value>
+class SubtreePool {
+    static_assert(requires(const Value& v) { v.shared_identity(); }, "SubtreePool needs a SharedNodePolicy value");
+
+  public:
+    SubtreePool() = default;
+    SubtreePool(const SubtreePool&) = delete;
+    SubtreePool& operator=(const SubtreePool&) = delete;
+
+    /// Deduplicate @p root in place against the pool, adding the subtrees not seen before.
+    void intern(Value& root) {
+        static_cast<void>(intern_node(root));
+    }
+
+    /// Number of distinct strings, arrays and objects held.
+    [[nodiscard]] std::size_t size() const noexcept {
+        return table_.size();
+    }
+
+    /// Drop the pool's references; interned trees keep sharing what they already share.
+    void clear() noexcept {
+        table_.clear();
+        known_.clear();
+    }
+
+  private:
+    std::unordered_multimap<std::uint64_t, Value> table_; // structural hash -> pooled node
+    std::unordered_map<const void*, std::uint64_t> known_; // pooled payloads -> their hash
+
+    std::uint64_t intern_node(Value& v) {
+        if (const void* id = v.shared_identity()) {
+            if (auto it = known_.find(id); it != known_.end()) {
+                return it->second; // already pooled: the whole subtree is canonical
+            }
+        }
+        std::uint64_t hash = config_detail::hash_leaf(std::as_const(v));
+        if (v.is_array()) {
+            for (auto& element : v.as_array()) {
+                hash = config_detail::hash_mix(hash, intern_node(element));
+            }
+        }
+        else if (v.is_object()) {
+            for (auto&& member : v.as_object()) {
+                hash = config_detail::hash_mix(hash, config_detail::hash_chars(config_detail::key_chars(member.first)));
+                hash = config_detail::hash_mix(hash, intern_node(member.second));
+            }
+        }
+        else if (!v.is_string()) {
+            return hash; // scalars live in the node itself
+        }
+
+        auto [first, last] = table_.equal_range(hash);
+        for (; first != last; ++first) {
+            const Value& pooled = first->second;
+            if (pooled.get_allocator() == v.get_allocator() && config_detail::same_subtree(pooled, std::as_const(v))) {
+                v.share(pooled);
+                return hash;
+            }
+        }
+        Value pooled{v.get_allocator()};
+        pooled.share(v);
+        known_.emplace(pooled.shared_identity(), hash);
+        table_.emplace(hash, std::move(pooled));
+        return hash;
+    }
+};
+
+/// Share the equal subtrees within @p root (a SharedNodePolicy value); see SubtreePool.
+template <typename Value>
+void deduplicate(Value& root) {
+    SubtreePool<Value> pool;
+    pool.intern(root);
+}
+
+} // namespace nfrr::config
+
+#endif // NFRRCONFIG_IMPL_SUBTREE_POOL_HPP
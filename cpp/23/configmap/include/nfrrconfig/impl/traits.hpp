@@ -1,59 +1,186 @@
 #ifndef TRAITS_HPP
 #define TRAITS_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
 
+#include "config_object.hpp"
+#include "config_string.hpp"
+#include "interned_key.hpp"
+#include "node_storage.hpp"
+#include "sorted_config_object.hpp"
+
 namespace nfrr::config {
+// Object storage policies. A policy exposes a member alias template
+//   template <typename Key, typename Mapped, typename Alloc> using object_type = ...;
+// naming the container used for Object, where Alloc is the allocator for std::pair<Key, Mapped>.
+
+/**
+ * @brief Insertion-ordered vector of pairs with adaptive lookup: SIMD prefix scans from
+ *        PrefixThreshold keys, a hashed side index from IndexThreshold keys.
+ */
+template <std::size_t IndexThreshold = NFRRCONFIG_OBJECT_INDEX_THRESHOLD,
+          std::size_t PrefixThreshold = NFRRCONFIG_OBJECT_PREFIX_THRESHOLD>
+struct IndexedObjectPolicy {
+    template <typename Key, typename Mapped, typename Alloc>
+    using object_type = BasicConfigObject<Key, Mapped, Alloc, IndexThreshold, PrefixThreshold>;
+};
+
+/**
+ * @brief Sorted key array plus parallel value array (flat_map pattern), O(log n) lookups.
+ *
+ * Iteration is in key order; TrackInsertionOrder adds a side array that remembers insertion order.
+ */
+template <bool TrackInsertionOrder = false>
+struct SortedObjectPolicy {
+    template <typename Key, typename Mapped, typename Alloc>
+    using object_type = SortedConfigObject<Key, Mapped, Alloc, TrackInsertionOrder>;
+};
+
+using DefaultObjectPolicy = IndexedObjectPolicy<>;
+
+/**
+ * @brief Object policy wrapper that also switches the string type to BasicConfigString.
+ *
+ * Values built with this policy can hold strings and keys that view a pinned source buffer
+ * (see parse_json_pinned); everything else is inherited from ObjectPolicy.
+ */
+template <typename ObjectPolicy = DefaultObjectPolicy>
+struct ZeroCopyStringPolicy : ObjectPolicy {
+    template <typename CharAlloc>
+    using string_type = BasicConfigString<CharAlloc>;
+};
+
+/**
+ * @brief Object policy wrapper that switches values to the 16-byte CompactNodeStorage layout.
+ *
+ * Scalars stay inline; strings, arrays and objects move out of line, and for pmr the node's
+ * allocator shares a word with the kind tag. Arrays become contiguous 16-byte nodes, which is
+ * what sets the footprint of large trees. The public API is unchanged; everything else is
+ * inherited from ObjectPolicy (so CompactNodePolicy<ZeroCopyStringPolicy<>> combines both).
+ */
+template <typename ObjectPolicy = DefaultObjectPolicy>
+struct CompactNodePolicy : ObjectPolicy {
+    static constexpr bool COMPACT_NODES = true;
+};
+
+/**
+ * @brief Object policy wrapper that switches values to the copy-on-write SharedNodeStorage layout.
+ *
+ * Nodes are 16 bytes as with CompactNodePolicy, but strings, arrays and objects are reference
+ * counted, so identical subtrees can be shared between trees (see SubtreePool) and are copied
+ * only when one of them is written to. Everything else is inherited from ObjectPolicy.
+ */
+template <typename ObjectPolicy = DefaultObjectPolicy>
+struct SharedNodePolicy : ObjectPolicy {
+    static constexpr bool SHARED_NODES = true;
+};
+
+/**
+ * @brief Object policy wrapper that stores object keys as BasicInternedKey handles.
+ *
+ * With a KeyPool as memory resource (or a BasicConfigDocument using this policy) each distinct
+ * key is stored once and object keys shrink to one pointer; lookups with a key interned in the
+ * same pool compare handles. Without a pool keys still work, each owning its characters.
+ * Everything else is inherited from ObjectPolicy.
+ */
+template <typename ObjectPolicy = DefaultObjectPolicy>
+struct InternedKeyPolicy : ObjectPolicy {
+    template <typename CharAlloc>
+    using key_type = BasicInternedKey<CharAlloc>;
+};
+
+namespace config_detail {
+// A policy may name its string type through `template <typename CharAlloc> using string_type`;
+// otherwise strings are std::basic_string.
+template <typename ObjectPolicy, typename CharAlloc>
+struct PolicyString {
+    using type = std::basic_string<char, std::char_traits<char>, CharAlloc>;
+};
+
+template <typename ObjectPolicy, typename CharAlloc>
+    requires requires { typename ObjectPolicy::template string_type<CharAlloc>; }
+struct PolicyString<ObjectPolicy, CharAlloc> {
+    using type = typename ObjectPolicy::template string_type<CharAlloc>;
+};
+
+// Likewise for object keys (`template <typename CharAlloc> using key_type`); the default is the
+// string type.
+template <typename ObjectPolicy, typename CharAlloc, typename String>
+struct PolicyKey {
+    using type = String;
+};
+
+template <typename ObjectPolicy, typename CharAlloc, typename String>
+    requires requires { typename ObjectPolicy::template key_type<CharAlloc>; }
+struct PolicyKey<ObjectPolicy, CharAlloc, String> {
+    using type = typename ObjectPolicy::template key_type<CharAlloc>;
+};
+
+template <typename ObjectPolicy>
+concept CompactNodes = requires {
+    requires ObjectPolicy::COMPACT_NODES;
+};
+
+template <typename ObjectPolicy>
+concept SharedNodes = requires {
+    requires ObjectPolicy::SHARED_NODES;
+};
+} // namespace config_detail
+
 // Forward declaration
-template <typename Alloc>
+template <typename Alloc, typename ObjectPolicy = DefaultObjectPolicy>
 class BasicConfigValue;
 
 // Traits that define internal storage types for a given base allocator.
 // Alloc is expected to be a standard-conforming Allocator, e.g.
 //   - std::allocator<std::byte>
 //   - std::pmr::polymorphic_allocator<std::byte>
-template <typename Alloc>
+// ObjectPolicy selects the object container (see IndexedObjectPolicy, SortedObjectPolicy).
+template <typename Alloc, typename ObjectPolicy = DefaultObjectPolicy>
 struct ConfigStorageTraits {
     using base_allocator_type = Alloc;
-    using value_type = BasicConfigValue<Alloc>;
+    using object_policy = ObjectPolicy;
+    using value_type = BasicConfigValue<Alloc, ObjectPolicy>;
 
     // Rebind base allocator to char for strings
     using char_allocator = typename std::allocator_traits<base_allocator_type>::template rebind_alloc<char>;
 
-    using string_type = std::basic_string<char, std::char_traits<char>, char_allocator>;
+    // std::basic_string unless the policy supplies its own string type (ZeroCopyStringPolicy)
+    using string_type = typename config_detail::PolicyString<ObjectPolicy, char_allocator>::type;
 
     // Rebind base allocator to value_type for arrays
     using value_allocator = typename std::allocator_traits<base_allocator_type>::template rebind_alloc<value_type>;
 
     using array_type = std::vector<value_type, value_allocator>;
 
+    // Object keys: the string type unless the policy supplies its own (InternedKeyPolicy)
+    using key_type = typename config_detail::PolicyKey<ObjectPolicy, char_allocator, string_type>::type;
+
     // Key/value pair for objects
-    using key_value_type = std::pair<string_type, value_type>;
+    using key_value_type = std::pair<key_type, value_type>;
 
     // Rebind base allocator to key_value_type for objects
     using kv_allocator = typename std::allocator_traits<base_allocator_type>::template rebind_alloc<key_value_type>;
 
-    // Object storage uses std::vector for cache-friendly sequential access.
-    // Lookup is O(n) via linear search, which is optimal for small objects (< 20 keys)
-    // due to cache locality. Preserves insertion order.
-    // TODO: Profile and consider switching to std::unordered_map or sorted vector
-    //       (flat_map pattern) if objects consistently exceed ~20-30 keys.
-    using object_type = std::vector<key_value_type, kv_allocator>;
-
-    // Variant storage for all supported kinds
-    using variant_type = std::variant<std::monostate, // Null
-                                      bool,           // Boolean
-                                      std::int64_t,   // Integer
-                                      double,         // Floating
-                                      string_type,    // String
-                                      array_type,     // Array
-                                      object_type     // Object
-                                      >;
+    // Object container chosen by the policy. The default is a vector of key/value pairs
+    // (cache-friendly, insertion-ordered) with prefix/hash side structures as it grows.
+    using object_type = typename ObjectPolicy::template object_type<key_type, value_type, kv_allocator>;
+
+    // Per-node storage for all supported kinds (Null, Boolean, Integer, Floating, String, Array,
+    // Object) plus the allocator: a std::variant by default, the compact or shared layout on request.
+    using storage_type = std::conditional_t<
+        config_detail::SharedNodes<ObjectPolicy>,
+        config_detail::SharedNodeStorage<Alloc, string_type, array_type, object_type>,
+        std::conditional_t<config_detail::CompactNodes<ObjectPolicy>,
+                           config_detail::CompactNodeStorage<Alloc, string_type, array_type, object_type>,
+                           config_detail::VariantNodeStorage<Alloc, string_type, array_type, object_type>>>;
 };
 } // namespace nfrr::config
 
@@ -7,6 +7,22 @@
 
 #include "impl/basic_config_value.hpp"
 #include "impl/bcv_impl.hpp"
+#include "impl/cbor.hpp"
+#include "impl/config_cache.hpp"
+#include "impl/config_document.hpp"
+#include "impl/config_patch.hpp"
+#include "impl/config_path.hpp"
+#include "impl/config_store.hpp"
+#include "impl/config_watcher.hpp"
+#include "impl/interned_key.hpp"
+#include "impl/json_fd_sink.hpp"
+#include "impl/json_parse.hpp"
+#include "impl/json_write.hpp"
+#include "impl/lazy_document.hpp"
+#include "impl/mapped_document.hpp"
+#include "impl/msgpack.hpp"
+#include "impl/snapshot.hpp"
+#include "impl/subtree_pool.hpp"
 
 namespace nfrr::config {
 // 1) Version using std::allocator (heap via new/delete).
@@ -16,6 +32,27 @@ using ConfigValueStd = BasicConfigValue<StdByteAllocator>;
 // 2) Version using pmr::polymorphic_allocator (memory_resource based).
 using PmrByteAllocator = std::pmr::polymorphic_allocator<std::byte>;
 using ConfigValuePmr = BasicConfigValue<PmrByteAllocator>;
+using ConfigDocument = BasicConfigDocument<>; // ConfigValuePmr tree owning its arena
+
+// 3) Variants whose strings may view a pinned source buffer (see parse_json_pinned).
+using ConfigValueStdView = BasicConfigValue<StdByteAllocator, ZeroCopyStringPolicy<>>;
+using ConfigValuePmrView = BasicConfigValue<PmrByteAllocator, ZeroCopyStringPolicy<>>;
+
+// 4) Variants with 16-byte nodes (see CompactNodePolicy).
+using ConfigValueStdCompact = BasicConfigValue<StdByteAllocator, CompactNodePolicy<>>;
+using ConfigValuePmrCompact = BasicConfigValue<PmrByteAllocator, CompactNodePolicy<>>;
+
+// 5) Pmr variant storing object keys once per KeyPool (see InternedKeyPolicy), and its document.
+using ConfigValuePmrInterned = BasicConfigValue<PmrByteAllocator, InternedKeyPolicy<>>;
+using InternedConfigDocument = BasicConfigDocument<InternedKeyPolicy<>>;
+
+// 6) Copy-on-write variants whose subtrees can be shared (see SharedNodePolicy, SubtreePool).
+using ConfigValueStdShared = BasicConfigValue<StdByteAllocator, SharedNodePolicy<>>;
+using ConfigValuePmrShared = BasicConfigValue<PmrByteAllocator, SharedNodePolicy<>>;
+
+// 7) JSON Patch operations on ConfigValueStd trees (see diff(), apply_patch()).
+using ConfigPatchOperation = BasicPatchOperation<ConfigValueStd>;
+using ConfigPatch = BasicPatch<ConfigValueStd>;
 } // namespace nfrr::config
 
 #endif // CONFIGMAP_HPP
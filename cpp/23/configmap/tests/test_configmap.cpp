@@ -1,22 +1,36 @@
 // tests/test_configmap.cpp
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <expected>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <memory_resource>
+#include <mutex>
 #include <numbers>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "nfrrconfig/impl/enums.hpp"
 #include "nfrrconfig/nfrrconfig.hpp"
 
 using Config = nfrr::config::ConfigValueStd;
 using ConfigPmr = nfrr::config::ConfigValuePmr;
+using ConfigSorted = nfrr::config::BasicConfigValue<nfrr::config::StdByteAllocator, nfrr::config::SortedObjectPolicy<>>;
+using ConfigSortedOrdered =
+    nfrr::config::BasicConfigValue<nfrr::config::PmrByteAllocator, nfrr::config::SortedObjectPolicy<true>>;
 using nfrr::config::ConfigError;
 
 namespace {
@@ -30,6 +44,78 @@ inline void check_condition(bool condition, const char* expr, const char* file,
 
 #define CHECK(expr) check_condition((expr), #expr, __FILE__, __LINE__)
 
+namespace {
+// Structural equality of two trees (kinds, scalars, keys and order).
+bool same_tree(const Config& a, const Config& b) {
+    if (a.kind() != b.kind()) {
+        return false;
+    }
+    switch (a.kind()) {
+        case nfrr::config::ConfigValueKind::Null:
+            return true;
+        case nfrr::config::ConfigValueKind::Boolean:
+            return a.as_bool() == b.as_bool();
+        case nfrr::config::ConfigValueKind::Integer:
+            return a.as_integer() == b.as_integer();
+        case nfrr::config::ConfigValueKind::Floating:
+            return a.as_floating() == b.as_floating();
+        case nfrr::config::ConfigValueKind::String:
+            return a.as_string() == b.as_string();
+        case nfrr::config::ConfigValueKind::Array: {
+            const auto& x = a.as_array();
+            const auto& y = b.as_array();
+            if (x.size() != y.size()) {
+                return false;
+            }
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                if (!same_tree(x[i], y[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case nfrr::config::ConfigValueKind::Object: {
+            const auto& x = a.as_object();
+            const auto& y = b.as_object();
+            if (x.size() != y.size()) {
+                return false;
+            }
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                if (x[i].first != y[i].first || !same_tree(x[i].second, y[i].second)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// Memory resource over new/delete that throws std::bad_alloc on request, for exception-safety tests.
+class FailingResource : public std::pmr::memory_resource {
+  public:
+    std::atomic<bool> fail = false; ///< Throw on every allocation while set...
+    std::size_t fail_after = 0;     ///< ...except for this many first ones.
+
+  private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        if (fail) {
+            if (fail_after == 0) {
+                throw std::bad_alloc{};
+            }
+            --fail_after;
+        }
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 // Test cases declarations
 // -----------------------------------------------------------------------------
@@ -47,6 +133,31 @@ void test_find_and_contains();
 void test_error_handling_patterns();
 void test_pmr_allocator();
 void test_null_and_kind_queries();
+void test_large_object_index();
+void test_sorted_object_policy();
+void test_prefix_scan_lookup();
+void test_config_path();
+void test_parse_json();
+void test_two_stage_parser();
+void test_json_handler_events();
+void test_lazy_document();
+void test_zero_copy_strings();
+void test_mapped_document();
+void test_json_writer();
+void test_json_fd_sink();
+void test_binary_snapshot();
+void test_cbor();
+void test_msgpack();
+void test_config_document();
+void test_compact_nodes();
+void test_interned_keys();
+void test_shared_subtrees();
+void test_copy_on_write();
+void test_config_store();
+void test_config_read_cache();
+void test_config_watcher();
+void test_config_diff();
+void test_apply_patch();
 } // namespace
 
 // -----------------------------------------------------------------------------
@@ -67,6 +178,31 @@ int main() {
         test_error_handling_patterns();
         test_pmr_allocator();
         test_null_and_kind_queries();
+        test_large_object_index();
+        test_sorted_object_policy();
+        test_prefix_scan_lookup();
+        test_config_path();
+        test_parse_json();
+        test_two_stage_parser();
+        test_json_handler_events();
+        test_lazy_document();
+        test_zero_copy_strings();
+        test_mapped_document();
+        test_json_writer();
+        test_json_fd_sink();
+        test_binary_snapshot();
+        test_cbor();
+        test_msgpack();
+        test_config_document();
+        test_compact_nodes();
+        test_interned_keys();
+        test_shared_subtrees();
+        test_copy_on_write();
+        test_config_store();
+        test_config_read_cache();
+        test_config_watcher();
+        test_config_diff();
+        test_apply_patch();
     } catch (const std::exception& ex) {
         std::cerr << "[configmap_tests] FAILURE: " << ex.what() << '\n';
         return 1;
@@ -432,4 +568,2169 @@ void test_null_and_kind_queries() {
     v.set_object();
     CHECK(v.kind() == nfrr::config::ConfigValueKind::Object);
 }
+
+void test_large_object_index() {
+    constexpr int key_count = 1000;
+    constexpr std::size_t threshold = Config::Object::INDEX_THRESHOLD;
+
+    Config root;
+    root.set_object();
+    for (int i = 0; i < key_count; ++i) {
+        root["key_" + std::to_string(i)].assign(i);
+        // Small objects keep the plain linear layout; the index appears at the threshold.
+        CHECK(root.as_object().indexed() == (static_cast<std::size_t>(i) + 1 >= threshold));
+    }
+
+    // Every key is found through the index and insertion order is preserved.
+    CHECK(root.as_object().size() == key_count);
+    for (int i = 0; i < key_count; ++i) {
+        const std::string key = "key_" + std::to_string(i);
+        CHECK(root.contains(key));
+        CHECK(root.at(key).get<int>() == i);
+        CHECK(root.as_object()[static_cast<std::size_t>(i)].first == key);
+    }
+    CHECK(!root.contains("key_1000"));
+    CHECK(root.find("missing") == root.as_object().end());
+
+    // Existing keys are not duplicated by operator[].
+    root["key_500"].assign(-1);
+    CHECK(root.as_object().size() == key_count);
+    CHECK(root.at("key_500").get<int>() == -1);
+
+    // Erase shifts positions; the index is rebuilt and lookups stay correct.
+    CHECK(root.as_object().erase("key_0") == 1);
+    CHECK(root.as_object().erase("key_0") == 0);
+    CHECK(!root.contains("key_0"));
+    CHECK(root.at("key_999").get<int>() == 999);
+    CHECK(root.as_object().front().first == "key_1");
+
+    // Copies carry their own index.
+    const Config copy = root;
+    CHECK(copy.as_object().indexed());
+    CHECK(copy.at("key_42").get<int>() == 42);
+
+    // Shrinking below the threshold drops the index.
+    root.as_object().erase(root.as_object().begin() + 1, root.as_object().end());
+    CHECK(!root.as_object().indexed());
+    CHECK(root.contains("key_1"));
+    CHECK(!root.contains("key_2"));
+
+    // The index and nested containers are allocated from the object's memory resource.
+    std::pmr::monotonic_buffer_resource mbr;
+    ConfigPmr pmr_root{std::pmr::polymorphic_allocator<std::byte>{&mbr}};
+    for (int i = 0; i < 100; ++i) {
+        // append() rather than "k" + ...: GCC 12 at -O3 reports a spurious -Wrestrict on the latter.
+        pmr_root[std::string{"k"}.append(std::to_string(i))]["nested"].assign(i);
+    }
+    CHECK(pmr_root.as_object().indexed());
+    CHECK(pmr_root.at("k77").at("nested").get<int>() == 77);
+    CHECK(pmr_root.at("k77").get_allocator().resource() == &mbr);
+    CHECK(pmr_root.as_object().get_allocator().resource() == &mbr);
+
+    // Duplicates appended with push_back: find() keeps returning the first one as the table grows.
+    Config::Object dups;
+    constexpr std::size_t distinct = 150;
+    for (std::size_t i = 0; i < 6 * distinct; ++i) {
+        dups.push_back({"dup" + std::to_string(i % distinct), Config{}});
+        for (std::size_t k = 0; k < std::min(i + 1, distinct); ++k) {
+            CHECK(dups.find("dup" + std::to_string(k)) == dups.begin() + static_cast<std::ptrdiff_t>(k));
+        }
+    }
+
+    // Appends are all-or-nothing: when the hash table cannot be built or grown, the entry is not
+    // kept and the object still finds every earlier key through its previous side block.
+    FailingResource failing;
+    ConfigPmr guarded{std::pmr::polymorphic_allocator<std::byte>{&failing}};
+    guarded.set_object();
+    guarded.as_object().reserve(2 * threshold);
+    const auto append_fails = [&](const std::string& key) {
+        failing.fail = true;
+        bool threw = false;
+        try {
+            guarded[key].assign(-1);
+        }
+        catch (const std::bad_alloc&) {
+            threw = true;
+        }
+        failing.fail = false;
+        return threw && !guarded.contains(key);
+    };
+    for (std::size_t i = 0; i + 1 < threshold; ++i) {
+        guarded["g" + std::to_string(i)].assign(static_cast<int>(i));
+    }
+    CHECK(append_fails("g_x"));
+    CHECK(guarded.as_object().size() == threshold - 1);
+    CHECK(guarded.as_object().lookup_mode() == nfrr::config::ObjectLookup::Prefix);
+    guarded["g" + std::to_string(threshold - 1)].assign(static_cast<int>(threshold - 1));
+    CHECK(guarded.as_object().indexed());
+    CHECK(append_fails("g_y")); // the table is full at the threshold and must grow
+    CHECK(guarded.as_object().size() == threshold && guarded.as_object().indexed());
+    for (std::size_t i = 0; i < threshold; ++i) {
+        CHECK(guarded.at("g" + std::to_string(i)).get<std::size_t>() == i);
+    }
+}
+
+void test_sorted_object_policy() {
+    ConfigSorted root;
+    root["zeta"].assign(1);
+    root["alpha"].assign(2);
+    root["mid"]["nested"].assign(3);
+    root["alpha"].assign(20); // existing key: no duplicate
+
+    CHECK(root.is_object());
+    CHECK(root.as_object().size() == 3);
+    CHECK(root.at("alpha").get<int>() == 20);
+    CHECK(root.at("mid").at("nested").get<int>() == 3);
+    CHECK(!root.contains("beta"));
+
+    // Keys are stored sorted and contiguously; iteration follows key order.
+    const auto keys = root.as_object().keys();
+    CHECK(keys.size() == 3 && keys[0] == "alpha" && keys[1] == "mid" && keys[2] == "zeta");
+    std::string visited;
+    for (const auto& [key, value] : root.as_object()) {
+        visited += std::string{key} + (value.is_object() ? "{}" : "") + ";";
+    }
+    CHECK(visited == "alpha;mid{};zeta;");
+
+    // find() returns a proxy iterator with map-like ->second access.
+    auto it = root.find("zeta");
+    CHECK(it != root.as_object().end());
+    CHECK(it->first == "zeta" && it->second.get<int>() == 1);
+    it->second.assign(100);
+    CHECK(root.at("zeta").get<int>() == 100);
+
+    // Erase and copy.
+    CHECK(root.as_object().erase("mid") == 1);
+    const ConfigSorted copy = root;
+    CHECK(copy.as_object().size() == 2);
+    CHECK(copy.at("alpha").get<int>() == 20);
+
+    // Many keys: binary search stays correct across the whole range.
+    ConfigSorted big;
+    for (int i = 999; i >= 0; --i) {
+        // append(): see test_large_object_index().
+        big[std::string{"k"}.append(std::to_string(i))].assign(i);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        CHECK(big.at(std::string{"k"}.append(std::to_string(i))).get<int>() == i);
+    }
+    CHECK(!big.contains("k1000") && !big.contains("") && !big.contains("zz"));
+
+    // Insertion order side array, on a pmr arena.
+    std::pmr::monotonic_buffer_resource mbr;
+    ConfigSortedOrdered ordered{std::pmr::polymorphic_allocator<std::byte>{&mbr}};
+    ordered["c"].assign(1);
+    ordered["a"].assign(2);
+    ordered["b"].assign(3);
+    CHECK(ordered.as_object().erase("a") == 1);
+    ordered["d"].assign(4);
+
+    const auto& obj = ordered.as_object();
+    std::string insertion;
+    for (auto pos : obj.insertion_order()) {
+        insertion += std::string{obj[pos].first};
+    }
+    CHECK(insertion == "cbd");
+    CHECK(ordered.at("d").get_allocator().resource() == &mbr);
+
+    // An insert that fails part way leaves keys, values and insertion order in step. The third
+    // allocation of a growing insert fails: formerly the order array's, once keys and values grew.
+    FailingResource failing;
+    ConfigSortedOrdered guarded{std::pmr::polymorphic_allocator<std::byte>{&failing}};
+    for (const char* key : {"d", "b", "a", "c"}) {
+        guarded[key].assign(0);
+    }
+    failing.fail_after = 2;
+    failing.fail = true;
+    bool threw = false;
+    try {
+        guarded["e"].assign(0);
+    }
+    catch (const std::bad_alloc&) {
+        threw = true;
+    }
+    failing.fail = false;
+    CHECK(threw && guarded.as_object().size() == 4 && guarded.as_object().insertion_order().size() == 4);
+    guarded["aa"].assign(0);
+    std::string guarded_order;
+    for (auto pos : guarded.as_object().insertion_order()) {
+        guarded_order += std::string{guarded.as_object()[pos].first} + " ";
+    }
+    CHECK(guarded_order == "d b a c aa ");
+
+    // Assignment keeps the target's memory resource and deep-copies into it.
+    std::pmr::monotonic_buffer_resource other_mbr;
+    ConfigSortedOrdered target{std::pmr::polymorphic_allocator<std::byte>{&other_mbr}};
+    target = ordered;
+    CHECK(target.get_allocator().resource() == &other_mbr);
+    CHECK(target.at("d").get_allocator().resource() == &other_mbr);
+    CHECK(target.at("b").get<int>() == 3);
+}
+
+void test_prefix_scan_lookup() {
+    using nfrr::config::ObjectLookup;
+    constexpr std::size_t prefix_threshold = Config::Object::PREFIX_THRESHOLD;
+    constexpr std::size_t index_threshold = Config::Object::INDEX_THRESHOLD;
+
+    // Keys chosen to collide on the packed prefix (same first 7 bytes and length),
+    // plus short keys, an empty key and an embedded NUL.
+    std::vector<std::string> keys = {"timeout_read_ms", "timeout_send_ms", "timeout", "timeou", "", "a",
+                                     std::string("nul\0key", 7), "nul"};
+    for (std::size_t i = keys.size(); i + 1 < index_threshold; ++i) {
+        keys.push_back("field_" + std::to_string(i));
+    }
+
+    Config root;
+    root.set_object();
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        root[keys[i]].assign(static_cast<int>(i));
+        const ObjectLookup expected = (i + 1 >= prefix_threshold) ? ObjectLookup::Prefix : ObjectLookup::Linear;
+        CHECK(root.as_object().lookup_mode() == expected);
+
+        // Every key inserted so far resolves to its own entry.
+        for (std::size_t j = 0; j <= i; ++j) {
+            CHECK(root.at(keys[j]).get<std::size_t>() == j);
+        }
+    }
+
+    CHECK(!root.contains("timeout_recv_ms")); // prefix and length hit, full compare misses
+    CHECK(!root.contains("timeouts"));
+    CHECK(!root.contains(std::string("nul\0kez", 7)));
+    CHECK(!root.contains("field_"));
+
+    // Erase keeps the packed prefixes aligned with the entries.
+    CHECK(root.as_object().erase("timeout") == 1);
+    CHECK(root.at("timeou").get<int>() == 3);
+    CHECK(root.at(keys.back()).get<std::size_t>() == keys.size() - 1);
+
+    // Reaching the index threshold switches to the hash index.
+    root["one_more"].assign(0);
+    root["and_another"].assign(0);
+    CHECK(root.as_object().lookup_mode() == ObjectLookup::Hashed);
+    CHECK(root.at("timeout_send_ms").get<int>() == 1);
+
+    // A failed prefix-array grow leaves the object as it was, without the new entry.
+    FailingResource failing;
+    ConfigPmr grown{std::pmr::polymorphic_allocator<std::byte>{&failing}};
+    grown.set_object();
+    grown.as_object().reserve(index_threshold);
+    for (std::size_t i = 0; i < prefix_threshold; ++i) {
+        grown["k" + std::to_string(i)].assign(static_cast<int>(i));
+    }
+    CHECK(grown.as_object().lookup_mode() == ObjectLookup::Prefix);
+    failing.fail = true;
+    bool threw = false;
+    try {
+        grown["k_new"].assign(-1);
+    }
+    catch (const std::bad_alloc&) {
+        threw = true;
+    }
+    failing.fail = false;
+    CHECK(threw && grown.as_object().size() == prefix_threshold && !grown.contains("k_new"));
+    CHECK(grown.at("k7").get<int>() == 7);
+    grown["k_new"].assign(-1);
+    CHECK(grown.at("k_new").get<int>() == -1 && grown.at("k0").get<int>() == 0);
+}
+
+void test_config_path() {
+    using nfrr::config::ConfigPath;
+
+    Config root;
+    root["a"]["b"].set_array();
+    for (int i = 0; i < 5; ++i) {
+        Config elem;
+        elem["c"].assign(i * 10);
+        root["a"]["b"].as_array().push_back(std::move(elem));
+    }
+    root["x/y"]["~t"].assign("escaped");
+
+    // Dotted and JSON Pointer syntax compile to the same steps.
+    ConfigPath dotted{"a.b[3].c"};
+    ConfigPath pointer{"/a/b/3/c"};
+    CHECK(dotted.size() == 4);
+    CHECK(dotted.to_pointer() == "/a/b/3/c");
+    CHECK(dotted.at(root).get<int>() == 30);
+    CHECK(pointer.at(root).get<int>() == 30);
+
+    ConfigPath escaped{"/x~1y/~0t"};
+    CHECK(escaped.at(root).get<std::string>() == "escaped");
+
+    // Root path.
+    ConfigPath empty{""};
+    CHECK(empty.find(root) == &root);
+
+    // Malformed expressions.
+    CHECK(ConfigPath::parse("a..b").error() == ConfigError::InvalidPath);
+    CHECK(ConfigPath::parse("a.").error() == ConfigError::InvalidPath);
+    CHECK(ConfigPath::parse("a[x]").error() == ConfigError::InvalidPath);
+    CHECK(ConfigPath::parse("a[01]").error() == ConfigError::InvalidPath);
+    CHECK(ConfigPath::parse("a[1]b").error() == ConfigError::InvalidPath);
+    CHECK(ConfigPath::parse("/a~2").error() == ConfigError::InvalidPath);
+    bool threw = false;
+    try {
+        ConfigPath bad{"a[1"};
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // Missing steps are reported without inserting anything.
+    ConfigPath missing{"a.nope.c"};
+    CHECK(missing.resolve(root).error() == ConfigError::KeyNotFound);
+    CHECK(!root["a"].contains("nope"));
+    ConfigPath past_end{"a.b[9]"};
+    CHECK(past_end.resolve(root).error() == ConfigError::IndexNotFound);
+    ConfigPath through_scalar{"a.b[0].c.d"};
+    CHECK(through_scalar.resolve(root).error() == ConfigError::TypeMismatch);
+
+    // Cached positions are re-validated: structural changes re-resolve transparently.
+    const Config& const_root = root;
+    ConfigPath cached{"a.b[2].c"};
+    CHECK(cached.at(const_root).get<int>() == 20);
+    root.as_object().insert(root.as_object().begin(), {Config::String{"first"}, Config{}});
+    CHECK(cached.at(const_root).get<int>() == 20);
+    CHECK(root.as_object().erase("first") == 1);
+    root["a"].as_object().erase("b");
+    CHECK(cached.find(root) == nullptr);
+
+    // Versioned fast path returns the cached target while (root, version) match.
+    ConfigPath versioned{"x/y"};
+    ConfigPath versioned_ptr{"/x~1y/~0t"};
+    Config* target = versioned_ptr.find(root, 1);
+    CHECK(target != nullptr && target == versioned_ptr.find(root, 1));
+    CHECK(versioned_ptr.find(root, 2) == target);
+    CHECK(versioned.find(root) == &root["x/y"]); // dotted "x/y" is a single key
+
+    // A target cached by a const walk is not reused for writing: the non-const walk unshares first.
+    auto shared = nfrr::config::parse_json<nfrr::config::StdByteAllocator, nfrr::config::SharedNodePolicy<>>(
+        R"({"x":{"y":1}})");
+    CHECK(shared.has_value());
+    const nfrr::config::ConfigValueStdShared sibling = *shared;
+    ConfigPath shared_path{"x.y"};
+    const auto* read_target = shared_path.find(std::as_const(*shared), 7);
+    CHECK(read_target != nullptr && read_target == &sibling.at("x").at("y"));
+    auto* write_target = shared_path.find(*shared, 7);
+    CHECK(write_target != nullptr && write_target != read_target);
+    write_target->set_integer(42);
+    CHECK(nfrr::config::to_json(sibling) == R"({"x":{"y":1}})");
+    CHECK(nfrr::config::to_json(*shared) == R"({"x":{"y":42}})");
+    CHECK(shared_path.find(std::as_const(*shared), 7) == write_target);
+}
+
+void test_parse_json() {
+    using nfrr::config::DocumentError;
+    using nfrr::config::parse_json;
+
+    const std::string_view text = R"({
+        "name": "service",
+        "port": 8080,
+        "ratio": -1.5e2,
+        "big": 123456789012345678901234,
+        "limits": [9223372036854775807, -9223372036854775808, 0, -0],
+        "flags": {"debug": false, "verbose": true, "extra": null},
+        "escaped": "tab\tquote\"slash\/uni\u00e9\ud83d\ude00",
+        "empty": {"a": [], "o": {}},
+        "name": "override"
+    })";
+
+    auto parsed = parse_json(text);
+    CHECK(parsed.has_value());
+    Config& cfg = *parsed;
+    CHECK(cfg.as_object().size() == 8);
+    CHECK(cfg.as_object()[0].first == "name"); // duplicate keeps its position, last value wins
+    CHECK(cfg["name"].get<std::string>() == "override");
+    CHECK(cfg["port"].is_integer() && cfg["port"].get<int>() == 8080);
+    CHECK(cfg["ratio"].is_floating() && cfg["ratio"].get<double>() == -150.0);
+    CHECK(cfg["big"].is_floating());
+    const Config::Array& limits = cfg["limits"].as_array();
+    CHECK(limits.size() == 4);
+    CHECK(limits[0].get<std::int64_t>() == std::numeric_limits<std::int64_t>::max());
+    CHECK(limits[1].get<std::int64_t>() == std::numeric_limits<std::int64_t>::min());
+    CHECK(limits[3].is_integer() && limits[3].get<int>() == 0);
+    CHECK(!cfg["flags"]["debug"].get<bool>() && cfg["flags"]["verbose"].get<bool>());
+    CHECK(cfg["flags"]["extra"].is_null());
+    CHECK(cfg["escaped"].get<std::string>() == "tab\tquote\"slash/uni\xC3\xA9\xF0\x9F\x98\x80");
+    CHECK(cfg["empty"]["a"].as_array().empty() && cfg["empty"]["o"].as_object().size() == 0);
+
+    // Scalars at top level and surrounding whitespace.
+    CHECK(parse_json(" \n42\t")->get<int>() == 42);
+    CHECK(parse_json(R"("x")")->get<std::string>() == "x");
+
+    // Errors carry a code and a byte offset, and never throw.
+    const auto error_of = [](std::string_view doc) {
+        auto result = parse_json(doc);
+        return result ? DocumentError{} : result.error();
+    };
+    CHECK(error_of("") == (DocumentError{ConfigError::UnexpectedEnd, 0}));
+    CHECK(error_of("[1, 2") == (DocumentError{ConfigError::UnexpectedEnd, 5}));
+    CHECK(error_of("[1 2]") == (DocumentError{ConfigError::SyntaxError, 3}));
+    CHECK(error_of(R"({"a" 1})") == (DocumentError{ConfigError::SyntaxError, 5}));
+    CHECK(error_of(R"({"a": 1,})") == (DocumentError{ConfigError::SyntaxError, 8}));
+    CHECK(error_of("[01]") == (DocumentError{ConfigError::SyntaxError, 2}));
+    CHECK(error_of("[1.]") == (DocumentError{ConfigError::InvalidNumber, 3}));
+    CHECK(error_of("-") == (DocumentError{ConfigError::UnexpectedEnd, 1}));
+    CHECK(error_of("1e999") == (DocumentError{ConfigError::OutOfRange, 0}));
+    CHECK(error_of("tru") == (DocumentError{ConfigError::UnexpectedEnd, 3}));
+    CHECK(error_of("nul!") == (DocumentError{ConfigError::SyntaxError, 0}));
+    CHECK(error_of(R"(["a\x"])") == (DocumentError{ConfigError::InvalidString, 3}));
+    CHECK(error_of(R"(["\ud800"])") == (DocumentError{ConfigError::InvalidString, 2}));
+    CHECK(error_of("[\"a\nb\"]") == (DocumentError{ConfigError::InvalidString, 3}));
+    CHECK(error_of(R"("abc)") == (DocumentError{ConfigError::UnexpectedEnd, 4}));
+    CHECK(error_of("{} x") == (DocumentError{ConfigError::SyntaxError, 3}));
+    CHECK(error_of(std::string(2000, '[')).code == ConfigError::DepthExceeded);
+
+    // Long strings exercise the vector scanner, including a special byte just past a block.
+    const std::string long_value(100, 'x');
+    auto long_doc = parse_json("[\"" + long_value + "\", \"" + long_value + "\\n\"]");
+    CHECK(long_doc && long_doc->as_array()[0].get<std::string>() == long_value);
+    CHECK(long_doc->as_array()[1].get<std::string>() == long_value + "\n");
+
+    // pmr: every node lands on the supplied resource. The default resource is swapped for
+    // null_memory_resource so any allocation that escapes the arena would throw.
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    auto pmr_doc = parse_json(text, nfrr::config::PmrByteAllocator{&arena});
+    std::pmr::set_default_resource(previous);
+    CHECK(pmr_doc.has_value());
+    CHECK(pmr_doc->get_allocator().resource() == &arena);
+    CHECK((*pmr_doc)["limits"].as_array().get_allocator().resource() == &arena);
+    CHECK((*pmr_doc)["flags"]["debug"].get_allocator().resource() == &arena);
+    CHECK((*pmr_doc)["escaped"].as_string().get_allocator().resource() == &arena);
+
+    // Non-default object policy.
+    auto sorted = parse_json<nfrr::config::StdByteAllocator, nfrr::config::SortedObjectPolicy<>>(text);
+    CHECK(sorted && sorted->as_object().begin()->first == "big");
+    CHECK((*sorted)["port"].get<int>() == 8080);
+}
+
+void test_two_stage_parser() {
+    using nfrr::config::DocumentError;
+    using nfrr::config::JsonStructuralIndex;
+    using nfrr::config::SimdLevel;
+    using nfrr::config::parse_json;
+    using nfrr::config::parse_json_indexed;
+
+    std::vector<SimdLevel> levels;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        if (nfrr::config::simd_level_supported(level)) {
+            levels.push_back(level);
+        }
+    }
+    CHECK(nfrr::config::simd_level_supported(nfrr::config::detected_simd_level()));
+
+    // Operators, opening quotes and scalar starts; nothing inside strings, escaped quotes included.
+    const std::string_view small = R"({"a\"]": [12, true , "x,y"], "b":null})";
+    auto small_index = JsonStructuralIndex::build(small, SimdLevel::Scalar);
+    CHECK(small_index.has_value());
+    const std::vector<std::uint32_t> expected{0, 1, 7, 9, 10, 12, 14, 19, 21, 26, 27, 29, 32, 33, 37};
+    CHECK(std::vector<std::uint32_t>(small_index->positions().begin(), small_index->positions().end()) == expected);
+
+    // Strings of every length around the 64-byte block size, with backslash runs of both parities
+    // straddling block boundaries.
+    std::string doc = "[";
+    for (std::size_t len = 0; len < 140; ++len) {
+        doc += "\"";
+        for (std::size_t i = 0; i < len; ++i) {
+            doc += (i % 7 == 3) ? "\\\\" : (i % 11 == 5) ? "\\\"" : "v";
+        }
+        doc += "\", {\"k\" :\t" + std::to_string(len) + "},\n";
+    }
+    doc += "-1.25e3, false, [], {}]";
+
+    auto reference = parse_json(doc);
+    CHECK(reference.has_value());
+    auto reference_index = JsonStructuralIndex::build(doc, SimdLevel::Scalar);
+    for (SimdLevel level : levels) {
+        auto index = JsonStructuralIndex::build(doc, level);
+        CHECK(index && std::ranges::equal(index->positions(), reference_index->positions()));
+        auto indexed = parse_json_indexed(doc, nfrr::config::StdByteAllocator{}, level);
+        CHECK(indexed.has_value());
+        CHECK(same_tree(*indexed, *reference));
+    }
+
+    // Both parsers agree on error codes and offsets.
+    const std::vector<std::string> bad_docs{
+        "", "   ", "[1, 2", "[1 2]", R"({"a" 1})", R"({"a": 1,})", "[01]", "[1.]", "-", "1e999", "tru", "truex",
+        "nul!", "12x", "[1\f]", "{} x", "{1: 2}", "[\"a\" \"b\"]", R"(["a\x"])", R"(["\ud800"])", "[\"a\nb\"]",
+        R"("abc)", R"(["a\"])", std::string(2000, '['),
+    };
+    for (const std::string& bad : bad_docs) {
+        auto single = parse_json(bad);
+        CHECK(!single.has_value());
+        for (SimdLevel level : levels) {
+            auto indexed = parse_json_indexed(bad, nfrr::config::StdByteAllocator{}, level);
+            CHECK(!indexed.has_value() && indexed.error() == single.error());
+        }
+    }
+
+    // pmr allocation routing is the same as for the single-pass parser.
+    std::pmr::monotonic_buffer_resource arena;
+    auto pmr_doc = parse_json_indexed(doc, nfrr::config::PmrByteAllocator{&arena});
+    CHECK(pmr_doc && pmr_doc->as_array()[1]["k"].get_allocator().resource() == &arena);
+}
+
+// Records events as a compact trace; optionally stops at a given key.
+struct TraceHandler {
+    std::string trace;
+    std::string_view stop_at_key;
+
+    bool on_null() {
+        trace += "n ";
+        return true;
+    }
+    bool on_bool(bool value) {
+        trace += value ? "T " : "F ";
+        return true;
+    }
+    bool on_int64(std::int64_t value) {
+        trace += "i" + std::to_string(value) + " ";
+        return true;
+    }
+    bool on_double(double value) {
+        trace += "d" + std::to_string(static_cast<int>(value * 10)) + " ";
+        return true;
+    }
+    bool on_string(std::string_view value) {
+        trace += "s" + std::string(value) + " ";
+        return true;
+    }
+    bool on_key(std::string_view key) {
+        trace += "k" + std::string(key) + " ";
+        return key != stop_at_key;
+    }
+    bool on_start_object() {
+        trace += "{ ";
+        return true;
+    }
+    bool on_end_object() {
+        trace += "} ";
+        return true;
+    }
+    bool on_start_array() {
+        trace += "[ ";
+        return true;
+    }
+    bool on_end_array() {
+        trace += "] ";
+        return true;
+    }
+};
+
+void test_json_handler_events() {
+    using nfrr::config::DocumentError;
+    using nfrr::config::read_json;
+    using nfrr::config::read_json_indexed;
+    static_assert(nfrr::config::JsonHandler<TraceHandler>);
+    static_assert(nfrr::config::JsonHandler<nfrr::config::JsonDomBuilder<Config>>);
+
+    const std::string_view text = R"({"a": [1, 2.5, "x\ty"], "b": {"c": null, "d": true}, "e": false})";
+    const std::string expected = "{ ka [ i1 d25 sx\ty ] kb { kc n kd T } ke F } ";
+
+    TraceHandler single;
+    CHECK(read_json(text, single).has_value());
+    CHECK(single.trace == expected);
+
+    TraceHandler indexed;
+    CHECK(read_json_indexed(text, indexed).has_value());
+    CHECK(indexed.trace == expected);
+
+    // A handler can stop early once it has what it needs.
+    TraceHandler partial{{}, "b"};
+    auto stopped = read_json(text, partial);
+    CHECK(!stopped && stopped.error() == (DocumentError{ConfigError::Cancelled, 27}));
+    CHECK(partial.trace == "{ ka [ i1 d25 sx\ty ] kb ");
+    TraceHandler partial_indexed{{}, "b"};
+    auto stopped_indexed = read_json_indexed(text, partial_indexed);
+    CHECK(!stopped_indexed && stopped_indexed.error() == stopped.error());
+    CHECK(partial_indexed.trace == partial.trace);
+
+    // Syntax errors surface after the events that preceded them.
+    TraceHandler broken;
+    auto failed = read_json("[1, true, }", broken);
+    CHECK(!failed && failed.error() == (DocumentError{ConfigError::SyntaxError, 10}));
+    CHECK(broken.trace == "[ i1 T ");
+
+    // The stock DOM builder can fill an existing value.
+    Config target;
+    target["stale"].assign(1);
+    nfrr::config::JsonDomBuilder<Config> builder{target};
+    CHECK(read_json(text, builder).has_value());
+    CHECK(!target.contains("stale"));
+    CHECK(target["a"].as_array()[2].get<std::string>() == "x\ty" && target["b"]["d"].get<bool>());
+}
+
+void test_lazy_document() {
+    using nfrr::config::DocumentError;
+    using Lazy = nfrr::config::LazyConfigDocument<>;
+
+    std::string text = R"({
+        "service": {"name": "api", "port": 8080, "tags": ["a", "b", {"deep": [10, 20]}]},
+        "huge": [)";
+    for (int i = 0; i < 1000; ++i) {
+        text += R"({"id": )" + std::to_string(i) + R"(, "payload": "xxxxxxxxxxxxxxxx"},)";
+    }
+    text += R"(null],
+        "broken": [1, 2 3],
+        "dup": 1, "esc\"key": true, "dup": 2
+    })";
+
+    auto doc = Lazy::parse(text);
+    CHECK(doc.has_value());
+    CHECK(doc->materialized_count() == 0);
+
+    // Only the requested subtree is built; siblings are skipped without being decoded.
+    CHECK(doc->at("service.port").get<int>() == 8080);
+    CHECK(doc->materialized_count() == 1);
+    CHECK(doc->at("/service/tags/2/deep/1").get<int>() == 20);
+    CHECK(doc->materialized_count() == 2);
+    CHECK(doc->at("huge[999].id").get<int>() == 999);
+
+    // Lookups inside an already built subtree reuse it.
+    const Config& service = doc->at("service");
+    const std::size_t built = doc->materialized_count();
+    CHECK(&doc->at("service.tags[2]") == &service.at("tags").as_array()[2]);
+    CHECK(doc->materialized_count() == built);
+    CHECK(&doc->at("service") == &service);
+
+    // Key handling: escapes are decoded, the last duplicate wins, operator[] takes a literal key.
+    CHECK(doc->at(R"(/esc"key)").get<bool>());
+    CHECK((*doc)["dup"].get<int>() == 2);
+
+    // Missing paths and type mismatches.
+    CHECK(doc->find("service.nope") == nullptr);
+    CHECK(doc->resolve("service.tags[7]").error().code == ConfigError::IndexNotFound);
+    CHECK(doc->resolve("service.port.x").error().code == ConfigError::TypeMismatch);
+    CHECK(doc->resolve("a..b").error().code == ConfigError::InvalidPath);
+    bool threw = false;
+    try {
+        (void)doc->at("missing");
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // Syntax errors surface only when the damaged subtree is touched.
+    auto broken = doc->resolve("broken");
+    CHECK(!broken && broken.error().code == ConfigError::SyntaxError);
+    CHECK(text[broken.error().offset] == '3');
+    threw = false;
+    try {
+        (void)doc->root();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // Trailing commas are rejected like parse_json does, in objects and in arrays.
+    const std::string trailing = R"({"b": {"x": 2,}, "l": [1,]})";
+    CHECK(!nfrr::config::parse_json(trailing));
+    auto lenient = Lazy::parse(trailing);
+    CHECK(lenient.has_value());
+    auto object_comma = lenient->resolve("b.x");
+    CHECK(!object_comma && object_comma.error().code == ConfigError::SyntaxError);
+    CHECK(trailing[object_comma.error().offset] == '}');
+    auto array_comma = lenient->resolve("l[1]");
+    CHECK(!array_comma && array_comma.error().code == ConfigError::SyntaxError);
+    CHECK(trailing[array_comma.error().offset] == ']');
+
+    // Structural problems are caught up front.
+    CHECK(Lazy::parse("{\"a\": [1}").error().code == ConfigError::SyntaxError);
+    CHECK(Lazy::parse("[[1]").error() == (DocumentError{ConfigError::UnexpectedEnd, 4}));
+    CHECK(Lazy::parse("  ").error() == (DocumentError{ConfigError::UnexpectedEnd, 2}));
+    CHECK(Lazy::parse("{} []").error() == (DocumentError{ConfigError::SyntaxError, 3}));
+
+    // The fully materialized root matches parse_json; subtrees use the document's allocator.
+    const std::string clean = R"({"a": [1, {"b": "c"}], "d": -2.5})";
+    auto lazy_clean = Lazy::parse(clean);
+    CHECK(same_tree(lazy_clean->root(), *nfrr::config::parse_json(clean)));
+
+    std::pmr::monotonic_buffer_resource arena;
+    auto pmr_doc = nfrr::config::LazyConfigDocument<nfrr::config::PmrByteAllocator>::parse(
+        clean, nfrr::config::PmrByteAllocator{&arena});
+    CHECK(pmr_doc->at("a[1]").get_allocator().resource() == &arena);
+    CHECK(pmr_doc->at("a[1].b").as_string().get_allocator().resource() == &arena);
+}
+
+void test_zero_copy_strings() {
+    using nfrr::config::ConfigValueStdView;
+    using nfrr::config::StdByteAllocator;
+    using SortedViewPolicy = nfrr::config::ZeroCopyStringPolicy<nfrr::config::SortedObjectPolicy<>>;
+
+    const std::string text = R"({"name": "a fairly long service name", "esc": "tab\there", "n": 7,)"
+                             R"( "list": ["x", "yy"], "nested": {"deep_key_longer_than_sso": "v"}})";
+    const auto in_text = [&](std::string_view s) {
+        return s.data() >= text.data() && s.data() + s.size() <= text.data() + text.size();
+    };
+
+    auto doc = nfrr::config::parse_json_pinned<StdByteAllocator>(text);
+    CHECK(doc.has_value());
+
+    // Unescaped strings and keys reference the buffer; escaped ones are decoded copies.
+    const auto& name = doc->at("name").as_string();
+    CHECK(name.is_view() && in_text(name));
+    CHECK(name == std::string_view{"a fairly long service name"});
+    const auto& esc = doc->at("esc").as_string();
+    CHECK(!esc.is_view() && esc == std::string_view{"tab\there"});
+    CHECK(doc->at("list").as_array()[1].get<std::string_view>() == "yy");
+    CHECK(in_text(doc->at("list").as_array()[1].get<std::string_view>()));
+    CHECK(doc->at("n").as_integer() == 7);
+    const auto& nested = doc->at("nested").as_object();
+    CHECK(nested[0].first.is_view() && in_text(nested[0].first));
+    CHECK(doc->at("nested").contains("deep_key_longer_than_sso"));
+
+    // Copies own their characters and survive the buffer; moves keep the views.
+    ConfigValueStdView copy = *doc;
+    CHECK(!copy.at("name").as_string().is_view());
+    CHECK(!copy.at("nested").as_object()[0].first.is_view());
+    ConfigValueStdView moved = std::move(*doc);
+    CHECK(moved.at("name").as_string().data() == name.data());
+
+    // Same tree as the owning parser.
+    auto owning = nfrr::config::parse_json(text);
+    CHECK(copy.at("name").get<std::string_view>() == owning->at("name").get<std::string_view>());
+
+    // Strings set through the ordinary API are owned; set_string_view is explicit.
+    ConfigValueStdView v;
+    v.set_string("short");
+    CHECK(!v.as_string().is_view());
+    const std::string_view ext = text;
+    v.set_string_view(ext.substr(2, 4));
+    CHECK(v.as_string().is_view() && v.as_string() == std::string_view{"name"});
+    Config plain;
+    plain.set_string_view("owned anyway");
+    CHECK(plain.as_string() == "owned anyway");
+
+    // The builder ignores the view support when no pinned source is given.
+    auto unpinned = nfrr::config::parse_json<StdByteAllocator, nfrr::config::ZeroCopyStringPolicy<>>(text);
+    CHECK(!unpinned->at("name").as_string().is_view());
+
+    // pmr: views cost no arena memory, escaped strings and containers still come from the arena.
+    std::pmr::monotonic_buffer_resource arena;
+    auto pmr_doc = nfrr::config::parse_json_pinned(text, nfrr::config::PmrByteAllocator{&arena});
+    CHECK(pmr_doc.has_value());
+    CHECK(pmr_doc->at("name").as_string().is_view());
+    CHECK(pmr_doc->at("esc").as_string().get_allocator().resource() == &arena);
+
+    // Sorted objects accept view keys too.
+    auto sorted = nfrr::config::parse_json_pinned<StdByteAllocator, SortedViewPolicy>(text);
+    CHECK(sorted.has_value());
+    CHECK(sorted->as_object().begin()->first == std::string_view{"esc"});
+    CHECK(sorted->as_object().begin()->first.is_view());
+    CHECK(sorted->at("list").as_array()[0].as_string() == std::string_view{"x"});
+
+    // Errors surface exactly as with parse_json().
+    auto bad = nfrr::config::parse_json_pinned<StdByteAllocator>(std::string_view{R"({"a": tru})"});
+    CHECK(!bad.has_value() && bad.error() == nfrr::config::parse_json(R"({"a": tru})").error());
+}
+
+void test_mapped_document() {
+#if NFRRCONFIG_HAS_MMAP
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path();
+    const fs::path file = dir / ("nfrrconfig_mapped_" + std::to_string(::getpid()) + ".json");
+    const std::string text = R"({"server": {"host": "localhost", "port": 8080}, "motd": "line\nbreak",)"
+                             R"( "paths": ["/var/lib/service/data", "/tmp"]})";
+    {
+        std::ofstream out{file, std::ios::binary};
+        out << text;
+    }
+
+    auto doc = nfrr::config::load_file_mmap(file);
+    CHECK(doc.has_value());
+    CHECK(doc->text() == text);
+    CHECK(doc->at("server.port").get<int>() == 8080);
+    CHECK(doc->at("motd").as_string() == std::string_view{"line\nbreak"});
+    CHECK(doc->find("server.missing") == nullptr);
+    CHECK(doc->find("server..port") == nullptr);
+
+    // Unescaped strings point into the mapping; moving the document keeps them valid.
+    const auto mapped = doc->text();
+    const auto& host = doc->at("server.host").as_string();
+    CHECK(host.is_view() && host.data() >= mapped.data() && host.data() < mapped.data() + mapped.size());
+    CHECK(!doc->at("motd").as_string().is_view());
+    auto moved = std::move(*doc);
+    CHECK(moved.at("paths[0]").get<std::string_view>() == "/var/lib/service/data");
+    CHECK(moved.at("server.host").as_string().data() == host.data());
+
+    // A copied subtree owns its strings and outlives the document.
+    nfrr::config::ConfigValueStdView server_copy = moved.at("server");
+    {
+        auto scratch = std::move(moved);
+    }
+    CHECK(server_copy.at("host").as_string() == std::string_view{"localhost"});
+
+    // The classic string type works too (everything copied), as does a pmr arena.
+    auto owning = nfrr::config::load_file_mmap<nfrr::config::StdByteAllocator, nfrr::config::DefaultObjectPolicy>(file);
+    CHECK(owning.has_value() && same_tree(owning->root(), *nfrr::config::parse_json(text)));
+    std::pmr::monotonic_buffer_resource arena;
+    auto pmr_doc = nfrr::config::load_file_mmap(file, nfrr::config::PmrByteAllocator{&arena});
+    CHECK(pmr_doc.has_value() && pmr_doc->root().get_allocator().resource() == &arena);
+    std::pmr::monotonic_buffer_resource other_arena;
+    auto pmr_target = nfrr::config::load_file_mmap(file, nfrr::config::PmrByteAllocator{&other_arena});
+    *pmr_target = std::move(*pmr_doc); // different resources: the tree is moved element-wise
+    CHECK(pmr_target->at("server.host").as_string() == std::string_view{"localhost"});
+    static_assert(std::is_nothrow_move_assignable_v<nfrr::config::MappedConfigDocument<>>);
+    static_assert(
+        !std::is_nothrow_move_assignable_v<nfrr::config::MappedConfigDocument<nfrr::config::PmrByteAllocator>>);
+
+    // Errors: missing file, directory, empty file, malformed content (with its offset).
+    auto missing = nfrr::config::load_file_mmap(dir / "nfrrconfig_does_not_exist.json");
+    CHECK(!missing && missing.error().code == ConfigError::IoError);
+    auto directory = nfrr::config::load_file_mmap(dir);
+    CHECK(!directory && directory.error().code == ConfigError::IoError);
+    std::ofstream{file, std::ios::binary | std::ios::trunc}.flush();
+    auto empty = nfrr::config::load_file_mmap(file);
+    CHECK(!empty && empty.error().code == ConfigError::UnexpectedEnd);
+    std::ofstream{file, std::ios::binary | std::ios::trunc} << R"({"a": [1, 2,]})";
+    auto bad = nfrr::config::load_file_mmap(file);
+    CHECK(!bad && bad.error() == nfrr::config::parse_json(R"({"a": [1, 2,]})").error());
+
+    fs::remove(file);
+#endif
+}
+
+void test_json_writer() {
+    using nfrr::config::to_json;
+    using nfrr::config::JsonWriteOptions;
+
+    // Scalars, including the int64 extremes and the Integer / Floating distinction.
+    Config v;
+    v.set_integer(std::numeric_limits<std::int64_t>::min());
+    CHECK(to_json(v) == "-9223372036854775808");
+    v.set_integer(std::numeric_limits<std::int64_t>::max());
+    CHECK(to_json(v) == "9223372036854775807");
+    v.set_integer(0);
+    CHECK(to_json(v) == "0");
+    v.set_integer(-7);
+    CHECK(to_json(v) == "-7");
+    v.set_floating(0.1);
+    CHECK(to_json(v) == "0.1");
+    v.set_floating(2.0);
+    CHECK(to_json(v) == "2.0");
+    v.set_floating(-0.0);
+    CHECK(to_json(v) == "-0.0");
+    v.set_floating(1e300);
+    CHECK(to_json(v) == "1e+300");
+    v.set_floating(std::numeric_limits<double>::quiet_NaN());
+    CHECK(to_json(v) == "null");
+    v.set_floating(std::numeric_limits<double>::infinity());
+    CHECK(to_json(v) == "null");
+    v.set_bool(false);
+    CHECK(to_json(v) == "false");
+    v.set_null();
+    CHECK(to_json(v) == "null");
+
+    // Escaping, on both sides of the 16/32-byte vector blocks; UTF-8 passes through.
+    v.set_string("q\"b\\s/\b\f\n\r\t\x01\x1f \xc3\xa9");
+    CHECK(to_json(v) == R"("q\"b\\s/\b\f\n\r\t\u0001\u001f é")");
+    const std::string long_plain(100, 'x');
+    v.set_string(long_plain + "\"" + long_plain);
+    CHECK(to_json(v) == "\"" + long_plain + "\\\"" + long_plain + "\"");
+
+    // Compact and pretty layouts.
+    const auto doc = nfrr::config::parse_json(R"({"name": "svc", "ports": [80, 443], "tls": {}, "tags": [],
+                                                  "limits": {"cpu": 1.5, "mem": null}})");
+    CHECK(doc.has_value());
+    CHECK(to_json(*doc) == R"({"name":"svc","ports":[80,443],"tls":{},"tags":[],"limits":{"cpu":1.5,"mem":null}})");
+    CHECK(to_json(*doc, JsonWriteOptions{.pretty = true}) == "{\n"
+                                                             "  \"name\": \"svc\",\n"
+                                                             "  \"ports\": [\n"
+                                                             "    80,\n"
+                                                             "    443\n"
+                                                             "  ],\n"
+                                                             "  \"tls\": {},\n"
+                                                             "  \"tags\": [],\n"
+                                                             "  \"limits\": {\n"
+                                                             "    \"cpu\": 1.5,\n"
+                                                             "    \"mem\": null\n"
+                                                             "  }\n"
+                                                             "}");
+    CHECK(to_json(doc->at("ports"), JsonWriteOptions{.pretty = true, .indent = 1}) == "[\n 80,\n 443\n]");
+
+    // Round trip through the parser, with output larger than the writer's buffer.
+    Config big;
+    for (int i = 0; i < 500; ++i) {
+        auto& entry = big["key_" + std::to_string(i)];
+        entry["value"].set_floating(i / 7.0);
+        entry["id"].set_integer(std::int64_t{i} * 1'000'000'007);
+        entry["label"].set_string("line " + std::to_string(i) + "\n");
+    }
+    for (const bool pretty : {false, true}) {
+        const std::string text = to_json(big, JsonWriteOptions{.pretty = pretty});
+        CHECK(text.size() > 4096);
+        const auto back = nfrr::config::parse_json(text);
+        CHECK(back.has_value() && same_tree(*back, big));
+    }
+
+    // Any type with append(const char*, size_t) is a sink; other policies serialize the same.
+    struct CountingSink {
+        std::string data;
+        std::size_t calls = 0;
+        void append(const char* p, std::size_t n) {
+            data.append(p, n);
+            ++calls;
+        }
+    };
+    CountingSink sink;
+    to_json(big, sink);
+    CHECK(sink.data == to_json(big));
+    CHECK(sink.calls < sink.data.size() / 1024);
+
+    const std::string text = to_json(*doc);
+    auto sorted = nfrr::config::parse_json<nfrr::config::StdByteAllocator, nfrr::config::SortedObjectPolicy<>>(text);
+    CHECK(to_json(*sorted) == R"({"limits":{"cpu":1.5,"mem":null},"name":"svc","ports":[80,443],"tags":[],"tls":{}})");
+    auto pinned = nfrr::config::parse_json_pinned<nfrr::config::StdByteAllocator>(text);
+    CHECK(to_json(*pinned) == text);
+}
+
+void test_json_fd_sink() {
+#if NFRRCONFIG_HAS_WRITEV && NFRRCONFIG_HAS_MMAP
+    namespace fs = std::filesystem;
+    const fs::path file = fs::temp_directory_path() / ("nfrrconfig_fd_" + std::to_string(::getpid()) + ".json");
+    const auto read_back = [&] {
+        std::ifstream in{file, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+    };
+
+    // Many small tokens, long strings (referenced, not copied) and a payload larger than a chunk.
+    Config big;
+    const std::string payload(200'000, 'p');
+    big["payload"].set_string(payload);
+    big["escaped"].set_string(std::string(1000, 'e') + "\"\n" + std::string(1000, 'f'));
+    for (int i = 0; i < 3000; ++i) {
+        auto& entry = big["items"]["item_" + std::to_string(i)];
+        entry["n"].set_integer(i);
+        entry["x"].set_floating(i * 0.25);
+    }
+
+    // Tiny flush threshold: many writev batches, each within the iovec limit.
+    constexpr std::size_t DEFAULT_FLUSH = nfrr::config::JsonFdSink::DEFAULT_FLUSH_BYTES;
+    for (const std::size_t flush_bytes : {std::size_t{1}, std::size_t{4096}, DEFAULT_FLUSH}) {
+        for (const bool pretty : {false, true}) {
+            const int fd = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600); // NOLINT
+            CHECK(fd >= 0);
+            const auto options = nfrr::config::JsonWriteOptions{.pretty = pretty};
+            auto written = nfrr::config::to_json_fd(big, fd, options, flush_bytes);
+            ::close(fd);
+            const std::string expected = nfrr::config::to_json(big, options);
+            CHECK(written.has_value() && *written == expected.size());
+            CHECK(read_back() == expected);
+        }
+    }
+
+    // Pipes take partial writes; a document smaller than the pipe buffer round-trips in one go.
+    int pipe_fds[2];
+    CHECK(::pipe(pipe_fds) == 0);
+    auto small = nfrr::config::parse_json(R"({"a": [1, 2.5, "three"], "b": null})");
+    auto piped = nfrr::config::to_json_fd(*small, pipe_fds[1]);
+    ::close(pipe_fds[1]);
+    char buf[128];
+    const auto got = ::read(pipe_fds[0], buf, sizeof(buf));
+    ::close(pipe_fds[0]);
+    CHECK(piped.has_value() && std::string_view(buf, static_cast<std::size_t>(got)) == to_json(*small));
+
+    // Write errors are latched and reported with the byte count reached.
+    auto bad = nfrr::config::to_json_fd(big, -1);
+    CHECK(!bad && bad.error().code == ConfigError::IoError && bad.error().offset == 0 && errno == EBADF);
+
+    fs::remove(file);
+#endif
+}
+
+void test_binary_snapshot() {
+    using nfrr::config::ConfigValueKind;
+    const auto doc = nfrr::config::parse_json(R"({"service": "api", "port": 8080, "ratio": 0.75, "debug": false,
+        "tags": ["a", "b", "api"], "limits": {"cpu": 2, "mem": "512Mi"}, "none": null, "empty": {}, "list": []})");
+    CHECK(doc.has_value());
+
+    const std::string bytes = nfrr::config::to_snapshot(*doc);
+    CHECK(nfrr::config::verify_snapshot(bytes).has_value());
+    auto root = nfrr::config::open_snapshot(bytes);
+    CHECK(root.has_value());
+    const nfrr::config::ConfigView view = *root;
+
+    // Same read surface as BasicConfigValue.
+    CHECK(view.is_object() && view.size() == 9);
+    CHECK(view.at("service").as_string() == "api");
+    CHECK(view.at("port").get<int>() == 8080);
+    CHECK(view.at("port").try_get<std::uint8_t>().error() == ConfigError::OutOfRange);
+    CHECK(view.at("ratio").as_floating() == 0.75);
+    CHECK(view.at("ratio").try_get<int>().error() == ConfigError::FractionalLoss);
+    CHECK(!view.at("debug").as_bool() && view.at("debug").kind() == ConfigValueKind::Boolean);
+    CHECK(view.at("none").is_null());
+    CHECK(view.at("tags").at(2).get<std::string>() == "api");
+    CHECK(view.at("tags")[0].try_get<std::string_view>() == "a");
+    CHECK(view.at("limits").at("mem").as_string() == "512Mi");
+    CHECK(view.at("empty").is_object() && view.at("empty").size() == 0 && !view.at("empty").contains("x"));
+    CHECK(view.at("list").is_array() && view.at("list").size() == 0);
+    CHECK(!view.find("missing") && view.contains("limits") && !view.at("port").contains("x"));
+
+    bool threw = false;
+    try {
+        (void)view.at("missing");
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    CHECK(threw);
+    threw = false;
+    try {
+        (void)view.at("tags").at(3);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    CHECK(threw);
+    threw = false;
+    try {
+        (void)view.at("service").as_integer();
+    } catch (const std::bad_variant_access&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // Members iterate in key order; paths resolve like ConfigPath on the tree.
+    CHECK(view.key_at(0) == "debug" && view.key_at(8) == "tags");
+    for (std::size_t i = 1; i < view.size(); ++i) {
+        CHECK(view.key_at(i - 1) < view.key_at(i));
+    }
+    CHECK(view.resolve(nfrr::config::ConfigPath{"limits.cpu"})->get<int>() == 2);
+    CHECK(view.resolve(nfrr::config::ConfigPath{"/tags/1"})->as_string() == "b");
+    CHECK(view.resolve(nfrr::config::ConfigPath{"tags[7]"}).error() == ConfigError::IndexNotFound);
+    CHECK(view.resolve(nfrr::config::ConfigPath{"port.x"}).error() == ConfigError::TypeMismatch);
+
+    // Strings are pooled ("api" is stored once) and materialize back into an equal tree.
+    CHECK(view.at("service").as_string().data() == view.at("tags")[2].as_string().data());
+    const auto copy = view.materialize<Config>();
+    CHECK(nfrr::config::to_json(copy) == nfrr::config::to_json(*nfrr::config::parse_json<nfrr::config::StdByteAllocator,
+                                                                nfrr::config::SortedObjectPolicy<>>(to_json(*doc))));
+    CHECK(nfrr::config::to_snapshot(copy) == bytes);
+
+    // Rejections: header problems are cheap to spot, corrupt content needs verify_snapshot().
+    const std::string_view all{bytes};
+    CHECK(nfrr::config::open_snapshot(all.substr(0, 20)).error().code == ConfigError::UnexpectedEnd);
+    CHECK(nfrr::config::open_snapshot(all.substr(0, all.size() - 1)).error().code == ConfigError::UnexpectedEnd);
+    std::string bad_magic = bytes;
+    bad_magic[0] = 'X';
+    CHECK(nfrr::config::open_snapshot(bad_magic).error().code == ConfigError::SyntaxError);
+    std::string bad_node = bytes;
+    bad_node[32 + 16 + 0] = 42; // kind of node 1
+    CHECK(nfrr::config::open_snapshot(bad_node).has_value());
+    const nfrr::config::DocumentError expected_error{ConfigError::SyntaxError, 48};
+    CHECK(nfrr::config::verify_snapshot(bad_node).error() == expected_error);
+
+#if NFRRCONFIG_HAS_MMAP
+    namespace fs = std::filesystem;
+    const fs::path file = fs::temp_directory_path() / ("nfrrconfig_snapshot_" + std::to_string(::getpid()) + ".bin");
+    {
+        std::ofstream out{file, std::ios::binary};
+        out << bytes;
+    }
+    auto mapped = nfrr::config::load_snapshot_mmap(file, true);
+    CHECK(mapped.has_value() && mapped->bytes() == bytes);
+    auto moved = std::move(*mapped);
+    CHECK(moved.root().at("limits").at("cpu").get<double>() == 2.0);
+    CHECK(nfrr::config::load_snapshot_mmap(fs::temp_directory_path() / "nfrrconfig_no_such.bin").error().code ==
+          ConfigError::IoError);
+    fs::remove(file);
+#endif
+}
+
+void test_cbor() {
+    using nfrr::config::parse_cbor;
+    using nfrr::config::to_cbor;
+    const auto hex = [](std::initializer_list<int> bytes) {
+        std::string out;
+        for (const int b : bytes) {
+            out.push_back(static_cast<char>(b));
+        }
+        return out;
+    };
+
+    // Encodings from RFC 8949 Appendix A.
+    Config v;
+    v.set_integer(0);
+    CHECK(to_cbor(v) == hex({0x00}));
+    v.set_integer(24);
+    CHECK(to_cbor(v) == hex({0x18, 0x18}));
+    v.set_integer(1000);
+    CHECK(to_cbor(v) == hex({0x19, 0x03, 0xe8}));
+    v.set_integer(-1000);
+    CHECK(to_cbor(v) == hex({0x39, 0x03, 0xe7}));
+    v.set_integer(1'000'000'000'000);
+    CHECK(to_cbor(v) == hex({0x1b, 0x00, 0x00, 0x00, 0xe8, 0xd4, 0xa5, 0x10, 0x00}));
+    v.set_floating(1.1);
+    CHECK(to_cbor(v) == hex({0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a}));
+    v.set_floating(100000.0);
+    CHECK(to_cbor(v) == hex({0xfa, 0x47, 0xc3, 0x50, 0x00}));
+    v.set_string("IETF");
+    CHECK(to_cbor(v) == hex({0x64, 0x49, 0x45, 0x54, 0x46}));
+    v.set_null();
+    CHECK(to_cbor(v) == hex({0xf6}));
+
+    // Decoding: extremes, half floats, undefined, tags, indefinite lengths.
+    CHECK(parse_cbor(hex({0x3b, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}))->as_integer() ==
+          std::numeric_limits<std::int64_t>::min());
+    CHECK(parse_cbor(hex({0x1b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}))->as_floating() ==
+          18446744073709551615.0);
+    CHECK(parse_cbor(hex({0xf9, 0x3c, 0x00}))->as_floating() == 1.0);
+    CHECK(parse_cbor(hex({0xf9, 0xc4, 0x00}))->as_floating() == -4.0);
+    CHECK(parse_cbor(hex({0xf9, 0x00, 0x01}))->as_floating() == 5.960464477539063e-8);
+    CHECK(parse_cbor(hex({0xf7}))->is_null());
+    CHECK(parse_cbor(hex({0xc1, 0x1a, 0x51, 0x4b, 0x67, 0xb0}))->as_integer() == 1363896240);
+    auto indefinite = parse_cbor(hex({0xbf, 0x61, 0x61, 0x01, 0x61, 0x62, 0x9f, 0x02, 0x03, 0xff, 0xff}));
+    CHECK(nfrr::config::to_json(*indefinite) == R"({"a":1,"b":[2,3]})");
+    const auto chunked = hex({0x7f, 0x65, 0x73, 0x74, 0x72, 0x65, 0x61, 0x64, 0x6d, 0x69, 0x6e, 0x67, 0xff});
+    CHECK(parse_cbor(chunked)->as_string() == "streaming");
+
+    // Round trip of a mixed tree; the decoded containers are pre-sized exactly.
+    const auto doc = nfrr::config::parse_json(R"({"name": "svc", "ports": [80, 443, -1], "ratio": 0.1, "on": true,
+                                                  "nested": {"deep": [null, {"x": 1e300}]}, "empty": {}})");
+    const std::string bytes = to_cbor(*doc);
+    auto back = parse_cbor(bytes);
+    CHECK(back.has_value() && same_tree(*back, *doc));
+    CHECK(back->at("ports").as_array().capacity() == 3);
+    auto sorted = parse_cbor<nfrr::config::StdByteAllocator, nfrr::config::SortedObjectPolicy<>>(bytes);
+    CHECK(sorted.has_value() && sorted->at("nested").at("deep").as_array()[1].at("x").as_floating() == 1e300);
+    std::pmr::monotonic_buffer_resource arena;
+    auto pmr_back = parse_cbor(bytes, nfrr::config::PmrByteAllocator{&arena});
+    CHECK(pmr_back->at("name").as_string().get_allocator().resource() == &arena);
+
+    // Errors carry the offset; a huge length prefix does not allocate.
+    CHECK(parse_cbor(bytes.substr(0, bytes.size() - 1)).error().code == ConfigError::UnexpectedEnd);
+    const nfrr::config::DocumentError trailing{ConfigError::SyntaxError, bytes.size()};
+    CHECK(parse_cbor(bytes + hex({0x00})).error() == trailing);
+    CHECK(parse_cbor(hex({0x42, 0x01, 0x02})).error().code == ConfigError::TypeMismatch);
+    CHECK(parse_cbor(hex({0xa1, 0x01, 0x02})).error() == (nfrr::config::DocumentError{ConfigError::TypeMismatch, 1}));
+    CHECK(parse_cbor(hex({0x1c})).error().code == ConfigError::SyntaxError);
+    CHECK(parse_cbor(hex({0xff})).error().code == ConfigError::SyntaxError);
+    CHECK(parse_cbor(hex({0x9b, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00})).error().code ==
+          ConfigError::UnexpectedEnd);
+    CHECK(parse_cbor(std::string(2000, static_cast<char>(0x81))).error().code == ConfigError::DepthExceeded);
+    // A long run of tags is consumed without recursion; the tagged item still decodes.
+    CHECK(parse_cbor(std::string(5'000'000, static_cast<char>(0xc0)) + hex({0x01}))->as_integer() == 1);
+    CHECK(parse_cbor(std::string(64, static_cast<char>(0xc0))).error().code == ConfigError::UnexpectedEnd);
+
+#if NFRRCONFIG_HAS_MMAP
+    // A sequence of items over a pipe, read back one at a time.
+    int fds[2];
+    CHECK(::pipe(fds) == 0);
+    const std::string second = to_cbor(*parse_cbor(hex({0x83, 0x01, 0x02, 0x03})));
+    const std::string stream = bytes + second;
+    CHECK(::write(fds[1], stream.data(), stream.size()) == static_cast<ssize_t>(stream.size()));
+    ::close(fds[1]);
+    nfrr::config::CborFdReader<> reader{fds[0]};
+    auto first_item = reader.read();
+    CHECK(first_item.has_value() && same_tree(*first_item, *doc) && reader.offset() == bytes.size());
+    auto second_item = reader.read();
+    CHECK(second_item.has_value() && nfrr::config::to_json(*second_item) == "[1,2,3]");
+    CHECK(reader.at_end());
+    CHECK(reader.read().error() == (nfrr::config::DocumentError{ConfigError::UnexpectedEnd, stream.size()}));
+    ::close(fds[0]);
+    nfrr::config::CborFdReader<> broken{-1};
+    CHECK(broken.read().error().code == ConfigError::IoError && errno == EBADF);
+#endif
+}
+
+void test_msgpack() {
+    using nfrr::config::parse_json;
+    using nfrr::config::parse_msgpack;
+    using nfrr::config::to_msgpack;
+    const auto hex = [](std::initializer_list<int> bytes) {
+        std::string out;
+        for (const int b : bytes) {
+            out.push_back(static_cast<char>(b));
+        }
+        return out;
+    };
+
+    // Smallest format for each value.
+    Config v;
+    v.set_integer(127);
+    CHECK(to_msgpack(v) == hex({0x7F}));
+    v.set_integer(-32);
+    CHECK(to_msgpack(v) == hex({0xE0}));
+    v.set_integer(128);
+    CHECK(to_msgpack(v) == hex({0xCC, 0x80}));
+    v.set_integer(-33);
+    CHECK(to_msgpack(v) == hex({0xD0, 0xDF}));
+    v.set_integer(70000);
+    CHECK(to_msgpack(v) == hex({0xCE, 0x00, 0x01, 0x11, 0x70}));
+    v.set_integer(-40000);
+    CHECK(to_msgpack(v) == hex({0xD2, 0xFF, 0xFF, 0x63, 0xC0}));
+    v.set_floating(1.5);
+    CHECK(to_msgpack(v) == hex({0xCA, 0x3F, 0xC0, 0x00, 0x00}));
+    v.set_floating(1.1);
+    CHECK(to_msgpack(v) == hex({0xCB, 0x3F, 0xF1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A}));
+    v.set_string("a");
+    CHECK(to_msgpack(v) == hex({0xA1, 'a'}));
+    v.set_string(std::string(32, 'x'));
+    CHECK(to_msgpack(v).substr(0, 2) == hex({0xD9, 32}));
+    v.set_null();
+    CHECK(to_msgpack(v) == hex({0xC0}));
+    auto doc = parse_json(R"({"a": [true, false], "b": {}})");
+    CHECK(doc && to_msgpack(*doc) == hex({0x82, 0xA1, 'a', 0x92, 0xC3, 0xC2, 0xA1, 'b', 0x80}));
+
+    // Round trip, including every integer width and 16-bit container lengths.
+    auto tree = parse_json(R"({"name": "svc", "port": 8080, "ratio": 0.1, "big": 9223372036854775807,
+                               "neg": -9223372036854775807, "nested": {"list": [1, -200, 3.5, null, "x"]}})");
+    CHECK(tree.has_value());
+    auto& list = (*tree)["nested"]["list"].as_array();
+    for (int i = 0; i < 300; ++i) {
+        list.emplace_back().set_integer(i * 1000);
+    }
+    auto back = parse_msgpack(to_msgpack(*tree));
+    CHECK(back && same_tree(*back, *tree));
+
+    // Other producers: uint64 above INT64_MAX, sign-extended int16, str16 key, array32.
+    auto big = parse_msgpack(hex({0xCF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}));
+    CHECK(big && big->is_floating());
+    auto i16 = parse_msgpack(hex({0xD1, 0xFF, 0x38}));
+    CHECK(i16 && i16->as_integer() == -200);
+    auto wide = parse_msgpack(hex({0x81, 0xDA, 0x00, 0x01, 'k', 0xDD, 0x00, 0x00, 0x00, 0x01, 0x07}));
+    CHECK(wide && (*wide)["k"].as_array()[0].as_integer() == 7);
+
+    // Arena decoding: every node comes from the caller's resource, and the default resource is
+    // swapped for null_memory_resource so an allocation that escapes the arena would throw.
+    const std::string packed = to_msgpack(*tree);
+    std::array<std::byte, 64 * 1024> buffer{};
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    {
+        auto msg = parse_msgpack(packed, arena);
+        CHECK(msg.has_value());
+        CHECK(msg->get_allocator().resource() == &arena);
+        CHECK((*msg)["nested"]["list"].as_array().get_allocator().resource() == &arena);
+        CHECK((*msg)["name"].as_string().get_allocator().resource() == &arena);
+        CHECK((*msg)["nested"]["list"].as_array().size() == 305);
+    }
+    std::pmr::set_default_resource(previous);
+    arena.release();
+
+    // Errors.
+    CHECK(parse_msgpack(hex({0x92, 0x01})).error().code == ConfigError::UnexpectedEnd);
+    CHECK(parse_msgpack(hex({0xA3, 'a'})).error().code == ConfigError::UnexpectedEnd);
+    CHECK(parse_msgpack(hex({0xDA, 0x00})).error().code == ConfigError::UnexpectedEnd);
+    CHECK(parse_msgpack(hex({0xC1})).error().code == ConfigError::SyntaxError);
+    CHECK(parse_msgpack(hex({0x01, 0x02})).error().offset == 1);
+    CHECK(parse_msgpack(hex({0xC4, 0x00})).error().code == ConfigError::TypeMismatch);
+    CHECK(parse_msgpack(hex({0xD4, 0x01, 0x00})).error().code == ConfigError::TypeMismatch);
+    const auto int_key = parse_msgpack(hex({0x81, 0x01, 0x02}));
+    CHECK(int_key.error().code == ConfigError::TypeMismatch && int_key.error().offset == 1);
+    // A huge length prefix fails on truncation without reserving that much.
+    CHECK(parse_msgpack(hex({0xDD, 0xFF, 0xFF, 0xFF, 0xFF})).error().code == ConfigError::UnexpectedEnd);
+    CHECK(parse_msgpack(std::string(NFRRCONFIG_JSON_MAX_DEPTH + 1, '\x91')).error().code ==
+          ConfigError::DepthExceeded);
+}
+
+void test_config_document() {
+    // Upstream that counts outstanding blocks, to see what the document takes from it.
+    class CountingResource : public std::pmr::memory_resource {
+      public:
+        std::size_t allocations = 0;
+        std::size_t outstanding = 0;
+
+      private:
+        void* do_allocate(std::size_t bytes, std::size_t align) override {
+            ++allocations;
+            ++outstanding;
+            return std::pmr::new_delete_resource()->allocate(bytes, align);
+        }
+        void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+            --outstanding;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+        }
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    CountingResource upstream;
+    {
+        nfrr::config::ConfigDocument doc{64 * 1024, &upstream};
+        CHECK(upstream.allocations == 1 && doc.root().is_null());
+
+        // Children built through the root, detached values and copies from another resource all land
+        // on the arena, even with the default resource disabled.
+        std::pmr::monotonic_buffer_resource elsewhere;
+        nfrr::config::ConfigValuePmr foreign{nfrr::config::PmrByteAllocator{&elsewhere}};
+        foreign["from"].assign("another resource, long enough to defeat SSO");
+        std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+        doc["server"]["host"].assign("localhost, long enough to defeat SSO");
+        doc["server"]["ports"].set_array();
+        doc["server"]["ports"].as_array().emplace_back().set_integer(80);
+        auto overlay = doc.make_value();
+        overlay["debug"].set_bool(true);
+        doc["overlay"] = std::move(overlay);
+        doc["copied"] = foreign;
+        std::pmr::set_default_resource(previous);
+        CHECK(doc.at("server.host").as_string().get_allocator().resource() == doc.resource());
+        CHECK(doc.at("server.ports").as_array().get_allocator().resource() == doc.resource());
+        CHECK(doc.at("overlay.debug").get_allocator().resource() == doc.resource());
+        CHECK(doc.at("copied.from").as_string().get_allocator().resource() == doc.resource());
+        CHECK(doc.find("server.ports[0]")->get<int>() == 80);
+        CHECK(doc.find("server.missing") == nullptr);
+        bool threw = false;
+        try {
+            static_cast<void>(doc.at("server.missing"));
+        }
+        catch (const std::out_of_range&) {
+            threw = true;
+        }
+        CHECK(threw);
+
+        // reset() rewinds the arena; a warmed-up document no longer touches the upstream resource.
+        doc.reset();
+        CHECK(doc.root().is_null() && upstream.allocations == 1);
+        const std::string text = R"({"name": "svc", "limits": [1, 2, 3], "flags": {"debug": true}})";
+        for (int round = 0; round < 100; ++round) {
+            CHECK(doc.parse_json(text).has_value());
+            CHECK(doc.at("limits[2]").get<int>() == 3);
+        }
+        CHECK(upstream.allocations == 1);
+        CHECK(doc.at("flags").as_object().get_allocator().resource() == doc.resource());
+
+        // Binary parsers, and a failed parse leaving a null root.
+        CHECK(doc.parse_msgpack(nfrr::config::to_msgpack(foreign)).has_value());
+        CHECK(doc.at("from").as_string() == "another resource, long enough to defeat SSO");
+        CHECK(doc.parse_cbor(nfrr::config::to_cbor(foreign)).has_value());
+        CHECK(doc.at("from").as_string().get_allocator().resource() == doc.resource());
+        const auto bad = doc.parse_json(R"({"a": [1, 2)");
+        CHECK(!bad && bad.error().code == ConfigError::UnexpectedEnd && doc.root().is_null());
+
+        // Overflowing the first block pulls more from upstream; teardown returns everything.
+        for (int i = 0; i < 5000; ++i) {
+            // append(): see test_large_object_index().
+            doc[std::string{"k"}.append(std::to_string(i))].assign("a value long enough to need its own allocation");
+        }
+        CHECK(upstream.allocations > 1);
+    }
+    CHECK(upstream.outstanding == 0);
+
+    // Caller-supplied buffer, nothing from upstream while it suffices.
+    std::array<std::byte, 8 * 1024> buffer{};
+    CountingResource overflow;
+    {
+        nfrr::config::ConfigDocument doc{buffer.data(), buffer.size(), &overflow};
+        CHECK(doc.parse_json(R"({"a": {"b": [true, null, "text"]}})").has_value());
+        CHECK(doc.at("a.b[2]").as_string() == "text");
+    }
+    CHECK(overflow.allocations == 0);
+}
+
+void test_compact_nodes() {
+    using nfrr::config::ConfigValuePmrCompact;
+    using nfrr::config::ConfigValueStdCompact;
+    using nfrr::config::PmrByteAllocator;
+    using nfrr::config::StdByteAllocator;
+    using Compact = nfrr::config::CompactNodePolicy<>;
+    using SortedCompactPolicy = nfrr::config::CompactNodePolicy<nfrr::config::SortedObjectPolicy<>>;
+    static_assert(sizeof(ConfigValueStdCompact) == 16 && sizeof(ConfigValuePmrCompact) == 16);
+    static_assert(sizeof(ConfigValuePmrCompact) < sizeof(nfrr::config::ConfigValuePmr));
+
+    // Same API, same results as the default layout.
+    const std::string text = R"({"name": "service", "port": 8080, "ratio": 0.25, "debug": true, "none": null,
+                                 "tags": ["a", "b", "a long tag that does not fit in SSO"],
+                                 "nested": {"x": [1, [2, {}]]}})";
+    auto compact = nfrr::config::parse_json<StdByteAllocator, Compact>(text);
+    auto regular = nfrr::config::parse_json(text);
+    CHECK(compact && regular);
+    CHECK(nfrr::config::to_json(*compact) == nfrr::config::to_json(*regular));
+    CHECK((*compact)["port"].get<int>() == 8080 && (*compact)["debug"].as_bool());
+    CHECK((*compact)["tags"].as_array()[2].get<std::string>() == "a long tag that does not fit in SSO");
+    CHECK((*compact)["none"].is_null() && (*compact)["ratio"].as_floating() == 0.25);
+    CHECK(nfrr::config::ConfigPath::parse("nested.x[1][0]")->at(*compact).get<int>() == 2);
+    const auto unpacked = nfrr::config::parse_msgpack<StdByteAllocator, Compact>(nfrr::config::to_msgpack(*compact));
+    CHECK(unpacked && nfrr::config::to_json(*unpacked) == nfrr::config::to_json(*regular));
+
+    // Setters replace out-of-line payloads; references survive sibling growth (nodes are 16 bytes,
+    // payloads stay put).
+    ConfigValueStdCompact v;
+    v.set_string("a string long enough to need its own buffer");
+    CHECK(v.is_string() && v.as_string().size() == 43);
+    v.set_integer(-5);
+    CHECK(v.as_integer() == -5);
+    auto& items = v["items"];
+    items.set_array();
+    auto& first = items.as_array().emplace_back();
+    first.set_object();
+    auto* first_object = &first.as_object();
+    for (int i = 0; i < 1000; ++i) {
+        items.as_array().emplace_back().set_integer(i);
+    }
+    CHECK(&items.as_array()[0].as_object() == first_object);
+    CHECK(items.as_array().back().as_integer() == 999);
+    bool threw = false;
+    try {
+        static_cast<void>(v.as_bool());
+    }
+    catch (const std::bad_variant_access&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // Copies are deep; moves steal; self-assignment from a descendant is safe.
+    ConfigValueStdCompact copy = v;
+    copy["items"].as_array()[1].set_integer(-1);
+    CHECK(v["items"].as_array()[1].as_integer() == 0);
+    ConfigValueStdCompact moved = std::move(copy);
+    CHECK(moved["items"].as_array()[1].as_integer() == -1);
+    moved = std::move(moved["items"]);
+    CHECK(moved.is_array() && moved.as_array().size() == 1001);
+    moved = moved.as_array()[2];
+    CHECK(moved.as_integer() == 1);
+
+    // pmr: the resource shares a word with the tag, and every payload stays on it.
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::monotonic_buffer_resource other_arena;
+    ConfigValuePmrCompact p{PmrByteAllocator{&arena}};
+    p["list"].set_array();
+    p["list"].as_array().emplace_back().set_string("on the arena, and long enough to defeat SSO");
+    p["flag"].set_bool(true);
+    CHECK(p.get_allocator().resource() == &arena && p.is_object());
+    CHECK(p["list"].get_allocator().resource() == &arena);
+    CHECK(p["list"].as_array().get_allocator().resource() == &arena);
+    CHECK(p["list"].as_array()[0].as_string().get_allocator().resource() == &arena);
+    ConfigValuePmrCompact q{PmrByteAllocator{&other_arena}};
+    q = p;
+    CHECK(q.get_allocator().resource() == &other_arena && q.as_object().get_allocator().resource() == &other_arena);
+    CHECK(q["list"].as_array()[0].as_string().get_allocator().resource() == &other_arena);
+    q = std::move(p);
+    CHECK(q.get_allocator().resource() == &other_arena && q["flag"].as_bool());
+
+    // The arena-backed document works with compact nodes too.
+    {
+        nfrr::config::BasicConfigDocument<Compact> doc;
+        CHECK(doc.parse_json(text).has_value());
+        CHECK(doc.at("tags[1]").as_string() == "b");
+        CHECK(doc.at("nested.x").as_array().get_allocator().resource() == doc.resource());
+    }
+
+    // Compact nodes combine with the other policies.
+    static_assert(sizeof(nfrr::config::BasicConfigValue<StdByteAllocator, SortedCompactPolicy>) == 16);
+    auto sorted = nfrr::config::parse_json<StdByteAllocator, SortedCompactPolicy>(text);
+    CHECK(sorted && sorted->as_object().begin()->first == "debug");
+    using ViewCompact = nfrr::config::CompactNodePolicy<nfrr::config::ZeroCopyStringPolicy<>>;
+    auto pinned = nfrr::config::parse_json_pinned<StdByteAllocator, ViewCompact>(text);
+    CHECK(pinned && (*pinned)["name"].as_string().is_view());
+}
+
+void test_interned_keys() {
+    using nfrr::config::ConfigValuePmrInterned;
+    using nfrr::config::InternedKey;
+    using nfrr::config::KeyPool;
+    using nfrr::config::PmrByteAllocator;
+    using nfrr::config::StdByteAllocator;
+    using Interned = nfrr::config::InternedKeyPolicy<>;
+    static_assert(sizeof(InternedKey) == sizeof(void*));
+
+    // Keys repeated across sibling objects are stored once; handles identify them.
+    KeyPool pool;
+    ConfigValuePmrInterned root{PmrByteAllocator{&pool}};
+    auto& list = root["servers"];
+    list.set_array();
+    for (int i = 0; i < 200; ++i) {
+        auto& server = list.as_array().emplace_back();
+        server["host"].set_string("localhost");
+        server["port"].set_integer(8000 + i);
+    }
+    CHECK(pool.size() == 3);
+    const auto& objects = list.as_array();
+    CHECK(objects[0].as_object().begin()->first.handle() == objects[199].as_object().begin()->first.handle());
+    const InternedKey port = pool.intern("port");
+    CHECK(port.pool() == &pool && port == "port" && pool.size() == 3);
+    CHECK(objects[7].at(port).as_integer() == 8007);
+    CHECK(list.as_array()[9][port].as_integer() == 8009);
+    CHECK(objects[7].at("host").as_string() == "localhost");
+
+    // Large objects look interned keys up through the hash index by handle.
+    ConfigValuePmrInterned wide{PmrByteAllocator{&pool}};
+    for (int i = 0; i < 300; ++i) {
+        wide["key" + std::to_string(i)].set_integer(i);
+    }
+    CHECK(wide.at(pool.intern("key123")).as_integer() == 123);
+    CHECK(wide.find(pool.intern("key299")) != wide.as_object().end());
+    CHECK(wide.as_object().find(pool.intern("missing")) == wide.as_object().end());
+    CHECK(wide.contains("key0") && !wide.contains("key300"));
+    wide.as_object().erase("key5");
+    CHECK(wide.at(pool.intern("key6")).as_integer() == 6 && wide.as_object().begin()->first.pool() == &pool);
+
+    // Copies onto another resource get standalone keys and fall back to comparing characters.
+    std::pmr::monotonic_buffer_resource arena;
+    ConfigValuePmrInterned copy{root, PmrByteAllocator{&arena}};
+    const auto& copied_key = copy["servers"].as_array()[3].as_object().begin()->first;
+    CHECK(copied_key.pool() == nullptr && copied_key == "host");
+    CHECK(copy["servers"].as_array()[3].at(port).as_integer() == 8003);
+    KeyPool other_pool;
+    ConfigValuePmrInterned rehomed{root, PmrByteAllocator{&other_pool}};
+    CHECK(other_pool.size() == 3 && rehomed["servers"].as_array()[4].at(port).as_integer() == 8004);
+    CHECK(rehomed.at("servers").as_array()[0].as_object().begin()->first.pool() == &other_pool);
+
+    // Text round trips are unaffected.
+    const std::string text = R"({"a":{"x":1,"y":[true,null]},"b":{"x":2,"y":[]},"":"empty key"})";
+    auto parsed = nfrr::config::parse_json<PmrByteAllocator, Interned>(text, PmrByteAllocator{&other_pool});
+    CHECK(parsed && nfrr::config::to_json(*parsed) == text);
+    CHECK((*parsed)[""].as_string() == "empty key");
+
+    // Without a pool, and with std::allocator, keys own their characters.
+    auto standalone = nfrr::config::parse_json<StdByteAllocator, Interned>(text);
+    CHECK(standalone && nfrr::config::to_json(*standalone) == text);
+    CHECK(standalone->at("b").at("x").as_integer() == 2);
+    CHECK(standalone->as_object().begin()->first.pool() == nullptr);
+    using SortedInterned = nfrr::config::InternedKeyPolicy<nfrr::config::SortedObjectPolicy<>>;
+    auto sorted = nfrr::config::parse_json<StdByteAllocator, SortedInterned>(text);
+    CHECK(sorted && sorted->as_object().begin()->first.empty() && sorted->at("a").at("x").as_integer() == 1);
+
+    // Documents intern into a pool on their arena, dropped by reset().
+    nfrr::config::InternedConfigDocument doc;
+    CHECK(doc.parse_json(text).has_value());
+    const InternedKey x = doc.intern("x");
+    CHECK(x.interned_with(doc.get_allocator()) && doc.at("b").at(x).as_integer() == 2);
+    CHECK(doc.root()["a"].as_object().begin()->first.handle() == x.handle());
+    doc.reset();
+    CHECK(doc.root().is_null());
+    CHECK(doc.parse_json(R"({"x":3})").has_value() && doc.root().at(doc.intern("x")).as_integer() == 3);
+    nfrr::config::BasicConfigDocument<nfrr::config::CompactNodePolicy<Interned>> compact;
+    CHECK(compact.parse_json(text).has_value() && compact.at("a.y[0]").as_bool());
+    CHECK(compact.root().at(compact.intern("b")).at(compact.intern("x")).as_integer() == 2);
+}
+
+void test_shared_subtrees() {
+    using nfrr::config::ConfigValuePmrShared;
+    using nfrr::config::ConfigValueStdShared;
+    using nfrr::config::PmrByteAllocator;
+    using nfrr::config::StdByteAllocator;
+    using Shared = nfrr::config::SharedNodePolicy<>;
+    static_assert(sizeof(ConfigValueStdShared) == 16 && sizeof(ConfigValuePmrShared) == 16);
+
+    // Tenants built from one template share every subtree they have in common.
+    const std::string base = R"({"limits": {"qps": 100, "burst": [1, 2, 3]}, "name": "a shared template name",
+                                 "routes": [{"path": "/a", "ttl": 1.5}, {"path": "/b", "ttl": -0.0}]})";
+    nfrr::config::SubtreePool<ConfigValueStdShared> pool;
+    std::vector<ConfigValueStdShared> tenants;
+    for (int i = 0; i < 100; ++i) {
+        auto tenant = nfrr::config::parse_json<StdByteAllocator, Shared>(base);
+        CHECK(tenant.has_value());
+        (*tenant)["id"].set_integer(i);
+        pool.intern(*tenant);
+        tenants.push_back(std::move(*tenant));
+    }
+    const auto& first = std::as_const(tenants[0]);
+    const auto& last = std::as_const(tenants[99]);
+    CHECK(first.at("limits").shared_identity() == last.at("limits").shared_identity());
+    CHECK(first.at("routes").shared_identity() == last.at("routes").shared_identity());
+    CHECK(first.at("name").shared_identity() == last.at("name").shared_identity());
+    CHECK(first.shared_identity() != last.shared_identity());
+    CHECK(first.at("limits").use_count() == 101); // 100 tenants plus the pool
+    CHECK(nfrr::config::hash_value(first.at("routes")) == nfrr::config::hash_value(last.at("routes")));
+    CHECK(nfrr::config::hash_value(first) != nfrr::config::hash_value(last));
+    const auto reparsed = nfrr::config::parse_json<StdByteAllocator, Shared>(nfrr::config::to_json(tenants[42]));
+    CHECK(reparsed && nfrr::config::to_json(*reparsed) == nfrr::config::to_json(tenants[42]));
+
+    // Writes copy only the nodes on the path to the change; the other tenants are unaffected.
+    tenants[5]["limits"]["qps"].set_integer(7);
+    CHECK(tenants[5].at("limits").at("qps").as_integer() == 7 && first.at("limits").at("qps").as_integer() == 100);
+    const auto& changed = std::as_const(tenants[5]);
+    CHECK(changed.at("limits").at("burst").shared_identity() == first.at("limits").at("burst").shared_identity());
+    CHECK(changed.at("routes").shared_identity() == first.at("routes").shared_identity());
+    CHECK(first.at("limits").use_count() == 101); // the pool still holds tenant 5's old root
+
+    // Copies share in O(1) and separate on write.
+    {
+        ConfigValueStdShared copy = tenants[7];
+        CHECK(std::as_const(copy).shared_identity() == std::as_const(tenants[7]).shared_identity());
+        copy["routes"].as_array().emplace_back().set_string("extra");
+        CHECK(copy["routes"].as_array().size() == 3 && first.at("routes").as_array().size() == 2);
+        CHECK(std::as_const(copy).at("limits").shared_identity() == first.at("limits").shared_identity());
+    }
+
+    // Floating values are compared by their bits: -0.0 is not merged with 0.0.
+    auto zeros = nfrr::config::parse_json<StdByteAllocator, Shared>(R"([[0.0], [-0.0], [0.0], "x", "x"])");
+    CHECK(zeros.has_value());
+    nfrr::config::deduplicate(*zeros);
+    const auto& z = std::as_const(*zeros).as_array();
+    CHECK(z[0].shared_identity() == z[2].shared_identity() && z[0].shared_identity() != z[1].shared_identity());
+    CHECK(z[3].shared_identity() == z[4].shared_identity() && z[1].as_array()[0].as_floating() == 0.0);
+
+    // pmr: only values on equal resources share; copies to another resource are deep.
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::monotonic_buffer_resource other_arena;
+    nfrr::config::SubtreePool<ConfigValuePmrShared> pmr_pool;
+    auto a = nfrr::config::parse_json<PmrByteAllocator, Shared>(base, PmrByteAllocator{&arena});
+    auto b = nfrr::config::parse_json<PmrByteAllocator, Shared>(base, PmrByteAllocator{&arena});
+    auto c = nfrr::config::parse_json<PmrByteAllocator, Shared>(base, PmrByteAllocator{&other_arena});
+    CHECK(a && b && c);
+    pmr_pool.intern(*a);
+    pmr_pool.intern(*b);
+    pmr_pool.intern(*c);
+    CHECK(std::as_const(*a).shared_identity() == std::as_const(*b).shared_identity());
+    CHECK(std::as_const(*a).shared_identity() != std::as_const(*c).shared_identity());
+    ConfigValuePmrShared moved{*a, PmrByteAllocator{&other_arena}};
+    CHECK(std::as_const(moved).at("limits").shared_identity() != std::as_const(*a).at("limits").shared_identity());
+    CHECK(std::as_const(moved).at("limits").get_allocator().resource() == &other_arena);
+    pool.clear();
+    CHECK(pool.size() == 0 && first.at("limits").use_count() == 99);
+}
+
+void test_copy_on_write() {
+    using nfrr::config::ConfigValuePmrShared;
+    using nfrr::config::ConfigValueStdShared;
+    using nfrr::config::PmrByteAllocator;
+    using Shared = nfrr::config::SharedNodePolicy<>;
+
+    // A pmr snapshot copy is O(1): it shares the whole tree and stays on the same resource.
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::monotonic_buffer_resource other_arena;
+    ConfigValuePmrShared current{PmrByteAllocator{&arena}};
+    auto& services = current["services"];
+    services.set_array();
+    for (int i = 0; i < 1000; ++i) {
+        auto& service = services.as_array().emplace_back();
+        service["name"].set_string("service-" + std::to_string(i) + "-with-a-long-enough-name");
+        service["port"].set_integer(9000 + i);
+    }
+    const ConfigValuePmrShared snapshot = current;
+    const auto& live = std::as_const(current);
+    CHECK(snapshot.shared_identity() == live.shared_identity() && snapshot.get_allocator().resource() == &arena);
+    CHECK(snapshot.at("services").use_count() == 1); // one root payload refers to it
+
+    // A write copies the root, the services array and the one service on its path.
+    current["services"].as_array()[500]["port"].set_integer(1);
+    const auto& old_services = snapshot.at("services").as_array();
+    const auto& new_services = live.at("services").as_array();
+    CHECK(snapshot.shared_identity() != live.shared_identity());
+    CHECK(&old_services != &new_services && old_services[500].shared_identity() != new_services[500].shared_identity());
+    CHECK(old_services[499].shared_identity() == new_services[499].shared_identity());
+    CHECK(old_services[500].at("name").shared_identity() == new_services[500].at("name").shared_identity());
+    CHECK(old_services[500].at("port").as_integer() == 9500 && new_services[500].at("port").as_integer() == 1);
+
+    // Moving a shared value to another resource copies it and leaves the other owners intact.
+    ConfigValuePmrShared handle = snapshot;
+    ConfigValuePmrShared rehomed{std::move(handle), PmrByteAllocator{&other_arena}};
+    CHECK(rehomed.get_allocator().resource() == &other_arena);
+    CHECK(std::as_const(rehomed).at("services").as_array()[500].at("port").as_integer() == 9500);
+    CHECK(old_services.size() == 1000 && snapshot.shared_identity() != std::as_const(rehomed).shared_identity());
+
+    // Each copy kept in a history is O(1); only rewritten nodes are duplicated.
+    std::vector<ConfigValueStdShared> history;
+    auto config = nfrr::config::parse_json<nfrr::config::StdByteAllocator, Shared>(R"({"limits": {"qps": 1}})");
+    CHECK(config.has_value());
+    for (int i = 0; i < 10; ++i) {
+        history.push_back(*config);
+        (*config)["limits"]["qps"].set_integer(i + 2);
+    }
+    CHECK(std::as_const(history[3]).at("limits").at("qps").as_integer() == 4);
+    CHECK(std::as_const(*config).at("limits").at("qps").as_integer() == 11);
+    CHECK(std::as_const(history[9]).use_count() == 1 && std::as_const(*config).use_count() == 1);
+
+    // Snapshots of an arena document share its arena.
+    nfrr::config::BasicConfigDocument<Shared> doc;
+    CHECK(doc.parse_json(R"({"a": {"b": [1, 2]}, "c": "text"})").has_value());
+    {
+        const auto copy = doc.root();
+        doc["c"].set_string("changed");
+        CHECK(copy.at("c").as_string() == "text" && doc.at("c").as_string() == "changed");
+        CHECK(copy.at("a").shared_identity() == std::as_const(doc.root()).at("a").shared_identity());
+    }
+}
+
+void test_config_store() {
+    using nfrr::config::ConfigValueStdShared;
+    using Store = nfrr::config::ConfigStore<nfrr::config::StdByteAllocator, nfrr::config::SharedNodePolicy<>>;
+
+    auto initial = nfrr::config::parse_json<nfrr::config::StdByteAllocator, nfrr::config::SharedNodePolicy<>>(
+        R"({"limits": {"qps": 100}, "a": 0, "b": 0})");
+    CHECK(initial.has_value());
+    Store store{std::move(*initial), 5};
+    auto reader = store.reader();
+
+    // A pinned version survives later publishes and is reclaimed once unpinned.
+    {
+        auto pinned = reader.pin();
+        CHECK(pinned.version() == 1 && pinned->at("limits").at("qps").as_integer() == 100);
+        CHECK(store.update([](ConfigValueStdShared& root) { root["limits"]["qps"].set_integer(200); }) == 2);
+        CHECK(pinned->at("limits").at("qps").as_integer() == 100 && store.version() == 2);
+        {
+            auto nested = reader.pin(); // nested pins see the same version
+            CHECK(nested.version() == 1);
+        }
+        CHECK(store.reclaim() == 1 && store.retired() == 1);
+    }
+    CHECK(store.reclaim() == 0);
+    {
+        auto pinned = reader.pin();
+        CHECK(pinned.version() == 2 && (*pinned).at("limits").at("qps").as_integer() == 200);
+    }
+
+    // Readers own slots; running out throws, and destroyed readers give theirs back.
+    {
+        std::vector<Store::Reader> readers;
+        for (int i = 0; i < 4; ++i) {
+            readers.push_back(store.reader());
+        }
+        bool threw = false;
+        try {
+            static_cast<void>(store.reader());
+        }
+        catch (const std::length_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+    auto another = store.reader();
+
+    // Concurrent readers always see complete versions while a writer keeps publishing.
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([&] {
+            auto local = store.reader();
+            std::uint64_t last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                auto pinned = local.pin();
+                const auto& root = *pinned;
+                if (root.at("a").as_integer() != root.at("b").as_integer() || pinned.version() < last) {
+                    torn.fetch_add(1);
+                }
+                last = pinned.version();
+            }
+        });
+    }
+    for (int i = 1; i <= 500; ++i) {
+        store.update([i](ConfigValueStdShared& root) {
+            root["a"].set_integer(i);
+            root["b"].set_integer(i);
+        });
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(torn.load() == 0 && store.version() == 502);
+    CHECK(store.reclaim() == 0);
+    auto last = another.pin();
+    CHECK(last->at("a").as_integer() == 500 && last->at("limits").at("qps").as_integer() == 200);
+}
+
+void test_config_read_cache() {
+    using nfrr::config::CachedSetting;
+    using nfrr::config::ConfigValueStdShared;
+    using Shared = nfrr::config::SharedNodePolicy<>;
+    using Store = nfrr::config::ConfigStore<nfrr::config::StdByteAllocator, Shared>;
+    using Cache = nfrr::config::ConfigReadCache<nfrr::config::StdByteAllocator, Shared>;
+
+    auto initial = nfrr::config::parse_json<nfrr::config::StdByteAllocator, Shared>(
+        R"({"limits": {"qps": 100, "ratio": 0.5}, "name": "edge", "list": [1, 2]})");
+    CHECK(initial.has_value());
+    Store store{std::move(*initial)};
+    static const CachedSetting<int> qps{"limits.qps"};
+    static const CachedSetting<double> ratio{"/limits/ratio"};
+    static const CachedSetting<std::string> name{"name"};
+    static const CachedSetting<int> missing{"limits.burst"};
+    static const CachedSetting<int> not_an_int{"list"};
+
+    // Hits do not touch the tree; a publish invalidates every entry once.
+    Cache cache{store};
+    CHECK(cache.get(qps) == 100 && cache.get(ratio) == 0.5 && cache.get(name) == "edge");
+    CHECK(cache.misses() == 3);
+    for (int i = 0; i < 100; ++i) {
+        CHECK(cache.get(qps) == 100);
+    }
+    CHECK(cache.misses() == 3);
+    store.update([](ConfigValueStdShared& root) { root["limits"]["qps"].set_integer(250); });
+    CHECK(cache.get(qps) == 250 && cache.get(qps) == 250 && cache.get(name) == "edge");
+    CHECK(cache.misses() == 5);
+
+    // Errors are cached too.
+    CHECK(cache.try_get(missing).error() == ConfigError::KeyNotFound);
+    CHECK(cache.try_get(not_an_int).error() == ConfigError::TypeMismatch);
+    bool threw = false;
+    try {
+        static_cast<void>(cache.get(missing));
+    }
+    catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw && cache.misses() == 7);
+    store.update([](ConfigValueStdShared& root) { root["limits"]["burst"].set_integer(10); });
+    CHECK(cache.get(missing) == 10);
+
+    // One cache per thread; each sees the published values in order.
+    std::atomic<bool> done{false};
+    std::atomic<int> errors{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([&] {
+            Cache local{store};
+            int last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                const int value = local.get(qps);
+                if (value < last) {
+                    errors.fetch_add(1);
+                }
+                last = value;
+            }
+        });
+    }
+    for (int i = 251; i <= 400; ++i) {
+        store.update([i](ConfigValueStdShared& root) { root["limits"]["qps"].set_integer(i); });
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(errors.load() == 0 && cache.get(qps) == 400);
+}
+
+void test_config_watcher() {
+#if NFRRCONFIG_HAS_INOTIFY
+    namespace fs = std::filesystem;
+    using nfrr::config::ConfigValueStdShared;
+    using Shared = nfrr::config::SharedNodePolicy<>;
+    using Store = nfrr::config::ConfigStore<nfrr::config::StdByteAllocator, Shared>;
+    using Watcher = nfrr::config::ConfigWatcher<nfrr::config::StdByteAllocator, Shared>;
+
+    const fs::path dir = fs::temp_directory_path() / ("nfrrconfig_watch_" + std::to_string(::getpid()));
+    fs::remove_all(dir);
+    fs::create_directories(dir / "conf.d");
+    const auto write = [&](const fs::path& file, std::string_view text) {
+        std::ofstream{dir / file, std::ios::binary | std::ios::trunc} << text;
+    };
+    // Atomic replacement as editors and deployment tools do it.
+    const auto replace = [&](const fs::path& file, std::string_view text) {
+        write(file.parent_path() / ("." + file.filename().string() + ".tmp"), text);
+        fs::rename(dir / file.parent_path() / ("." + file.filename().string() + ".tmp"), dir / file);
+    };
+    write("main.json", R"({"port": 80})");
+    write("conf.d/db.json", R"({"host": "db1"})");
+    write("conf.d/cache.json", R"({"size": 64})");
+    write("conf.d/notes.txt", "ignored");
+
+    std::mutex mutex;
+    std::vector<Watcher::Change> changes;
+    const auto wait_for = [&](std::size_t count) {
+        for (int i = 0; i < 500; ++i) {
+            {
+                const std::lock_guard lock{mutex};
+                if (changes.size() >= count) {
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+        return false;
+    };
+    const auto root = [](Store& s) { return s.reader().pin().root(); };
+
+    Store store;
+    Watcher watcher{store,
+                    [&](const Watcher::Change& change) {
+                        const std::lock_guard lock{mutex};
+                        changes.push_back(change);
+                    },
+                    std::chrono::milliseconds{100}};
+    watcher.watch_file("main", dir / "main.json");
+    watcher.watch_directory(dir / "conf.d");
+    bool threw = false;
+    try {
+        watcher.watch_file("main", dir / "other.json");
+    }
+    catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    auto initial = watcher.start();
+    CHECK(initial.has_value() && initial->version == 2 && initial->updated.size() == 3 && watcher.running());
+    const ConfigValueStdShared first = root(store);
+    CHECK(first.at("main").at("port").get<int>() == 80 && first.at("db").at("host").as_string() == "db1");
+    CHECK(first.at("cache").at("size").get<int>() == 64 && !first.contains("notes"));
+
+    // A burst of writes and a rename is one reload; unchanged files keep their subtree.
+    for (int i = 81; i <= 90; ++i) {
+        write("main.json", R"({"port": )" + std::to_string(i) + "}");
+    }
+    replace("conf.d/db.json", R"({"host": "db2"})");
+    CHECK(wait_for(1));
+    const ConfigValueStdShared second = root(store);
+    CHECK(changes[0].version == 3 && changes[0].updated.size() == 2 && store.version() == 3);
+    CHECK(second.at("main").at("port").get<int>() == 90 && second.at("db").at("host").as_string() == "db2");
+    CHECK(second.at("cache").shared_identity() == first.at("cache").shared_identity());
+
+    // Rewriting the same content publishes nothing; a malformed file keeps its previous value.
+    write("conf.d/cache.json", R"({"size": 64})");
+    write("main.json", R"({"port": )");
+    CHECK(wait_for(2));
+    CHECK(changes[1].version == 0 && changes[1].updated.empty() && changes[1].failed.size() == 1);
+    CHECK(changes[1].failed[0].first == "main" && changes[1].failed[0].second.code == ConfigError::UnexpectedEnd);
+    CHECK(store.version() == 3);
+
+    // New files join, removed files leave.
+    write("conf.d/queue.json", R"({"depth": 8})");
+    fs::remove(dir / "conf.d" / "cache.json");
+    CHECK(wait_for(3));
+    const ConfigValueStdShared third = root(store);
+    CHECK(changes[2].updated == std::vector<std::string>{"queue"} && changes[2].removed.size() == 1);
+    CHECK(third.at("queue").at("depth").get<int>() == 8 && !third.contains("cache") && third.contains("main"));
+
+    watcher.stop();
+    CHECK(!watcher.running());
+    Watcher missing{store};
+    missing.watch_directory(dir / "missing");
+    CHECK(!missing.start().has_value() && !missing.running());
+
+    // A reload that throws is reported as aborted, publishes nothing, and the watcher keeps going.
+    using PmrStore = nfrr::config::ConfigStore<nfrr::config::PmrByteAllocator, Shared>;
+    using PmrWatcher = nfrr::config::ConfigWatcher<nfrr::config::PmrByteAllocator, Shared>;
+    FailingResource failing;
+    PmrStore pmr_store;
+    std::vector<PmrWatcher::Change> pmr_changes;
+    PmrWatcher pmr_watcher{pmr_store,
+                           [&](const PmrWatcher::Change& change) {
+                               const std::lock_guard lock{mutex};
+                               pmr_changes.push_back(change);
+                           },
+                           std::chrono::milliseconds{50}, nfrr::config::PmrByteAllocator{&failing}};
+    write("pmr.json", R"({"port": 80})");
+    pmr_watcher.watch_file("main", dir / "pmr.json");
+    CHECK(pmr_watcher.start().has_value() && pmr_store.version() == 2);
+    const auto wait_pmr = [&](std::size_t count) {
+        for (int i = 0; i < 500; ++i) {
+            {
+                const std::lock_guard lock{mutex};
+                if (pmr_changes.size() >= count) {
+                    return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+        return false;
+    };
+    failing.fail = true;
+    write("pmr.json", R"({"port": 443, "name": "a string long enough to need its own allocation"})");
+    CHECK(wait_pmr(1));
+    failing.fail = false;
+    CHECK(pmr_changes[0].version == 0 && pmr_changes[0].failed.size() == 1);
+    CHECK(pmr_changes[0].failed[0].second.code == ConfigError::Aborted && pmr_store.version() == 2);
+    CHECK(pmr_watcher.running());
+    write("pmr.json", R"({"port": 444})");
+    CHECK(wait_pmr(2));
+    CHECK(pmr_changes[1].version == 3 && pmr_store.reader().pin().root().at("main").at("port").get<int>() == 444);
+    pmr_watcher.stop();
+    fs::remove_all(dir);
+#endif
+}
+
+void test_config_diff() {
+    using nfrr::config::PatchOp;
+    const auto parse = [](std::string_view text) { return *nfrr::config::parse_json(text); };
+    // Operations rendered as "op path" or "op path value-json", for compact expectations.
+    const auto render = [](const auto& patch) {
+        std::vector<std::string> out;
+        for (const auto& op : patch) {
+            static constexpr std::array<std::string_view, 6> NAMES{"add", "remove", "replace", "move", "copy", "test"};
+            std::string line{NAMES[static_cast<std::size_t>(op.op)]};
+            line += " " + op.path;
+            if (op.op != PatchOp::Remove) {
+                line += " " + nfrr::config::to_json(op.value);
+            }
+            out.push_back(std::move(line));
+        }
+        return out;
+    };
+    using Lines = std::vector<std::string>;
+
+    const Config a = parse(R"({"name": "svc", "port": 80, "tags": ["a", "b", "c"], "db": {"host": "h1", "pool": 4},)"
+                           R"( "a/b": 1, "t~": 2, "old": true})");
+    const Config b = parse(R"({"name": "svc", "port": 81, "tags": ["x", "a", "b", "c"],)"
+                           R"( "db": {"pool": 4, "host": "h2"}, "a/b": 1, "t~": [2], "new": null})");
+    CHECK(nfrr::config::diff(a, a).empty() && nfrr::config::diff(a, Config{a}).empty());
+    const Lines forward{"replace /port 81", "add /tags/0 \"x\"", "replace /db/host \"h2\"",
+                        "replace /t~0 [2]", "remove /old", "add /new null"};
+    CHECK(render(nfrr::config::diff(a, b)) == forward);
+    const Lines backward{"replace /port 80", "remove /tags/0", "replace /db/host \"h1\"",
+                         "replace /t~0 2", "remove /new", "add /old true"};
+    CHECK(render(nfrr::config::diff(b, a)) == backward);
+    CHECK(render(nfrr::config::diff(parse(R"({"a/b": 1})"), parse(R"({"a/b": 2})"))) == Lines{"replace /a~1b 2"});
+
+    // Arrays: equal head and tail are skipped, the middle is paired, the surplus removed from the back.
+    const Lines shrunk{"replace /1 9", "remove /3", "remove /2"};
+    CHECK(render(nfrr::config::diff(parse("[1, 2, 3, 4, 5]"), parse("[1, 9, 5]"))) == shrunk);
+    const Lines grown{"add /2 3", "add /3 4"};
+    CHECK(render(nfrr::config::diff(parse("[1, 2]"), parse("[1, 2, 3, 4]"))) == grown);
+    CHECK(render(nfrr::config::diff(parse(R"([{"k": 1}, {"k": 2}])"), parse(R"([{"k": 1}, {"k": 3}])"))) ==
+          Lines{"replace /1/k 3"});
+
+    // Scalars compare by value and kind; the root itself can be replaced.
+    CHECK(render(nfrr::config::diff(parse("1"), parse("1.0"))) == Lines{"replace  1.0"});
+    CHECK(render(nfrr::config::diff(parse("0.0"), parse("-0.0"))) == Lines{"replace  -0.0"});
+    CHECK(nfrr::config::diff(parse(R"("s")"), parse(R"("s")")).empty());
+
+    // Sorted objects and wide objects with reordered members: matched by key.
+    std::string wide_a = "{";
+    std::string wide_b = "{";
+    for (int i = 0; i < 200; ++i) {
+        wide_a += (i > 0 ? ", " : "") + std::string{"\"k"} + std::to_string(i) + "\": " + std::to_string(i);
+        const int j = 199 - i;
+        wide_b += (i > 0 ? ", " : "") + std::string{"\"k"} + std::to_string(j) + "\": ";
+        wide_b += std::to_string(j == 7 ? -7 : j);
+    }
+    wide_a += "}";
+    wide_b += "}";
+    CHECK(render(nfrr::config::diff(parse(wide_a), parse(wide_b))) == Lines{"replace /k7 -7"});
+    auto sa = nfrr::config::parse_json<nfrr::config::StdByteAllocator, nfrr::config::SortedObjectPolicy<>>(
+        R"({"b": 1, "a": {"x": [1]}})");
+    auto sb = nfrr::config::parse_json<nfrr::config::StdByteAllocator, nfrr::config::SortedObjectPolicy<>>(
+        R"({"a": {"x": [1, 2]}, "c": 3})");
+    const Lines sorted{"add /a/x/1 2", "remove /b", "add /c 3"};
+    CHECK(render(nfrr::config::diff(*sa, *sb)) == sorted);
+
+    // Shared trees: untouched subtrees of two versions are skipped by identity.
+    using nfrr::config::ConfigValueStdShared;
+    auto v1 = nfrr::config::parse_json<nfrr::config::StdByteAllocator, nfrr::config::SharedNodePolicy<>>(
+        R"({"big": {"list": [1, 2, 3]}, "small": {"n": 1}})");
+    ConfigValueStdShared v2 = std::as_const(*v1);
+    v2["small"]["n"].set_integer(2);
+    const auto shared_patch = nfrr::config::diff(*v1, v2);
+    CHECK(render(shared_patch) == Lines{"replace /small/n 2"});
+    CHECK(std::as_const(v2).at("big").shared_identity() == std::as_const(*v1).at("big").shared_identity());
+}
+
+void test_apply_patch() {
+    using nfrr::config::apply_patch;
+    using nfrr::config::ConfigPatch;
+    using nfrr::config::PatchError;
+    using nfrr::config::PatchOp;
+    using nfrr::config::to_json;
+    const auto parse = [](std::string_view text) { return *nfrr::config::parse_json(text); };
+    const auto patch = [&](std::string_view text) { return *nfrr::config::parse_patch(parse(text)); };
+    using Applied = std::expected<void, PatchError>;
+    const auto failed = [](const Applied& res, ConfigError code, std::size_t op) {
+        return !res && res.error() == PatchError{code, op};
+    };
+
+    // The RFC 6902 appendix examples, one per operation.
+    Config doc = parse(R"({"foo": "bar", "baz": "qux", "list": ["a", "c"]})");
+    CHECK(apply_patch(doc, patch(R"([{"op": "add", "path": "/hello", "value": ["world"]},)"
+                                 R"( {"op": "add", "path": "/list/1", "value": "b"},)"
+                                 R"( {"op": "add", "path": "/list/-", "value": "d"},)"
+                                 R"( {"op": "remove", "path": "/baz"},)"
+                                 R"( {"op": "replace", "path": "/foo", "value": 1},)"
+                                 R"( {"op": "copy", "from": "/list/0", "path": "/first"},)"
+                                 R"( {"op": "move", "from": "/list/3", "path": "/list/0"},)"
+                                 R"( {"op": "test", "path": "/foo", "value": 1.0}])"))
+              .has_value());
+    CHECK(to_json(doc) == R"({"foo":1,"list":["d","a","b","c"],"hello":["world"],"first":"a"})");
+    Config root = parse(R"({"a": 1})");
+    CHECK(apply_patch(root, patch(R"([{"op": "replace", "path": "", "value": [1]}, {"op": "add", "path": "/-",)"
+                                  R"( "value": {"x~y/z": 2}}, {"op": "test", "path": "/1/x~0y~1z", "value": 2}])"))
+              .has_value());
+    CHECK(to_json(root) == R"([1,{"x~y/z":2}])");
+
+    // Errors name the failing operation and leave the document exactly as it was.
+    const std::string before = to_json(doc);
+    const auto rejected = [&](std::string_view ops, ConfigError code, std::size_t op) {
+        return failed(apply_patch(doc, patch(ops)), code, op) && to_json(doc) == before;
+    };
+    CHECK(rejected(R"([{"op": "remove", "path": "/foo"}, {"op": "add", "path": "/z", "value": 0},)"
+                   R"( {"op": "move", "from": "/list/0", "path": "/moved"}, {"op": "remove", "path": "/list/1"},)"
+                   R"( {"op": "replace", "path": "/first", "value": {"n": 1}},)"
+                   R"( {"op": "copy", "from": "/hello", "path": "/list/0"},)"
+                   R"( {"op": "test", "path": "/hello/0", "value": "mars"}])",
+                   ConfigError::TestFailed, 6));
+    CHECK(rejected(R"([{"op": "move", "from": "/hello", "path": "/hello/0"}])", ConfigError::InvalidPath, 0));
+    CHECK(rejected(R"([{"op": "add", "path": "/a", "value": 1}, {"op": "add", "path": "/missing/x", "value": 1}])",
+                   ConfigError::KeyNotFound, 1));
+    CHECK(rejected(R"([{"op": "add", "path": "/list/9", "value": 1}])", ConfigError::IndexNotFound, 0));
+    CHECK(rejected(R"([{"op": "move", "from": "/list/0", "path": "/list/7"}])", ConfigError::IndexNotFound, 0));
+    CHECK(rejected(R"([{"op": "remove", "path": "/list/-"}])", ConfigError::InvalidPath, 0));
+    CHECK(rejected(R"([{"op": "add", "path": "/foo/x", "value": 1}])", ConfigError::TypeMismatch, 0));
+    CHECK(rejected(R"([{"op": "replace", "path": "foo", "value": 1}])", ConfigError::InvalidPath, 0));
+    CHECK(rejected(R"([{"op": "remove", "path": ""}])", ConfigError::InvalidPath, 0));
+    CHECK(rejected(R"([{"op": "test", "path": "/list", "value": ["d", "a", "b"]}])", ConfigError::TestFailed, 0));
+    CHECK(apply_patch(doc, patch(R"([{"op": "test", "path": "", "value": {"first": "a", "hello": ["world"],)"
+                                 R"( "list": ["d", "a", "b", "c"], "foo": 1}}])"))
+              .has_value());
+
+    // Malformed patch documents.
+    const PatchError first_op{ConfigError::SyntaxError, 0};
+    const PatchError second_op{ConfigError::SyntaxError, 1};
+    CHECK(nfrr::config::parse_patch(parse(R"({"op": "add"})")).error() == first_op);
+    CHECK(nfrr::config::parse_patch(parse(R"([{"op": "remove", "path": "/a"}, {"op": "jump", "path": "/a"}])"))
+              .error() == second_op);
+    CHECK(!nfrr::config::parse_patch(parse(R"([{"op": "copy", "path": "/a"}])")));
+    CHECK(!nfrr::config::parse_patch(parse(R"([{"op": "add", "path": "/a"}])")));
+
+    // Subtrees move instead of being copied, and rvalue patches hand over their operands.
+    const std::string long_text(100, 'x');
+    Config tree = parse(R"({"src": {"deep": [1, 2, 3]}})");
+    tree["src"]["text"].set_string(long_text);
+    const char* chars = tree.at("src").at("text").as_string().data();
+    ConfigPatch moves;
+    moves.push_back({PatchOp::Move, "/dst", "/src", Config{}});
+    CHECK(apply_patch(tree, moves).has_value() && tree.at("dst").at("text").as_string().data() == chars);
+    Config operand;
+    operand.set_string(long_text);
+    const char* operand_chars = operand.as_string().data();
+    ConfigPatch adds;
+    adds.push_back({PatchOp::Add, "/dst/deep/0", "", std::move(operand)});
+    CHECK(apply_patch(tree, std::move(adds)).has_value());
+    CHECK(tree.at("dst").at("deep").as_array()[0].as_string().data() == operand_chars);
+    // Rolling back a move puts the very same subtree back.
+    moves = {{PatchOp::Move, "/src", "/dst", Config{}}, {PatchOp::Test, "/src/deep/1", "", Config{}}};
+    CHECK(failed(apply_patch(tree, moves), ConfigError::TestFailed, 1));
+    CHECK(tree.at("dst").at("text").as_string().data() == chars && !tree.contains("src"));
+
+    // diff() output applies: a + diff(a, b) == b, for insertion-ordered and sorted objects.
+    const Config a = parse(R"({"name": "svc", "port": 80, "tags": ["a", "b", "c"], "db": {"host": "h1"}, "old": 1})");
+    const Config b = parse(R"({"port": 81, "tags": ["x", "a", "c"], "db": {"host": "h2", "pool": 4}, "new": [1]})");
+    Config patched = a;
+    CHECK(apply_patch(patched, nfrr::config::diff(a, b)).has_value());
+    CHECK(nfrr::config::diff(patched, b).empty());
+    using Sorted = nfrr::config::SortedObjectPolicy<true>;
+    auto sorted = nfrr::config::parse_json<nfrr::config::StdByteAllocator, Sorted>(R"({"b": 1, "a": {"c": 2}})");
+    const std::string sorted_before = to_json(*sorted);
+    auto sorted_patch = nfrr::config::parse_patch(*nfrr::config::parse_json<nfrr::config::StdByteAllocator, Sorted>(
+        R"([{"op": "remove", "path": "/b"}, {"op": "add", "path": "/a/d", "value": 3},)"
+        R"( {"op": "test", "path": "/b", "value": 1}])"));
+    CHECK(sorted_patch.has_value() && failed(apply_patch(*sorted, *sorted_patch), ConfigError::KeyNotFound, 2));
+    CHECK(to_json(*sorted) == sorted_before);
+
+    // Pmr trees keep their arena; shared trees are unshared only along the patched paths.
+    std::pmr::monotonic_buffer_resource arena;
+    auto pmr = nfrr::config::parse_json(R"({"a": {"b": [1]}, "c": "text that is long enough to allocate"})",
+                                        nfrr::config::PmrByteAllocator{&arena});
+    auto pmr_patch = nfrr::config::parse_patch(
+        *nfrr::config::parse_json(R"([{"op": "add", "path": "/a/b/-", "value": "another long enough string"},)"
+                                  R"( {"op": "move", "from": "/c", "path": "/a/c"}])",
+                                  nfrr::config::PmrByteAllocator{&arena}));
+    CHECK(pmr_patch.has_value() && apply_patch(*pmr, std::move(*pmr_patch)).has_value());
+    CHECK(pmr->at("a").at("b").as_array()[1].get_allocator().resource() == &arena && !pmr->contains("c"));
+    using Shared = nfrr::config::ConfigValueStdShared;
+    auto shared = nfrr::config::parse_json<nfrr::config::StdByteAllocator, nfrr::config::SharedNodePolicy<>>(
+        R"({"big": {"list": [1, 2, 3]}, "small": {"n": 1}})");
+    Shared version = std::as_const(*shared);
+    auto shared_patch = nfrr::config::parse_patch(
+        *nfrr::config::parse_json<nfrr::config::StdByteAllocator, nfrr::config::SharedNodePolicy<>>(
+            R"([{"op": "replace", "path": "/small/n", "value": 2}])"));
+    CHECK(apply_patch(version, *shared_patch).has_value());
+    CHECK(std::as_const(*shared).at("small").at("n").get<int>() == 1);
+    CHECK(std::as_const(version).at("small").at("n").get<int>() == 2);
+    CHECK(std::as_const(version).at("big").shared_identity() == std::as_const(*shared).at("big").shared_identity());
+
+    // Copying an ancestor into its own subtree yields a snapshot of it, not a cycle, and a failed
+    // patch rolls such a copy back without leaking it.
+    const auto shared_ops = [](std::string_view text) {
+        return *nfrr::config::parse_patch(
+            *nfrr::config::parse_json<nfrr::config::StdByteAllocator, nfrr::config::SharedNodePolicy<>>(text));
+    };
+    auto nested = nfrr::config::parse_json<nfrr::config::StdByteAllocator, nfrr::config::SharedNodePolicy<>>(
+        R"({"x": 1, "y": {}})");
+    CHECK(apply_patch(*nested, shared_ops(R"([{"op": "copy", "from": "", "path": "/y/z"}])")).has_value());
+    CHECK(to_json(*nested) == R"({"x":1,"y":{"z":{"x":1,"y":{}}}})");
+    CHECK(failed(apply_patch(*nested, shared_ops(R"([{"op": "copy", "from": "/y", "path": "/y/z/w"},)"
+                                                 R"( {"op": "test", "path": "/x", "value": 2}])")),
+                 ConfigError::TestFailed, 1));
+    CHECK(to_json(*nested) == R"({"x":1,"y":{"z":{"x":1,"y":{}}}})");
+}
 } // namespace